@@ -0,0 +1,331 @@
+//
+// chibi-hash-bench
+//
+// Compares util::FlatHashMap against std::unordered_map for the key types the engine looks things up by: pointers
+// (resource handles), u64 (ids and hashes) and short strings (asset names that fit the small string buffer). Each
+// container is timed on insert, successful and failed find, and erase + reinsert churn, at table sizes that sit in
+// L1, L2, L3 and DRAM. Each result is the best of several samples, reported as ns per operation.
+//
+// Usage:
+//   chibi-hash-bench [--json <file>] [--filter <substring>] [--samples <count>]
+//
+// Like chibi-math-bench, the JSON output is meant to be diffed between runs on the same machine and build flags.
+//
+
+#include <Util/FlatHashMap.h>
+#include <Platform/Timer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // Keeps the optimiser from discarding results that are otherwise never read.
+    volatile u64 gSink = 0;
+
+    struct TableSize
+    {
+        const char* mLabel;
+        u64         mEntries;
+    };
+
+    constexpr TableSize cTableSizes[] = {
+        { "L1",   256       },
+        { "L2",   8192      },
+        { "L3",   131072    },
+        { "DRAM", 2097152   },
+    };
+
+    // Time budget for one sample.
+    constexpr f64 cMinSampleSeconds = 0.01;
+
+    const char* getGroupProbingName()
+    {
+#if CT_FLAT_HASH_SSE2
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+
+    using RunFunc = std::function<void()>;
+
+    struct Benchmark
+    {
+        std::string mName;
+        std::function<RunFunc(u64 tEntries)> mSetup; // Builds the keys for tEntries entries, returns one pass of tEntries ops
+    };
+
+    struct BenchResult
+    {
+        std::string mName;
+        const char* mLevel;
+        u64         mEntries;
+        f64         mNsPerOp;
+    };
+
+    //
+    // Keys. A fixed seed keeps every run working on the same data. Half the keys go in the table, the other half are
+    // only used for failed lookups.
+    //
+
+    std::mt19937_64 gRng(0xC41B1);
+
+    template<class Key>
+    struct KeySet
+    {
+        std::vector<Key>      mHits;
+        std::vector<Key>      mMisses;
+        std::shared_ptr<void> mOwner; // Keeps whatever the keys point at alive
+    };
+
+    template<class Key>
+    KeySet<Key> splitKeys(std::vector<Key> tKeys, std::shared_ptr<void> tOwner = {})
+    {
+        std::shuffle(tKeys.begin(), tKeys.end(), gRng);
+
+        KeySet<Key> keys;
+        keys.mMisses.assign(tKeys.begin() + tKeys.size() / 2, tKeys.end());
+        tKeys.resize(tKeys.size() / 2);
+        keys.mHits  = std::move(tKeys);
+        keys.mOwner = std::move(tOwner);
+        return keys;
+    }
+
+    // Stand-in for a resource object: the keys are the addresses of live, heap allocated objects.
+    struct Resource
+    {
+        u64 mPayload[4];
+    };
+
+    KeySet<const Resource*> makePointerKeys(u64 tEntries)
+    {
+        auto resources = std::make_shared<std::vector<Resource>>(2 * tEntries);
+
+        std::vector<const Resource*> keys;
+        keys.reserve(resources->size());
+        for (const Resource& resource : *resources) {
+            keys.push_back(&resource);
+        }
+        return splitKeys(std::move(keys), resources);
+    }
+
+    KeySet<u64> makeU64Keys(u64 tEntries)
+    {
+        // Sequential ids interleaved with random 64 bit values, both are common.
+        std::vector<u64> keys;
+        keys.reserve(2 * tEntries);
+        for (u64 i = 0; i < tEntries; ++i) {
+            keys.push_back(i);
+            keys.push_back(gRng() | (u64(1) << 63));
+        }
+        return splitKeys(std::move(keys));
+    }
+
+    KeySet<std::string> makeStringKeys(u64 tEntries)
+    {
+        std::vector<std::string> keys;
+        keys.reserve(2 * tEntries);
+        for (u64 i = 0; i < 2 * tEntries; ++i) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "mesh_%llx", (unsigned long long)(i * 0x9E3779B1ull & 0xFFFFFFFFull));
+            keys.emplace_back(name);
+        }
+        return splitKeys(std::move(keys));
+    }
+
+    template<class Map, class Key>
+    Map buildMap(const std::vector<Key>& tKeys)
+    {
+        Map map;
+        for (size_t i = 0; i < tKeys.size(); ++i) {
+            map.try_emplace(tKeys[i], u64(i));
+        }
+        return map;
+    }
+
+    // Lookups in a different order than the inserts, so node based maps don't walk their allocations in order.
+    template<class Key>
+    std::vector<Key> shuffled(std::vector<Key> tKeys)
+    {
+        std::shuffle(tKeys.begin(), tKeys.end(), gRng);
+        return tKeys;
+    }
+
+    //
+    // The suite
+    //
+
+    template<class Map, class Key>
+    void addMapBenchmarks(std::vector<Benchmark>& tBenchmarks, const std::string& tPrefix, KeySet<Key> (*tMakeKeys)(u64))
+    {
+        tBenchmarks.push_back({ tPrefix + " insert", [tMakeKeys](u64 tEntries) -> RunFunc {
+            return [keys = tMakeKeys(tEntries)]() {
+                const Map map = buildMap<Map>(keys.mHits);
+                gSink = gSink + map.size();
+            };
+        }});
+
+        tBenchmarks.push_back({ tPrefix + " find hit", [tMakeKeys](u64 tEntries) -> RunFunc {
+            KeySet<Key> keys = tMakeKeys(tEntries);
+            Map map = buildMap<Map>(keys.mHits);
+            return [map = std::move(map), lookups = shuffled(keys.mHits), owner = keys.mOwner]() {
+                u64 sum = 0;
+                for (const Key& key : lookups) {
+                    sum += map.find(key)->second;
+                }
+                gSink = gSink + sum;
+            };
+        }});
+
+        tBenchmarks.push_back({ tPrefix + " find miss", [tMakeKeys](u64 tEntries) -> RunFunc {
+            KeySet<Key> keys = tMakeKeys(tEntries);
+            Map map = buildMap<Map>(keys.mHits);
+            return [map = std::move(map), lookups = std::move(keys.mMisses), owner = keys.mOwner]() {
+                u64 found = 0;
+                for (const Key& key : lookups) {
+                    found += map.find(key) != map.end();
+                }
+                gSink = gSink + found;
+            };
+        }});
+
+        tBenchmarks.push_back({ tPrefix + " erase+insert", [tMakeKeys](u64 tEntries) -> RunFunc {
+            KeySet<Key> keys = tMakeKeys(tEntries);
+            Map map = buildMap<Map>(keys.mHits);
+            return [map = std::move(map), churn = shuffled(keys.mHits), owner = keys.mOwner]() mutable {
+                for (const Key& key : churn) {
+                    map.erase(key);
+                    map.try_emplace(key, u64(1));
+                }
+                gSink = gSink + map.size();
+            };
+        }});
+    }
+
+    template<class Key>
+    void addKeyBenchmarks(std::vector<Benchmark>& tBenchmarks, const char* tKeyName, KeySet<Key> (*tMakeKeys)(u64))
+    {
+        addMapBenchmarks<util::FlatHashMap<Key, u64>>(tBenchmarks, std::string(tKeyName) + " FlatHashMap", tMakeKeys);
+        addMapBenchmarks<std::unordered_map<Key, u64>>(tBenchmarks, std::string(tKeyName) + " unordered_map", tMakeKeys);
+    }
+
+    std::vector<Benchmark> makeBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+        addKeyBenchmarks(benchmarks, "pointer", makePointerKeys);
+        addKeyBenchmarks(benchmarks, "u64", makeU64Keys);
+        addKeyBenchmarks(benchmarks, "string", makeStringKeys);
+        return benchmarks;
+    }
+
+    f64 timeRuns(const RunFunc& tRun, u64 tRepetitions)
+    {
+        ct::os::Timer timer;
+        timer.start();
+        for (u64 i = 0; i < tRepetitions; ++i) {
+            tRun();
+        }
+        timer.update();
+        return timer.getSecondsElapsed();
+    }
+
+    BenchResult measure(const Benchmark& tBenchmark, const TableSize& tTableSize, u32 tSampleCount)
+    {
+        const RunFunc run = tBenchmark.mSetup(tTableSize.mEntries);
+
+        // Warm up caches, then pick a repetition count that fills one sample.
+        run();
+        u64 repetitions = 1;
+        while (timeRuns(run, repetitions) < cMinSampleSeconds) {
+            repetitions *= 2;
+        }
+
+        // The minimum is the least noisy estimate, anything slower was interrupted by something else.
+        f64 bestSeconds = std::numeric_limits<f64>::max();
+        for (u32 sample = 0; sample < tSampleCount; ++sample) {
+            bestSeconds = std::min(bestSeconds, timeRuns(run, repetitions));
+        }
+
+        BenchResult result;
+        result.mName    = tBenchmark.mName;
+        result.mLevel   = tTableSize.mLabel;
+        result.mEntries = tTableSize.mEntries;
+        result.mNsPerOp = bestSeconds * 1e9 / (f64(tTableSize.mEntries) * f64(repetitions));
+        return result;
+    }
+
+    bool writeJson(const char* tPath, const std::vector<BenchResult>& tResults, u32 tSampleCount)
+    {
+        FILE* file = std::fopen(tPath, "w");
+        if (!file) {
+            std::fprintf(stderr, "Failed to open '%s' for writing.\n", tPath);
+            return false;
+        }
+
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"backend\": \"%s\",\n", getGroupProbingName());
+        std::fprintf(file, "  \"samples\": %u,\n", tSampleCount);
+        std::fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i < tResults.size(); ++i) {
+            const BenchResult& result = tResults[i];
+            std::fprintf(file, "    { \"name\": \"%s\", \"level\": \"%s\", \"entries\": %llu, \"ns_per_op\": %.4f }%s\n",
+                         result.mName.c_str(), result.mLevel, (unsigned long long)result.mEntries, result.mNsPerOp,
+                         (i + 1 < tResults.size()) ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+
+        std::fclose(file);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* jsonPath    = nullptr;
+    const char* filter      = nullptr;
+    u32         sampleCount = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sampleCount = (u32)std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json <file>] [--filter <substring>] [--samples <count>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("chibi-hash-bench, group probing: %s\n\n", getGroupProbingName());
+    std::printf("%-36s %-5s %10s %10s\n", "benchmark", "level", "entries", "ns/op");
+
+    std::vector<BenchResult> results;
+    for (const Benchmark& benchmark : makeBenchmarks()) {
+        if (filter && !std::strstr(benchmark.mName.c_str(), filter)) {
+            continue;
+        }
+
+        for (const TableSize& tableSize : cTableSizes) {
+            const BenchResult result = measure(benchmark, tableSize, sampleCount);
+            std::printf("%-36s %-5s %10llu %10.2f\n", result.mName.c_str(), result.mLevel,
+                        (unsigned long long)result.mEntries, result.mNsPerOp);
+            results.push_back(result);
+        }
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, sampleCount)) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,833 @@
+//
+// chibi-math-bench
+//
+// Times the Math.h helpers, the batched kernels in MathBatch.h and the frustum culling kernels over working sets
+// sized to sit in L1, L2, L3 and DRAM. Each result is the best of several samples, reported as ns per element and
+// GB/s of element data touched (bytes read + bytes written).
+//
+// Usage:
+//   chibi-math-bench [--json <file>] [--filter <substring>] [--samples <count>]
+//   chibi-math-bench --hash [--expect <hex>]
+//   chibi-math-bench --check
+//
+// The JSON output is meant to be committed alongside a change or diffed between runs, e.g. before and after a
+// math optimisation, on the same machine and with the same build flags.
+//
+// --hash skips the timings and instead runs a fixed workload through the math library and the parallel reductions,
+// then prints a hash of every output bit. The parallel sums run with several thread counts and have to agree. In a
+// CT_MATH_DETERMINISTIC build the hash is the same for every compiler, platform and backend, so a build farm can
+// compare it against a known value (--expect), and fails with exit code 1 when it differs.
+//
+// --check compares the SIMD paths that are not bit-identical to the scalar backend against their documented tolerance
+// (see invertMat4), checks that huge angles reduce cleanly in sin/cos, checks the batch octahedral normal kernels
+// against the single value functions and their round trip error, and fails with exit code 1 when one is off.
+//
+
+#include <Math/Math.h>
+#include <Math/FastMath.h>
+#include <Math/MathBatch.h>
+#include <Math/Packing.h>
+#include <Systems/FrustumCulling.h>
+#include <Systems/ParallelFor.h>
+#include <Systems/WorkQueue.h>
+#include <Platform/Timer.h>
+#include <Util/Hash.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // Keeps the optimiser from discarding results that are otherwise never read.
+    volatile f32 gSink = 0.0f;
+
+    struct WorkingSet
+    {
+        const char* mLabel;
+        u64         mBytes;
+    };
+
+    // Rough, but representative of current desktop parts: 32-48KB L1D, 512KB-2MB L2, 16MB+ L3.
+    constexpr WorkingSet cWorkingSets[] = {
+        { "L1",   _KB(16ull)  },
+        { "L2",   _KB(256ull) },
+        { "L3",   _MB(4ull)   },
+        { "DRAM", _MB(64ull)  },
+    };
+
+    // Time budget for one sample. Short enough to run the whole suite in well under a minute.
+    constexpr f64 cMinSampleSeconds = 0.01;
+
+    using RunFunc = std::function<void()>;
+
+    struct Benchmark
+    {
+        const char* mName;
+        u64         mBytesPerOp;                 // Element data read + written per op
+        std::function<RunFunc(u64 tCount)> mSetup; // Allocates data for tCount ops, returns a pass over all of them
+    };
+
+    struct BenchResult
+    {
+        std::string mName;
+        const char* mLevel;
+        u64         mWorkingSetBytes;
+        u64         mOpCount;
+        f64         mNsPerOp;
+        f64         mGBPerSecond;
+    };
+
+    const char* getBackendName()
+    {
+#if CT_MATH_SIMD_AVX
+        return "avx";
+#elif CT_MATH_SIMD_SSE
+        return "sse";
+#elif CT_MATH_SIMD_NEON
+        return "neon";
+#else
+        return "scalar";
+#endif
+    }
+
+    //
+    // Random inputs. A fixed seed keeps every run working on the same data.
+    //
+
+    std::mt19937 gRng(0xC41B1);
+
+    f32 randomF32(f32 tMin = -10.0f, f32 tMax = 10.0f)
+    {
+        return std::uniform_real_distribution<f32>(tMin, tMax)(gRng);
+    }
+
+    float3 randomFloat3() { return { randomF32(), randomF32(), randomF32() }; }
+    float4 randomFloat4() { return { randomF32(), randomF32(), randomF32(), randomF32() }; }
+
+    mat4 randomTransform()
+    {
+        return mat4MulRH(translateMatrix(randomFloat3()), RotateMatrix(randomF32(0.0f, 360.0f), randomFloat3()));
+    }
+
+    template<typename T, typename Generator>
+    std::vector<T> makeArray(u64 tCount, Generator&& tGenerate)
+    {
+        std::vector<T> result;
+        result.reserve(tCount);
+        for (u64 i = 0; i < tCount; ++i) {
+            result.push_back(tGenerate());
+        }
+        return result;
+    }
+
+    std::vector<f32> makeStream(u64 tCount, f32 tMin = -10.0f, f32 tMax = 10.0f)
+    {
+        return makeArray<f32>(tCount, [&] { return randomF32(tMin, tMax); });
+    }
+
+    //
+    // The suite
+    //
+
+    std::vector<Benchmark> makeBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+
+        // Vector operators
+
+        benchmarks.push_back({ "float4 operator+", 3 * sizeof(float4), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float4>(tCount, randomFloat4), b = makeArray<float4>(tCount, randomFloat4), c = std::vector<float4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = a[i] + b[i];
+                gSink = c.back().X;
+            };
+        }});
+
+        benchmarks.push_back({ "float4 operator*(f32)", 2 * sizeof(float4), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float4>(tCount, randomFloat4), c = std::vector<float4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = a[i] * 0.5f;
+                gSink = c.back().X;
+            };
+        }});
+
+        benchmarks.push_back({ "dot(float4)", 2 * sizeof(float4) + sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float4>(tCount, randomFloat4), b = makeArray<float4>(tCount, randomFloat4), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = dot(a[i], b[i]);
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "cross(float3)", 3 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float3>(tCount, randomFloat3), b = makeArray<float3>(tCount, randomFloat3), c = std::vector<float3>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = cross(a[i], b[i]);
+                gSink = c.back().X;
+            };
+        }});
+
+        benchmarks.push_back({ "float3::norm", 2 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float3>(tCount, randomFloat3), c = std::vector<float3>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = a[i].getNorm();
+                gSink = c.back().X;
+            };
+        }});
+
+        // Matrices
+
+        benchmarks.push_back({ "mat4MulRH", 3 * sizeof(mat4), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<mat4>(tCount, randomTransform), b = makeArray<mat4>(tCount, randomTransform), c = std::vector<mat4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = mat4MulRH(a[i], b[i]);
+                gSink = c.back().Ptr[3][0];
+            };
+        }});
+
+        benchmarks.push_back({ "invertMat4", 2 * sizeof(mat4), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<mat4>(tCount, randomTransform), c = std::vector<mat4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = invertMat4(a[i]);
+                gSink = c.back().Ptr[3][0];
+            };
+        }});
+
+        benchmarks.push_back({ "invertMat4Scalar", 2 * sizeof(mat4), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<mat4>(tCount, randomTransform), c = std::vector<mat4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = invertMat4Scalar(a[i]);
+                gSink = c.back().Ptr[3][0];
+            };
+        }});
+
+        benchmarks.push_back({ "transposeMatrix", 2 * sizeof(mat4), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<mat4>(tCount, randomTransform), c = std::vector<mat4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = transposeMatrix(a[i]);
+                gSink = c.back().Ptr[3][0];
+            };
+        }});
+
+        benchmarks.push_back({ "QuaternionToRotationMatrix", sizeof(quaternion) + sizeof(mat4), [](u64 tCount) -> RunFunc {
+            auto makeQuaternion = [] { return EulerToQuaternion(randomF32(0, 360), randomF32(0, 360), randomF32(0, 360)); };
+            return [a = makeArray<quaternion>(tCount, makeQuaternion), c = std::vector<mat4>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = QuaternionToRotationMatrix(a[i]);
+                gSink = c.back().Ptr[0][0];
+            };
+        }});
+
+        benchmarks.push_back({ "lookAtMatrixRh", 2 * sizeof(float3) + sizeof(mat4), [](u64 tCount) -> RunFunc {
+            return [eye = makeArray<float3>(tCount, randomFloat3), at = makeArray<float3>(tCount, randomFloat3), c = std::vector<mat4>(tCount)]() mutable {
+                for (u64 i = 0; i < eye.size(); ++i) c[i] = lookAtMatrixRh(eye[i], at[i], { 0.0f, 1.0f, 0.0f });
+                gSink = c.back().Ptr[3][0];
+            };
+        }});
+
+        // Batched kernels, with the per-element loop they replace as a baseline
+
+        benchmarks.push_back({ "mat4TranslatePoint (per element)", 2 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [m = randomTransform(), a = makeArray<float3>(tCount, randomFloat3), c = std::vector<float3>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = mat4TranslatePoint(m, { a[i].X, a[i].Y, a[i].Z, 1.0f }).XYZ;
+                gSink = c.back().X;
+            };
+        }});
+
+        benchmarks.push_back({ "transformPoints (AoS)", 2 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [m = randomTransform(), a = makeArray<float3>(tCount, randomFloat3), c = std::vector<float3>(tCount)]() mutable {
+                transformPoints(m, a, c);
+                gSink = c.back().X;
+            };
+        }});
+
+        benchmarks.push_back({ "transformPoints (SoA)", 2 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [m = randomTransform(), x = makeStream(tCount), y = makeStream(tCount), z = makeStream(tCount),
+                    ox = std::vector<f32>(tCount), oy = std::vector<f32>(tCount), oz = std::vector<f32>(tCount)]() mutable {
+                transformPoints(m, constFloat3SoA(x.data(), y.data(), z.data(), x.size()), float3SoA{ ox.data(), oy.data(), oz.data(), ox.size() });
+                gSink = ox.back();
+            };
+        }});
+
+        benchmarks.push_back({ "normalizeArray (AoS)", 2 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float3>(tCount, randomFloat3)]() mutable {
+                normalizeArray(a);
+                gSink = a.back().X;
+            };
+        }});
+
+        benchmarks.push_back({ "normalizeArray (SoA)", 2 * sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [x = makeStream(tCount), y = makeStream(tCount), z = makeStream(tCount)]() mutable {
+                normalizeArray(float3SoA{ x.data(), y.data(), z.data(), x.size() });
+                gSink = x.back();
+            };
+        }});
+
+        benchmarks.push_back({ "dotArray (AoS)", 2 * sizeof(float3) + sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float3>(tCount, randomFloat3), b = makeArray<float3>(tCount, randomFloat3), c = std::vector<f32>(tCount)]() mutable {
+                dotArray(a, b, c);
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "boundsOfPoints (AoS)", sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [a = makeArray<float3>(tCount, randomFloat3)]() mutable {
+                gSink = boundsOfPoints(std::span<const float3>(a)).Max.X;
+            };
+        }});
+
+        benchmarks.push_back({ "boundsOfPoints (SoA)", sizeof(float3), [](u64 tCount) -> RunFunc {
+            return [x = makeStream(tCount), y = makeStream(tCount), z = makeStream(tCount)]() mutable {
+                gSink = boundsOfPoints(constFloat3SoA(x.data(), y.data(), z.data(), x.size())).Max.X;
+            };
+        }});
+
+        // Transcendentals, libm against the ct::fast tier
+
+        benchmarks.push_back({ "sinf", 2 * sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeStream(tCount, -100.0f, 100.0f), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = sinf(a[i]);
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "fast::sin (f32xN)", 2 * sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeStream(tCount, -100.0f, 100.0f), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i + simd::cNativeWidth <= a.size(); i += simd::cNativeWidth) {
+                    simd::storeN(&c[i], ct::fast::sin(simd::loadN(&a[i])));
+                }
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "expf", 2 * sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeStream(tCount), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = expf(a[i]);
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "fast::exp (f32xN)", 2 * sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeStream(tCount), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i + simd::cNativeWidth <= a.size(); i += simd::cNativeWidth) {
+                    simd::storeN(&c[i], ct::fast::exp(simd::loadN(&a[i])));
+                }
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "1 / sqrtf", 2 * sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeStream(tCount, 0.01f, 100.0f), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i < a.size(); ++i) c[i] = 1.0f / sqrtf(a[i]);
+                gSink = c.back();
+            };
+        }});
+
+        benchmarks.push_back({ "fast::rsqrt (f32xN)", 2 * sizeof(f32), [](u64 tCount) -> RunFunc {
+            return [a = makeStream(tCount, 0.01f, 100.0f), c = std::vector<f32>(tCount)]() mutable {
+                for (u64 i = 0; i + simd::cNativeWidth <= a.size(); i += simd::cNativeWidth) {
+                    simd::storeN(&c[i], ct::fast::rsqrt(simd::loadN(&a[i])));
+                }
+                gSink = c.back();
+            };
+        }});
+
+        // Culling. Objects are scattered around a camera at the origin, roughly a third end up visible.
+
+        const auto makeFrustum = [] {
+            const mat4 projection = perspectiveMatrixRh(60.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+            const mat4 view       = lookAtMatrixRh({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f });
+            return ct::extractFrustumPlanes(mat4MulRH(projection, view));
+        };
+
+        benchmarks.push_back({ "cullSpheres", 4 * sizeof(f32) + sizeof(u32), [makeFrustum](u64 tCount) -> RunFunc {
+            return [frustum = makeFrustum(), x = makeStream(tCount, -60, 60), y = makeStream(tCount, -60, 60), z = makeStream(tCount, -120, 0),
+                    r = makeStream(tCount, 0.1f, 2.0f), visible = std::vector<u32>(tCount)]() mutable {
+                const ct::BoundingSpheresSoA spheres{ x.data(), y.data(), z.data(), r.data(), (u32)x.size() };
+                gSink = (f32)ct::cullSpheres(frustum, spheres, visible);
+            };
+        }});
+
+        benchmarks.push_back({ "cullBoxes", 6 * sizeof(f32) + sizeof(u32), [makeFrustum](u64 tCount) -> RunFunc {
+            std::vector<f32> minX = makeStream(tCount, -60, 60), minY = makeStream(tCount, -60, 60), minZ = makeStream(tCount, -120, 0);
+            std::vector<f32> maxX(tCount), maxY(tCount), maxZ(tCount);
+            for (u64 i = 0; i < tCount; ++i) {
+                maxX[i] = minX[i] + randomF32(0.1f, 2.0f);
+                maxY[i] = minY[i] + randomF32(0.1f, 2.0f);
+                maxZ[i] = minZ[i] + randomF32(0.1f, 2.0f);
+            }
+
+            return [frustum = makeFrustum(), minX = std::move(minX), minY = std::move(minY), minZ = std::move(minZ),
+                    maxX = std::move(maxX), maxY = std::move(maxY), maxZ = std::move(maxZ), visible = std::vector<u32>(tCount)]() mutable {
+                const ct::BoundingBoxesSoA boxes{ minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), (u32)minX.size() };
+                gSink = (f32)ct::cullBoxes(frustum, boxes, visible);
+            };
+        }});
+
+        return benchmarks;
+    }
+
+    f64 timeRuns(const RunFunc& tRun, u64 tRepetitions)
+    {
+        ct::os::Timer timer;
+        timer.start();
+        for (u64 i = 0; i < tRepetitions; ++i) {
+            tRun();
+        }
+        timer.update();
+        return timer.getSecondsElapsed();
+    }
+
+    BenchResult measure(const Benchmark& tBenchmark, const WorkingSet& tWorkingSet, u32 tSampleCount)
+    {
+        const u64 opCount = std::max<u64>(64, tWorkingSet.mBytes / tBenchmark.mBytesPerOp);
+        const RunFunc run = tBenchmark.mSetup(opCount);
+
+        // Warm up caches and page in the arrays, then pick a repetition count that fills one sample.
+        run();
+        u64 repetitions = 1;
+        while (timeRuns(run, repetitions) < cMinSampleSeconds) {
+            repetitions *= 2;
+        }
+
+        // The minimum is the least noisy estimate, anything slower was interrupted by something else.
+        f64 bestSeconds = std::numeric_limits<f64>::max();
+        for (u32 sample = 0; sample < tSampleCount; ++sample) {
+            bestSeconds = std::min(bestSeconds, timeRuns(run, repetitions));
+        }
+
+        const f64 totalOps = f64(opCount) * f64(repetitions);
+
+        BenchResult result;
+        result.mName            = tBenchmark.mName;
+        result.mLevel           = tWorkingSet.mLabel;
+        result.mWorkingSetBytes = tWorkingSet.mBytes;
+        result.mOpCount         = opCount;
+        result.mNsPerOp         = bestSeconds * 1e9 / totalOps;
+        result.mGBPerSecond     = f64(tBenchmark.mBytesPerOp) * totalOps / bestSeconds / 1e9;
+        return result;
+    }
+
+    bool writeJson(const char* tPath, const std::vector<BenchResult>& tResults, u32 tSampleCount)
+    {
+        FILE* file = std::fopen(tPath, "w");
+        if (!file) {
+            std::fprintf(stderr, "Failed to open '%s' for writing.\n", tPath);
+            return false;
+        }
+
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"backend\": \"%s\",\n", getBackendName());
+        std::fprintf(file, "  \"samples\": %u,\n", tSampleCount);
+        std::fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i < tResults.size(); ++i) {
+            const BenchResult& result = tResults[i];
+            std::fprintf(file,
+                "    { \"name\": \"%s\", \"level\": \"%s\", \"working_set_bytes\": %llu, \"ops\": %llu, \"ns_per_op\": %.4f, \"gb_per_s\": %.3f }%s\n",
+                result.mName.c_str(), result.mLevel, (unsigned long long)result.mWorkingSetBytes,
+                (unsigned long long)result.mOpCount, result.mNsPerOp, result.mGBPerSecond,
+                (i + 1 < tResults.size()) ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+
+        std::fclose(file);
+        return true;
+    }
+
+    //
+    // Determinism hash. The inputs can't come from <random>: the distributions are implementation defined, so each
+    // standard library would produce different data. A splitmix64 stream turned into floats with exact arithmetic
+    // is the same everywhere.
+    //
+
+    struct HashInputs
+    {
+        u64 mState{0x5EED};
+
+        u64 nextU64()
+        {
+            u64 z = (mState += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        f32 nextF32(f32 tMin, f32 tMax)
+        {
+            const f32 unit = f32(nextU64() >> 40) * (1.0f / 16777216.0f);
+            return tMin + unit * (tMax - tMin);
+        }
+
+        float3 nextFloat3(f32 tMin, f32 tMax) { return { nextF32(tMin, tMax), nextF32(tMin, tMax), nextF32(tMin, tMax) }; }
+    };
+
+    struct OutputHash
+    {
+        u64 mValue{0};
+
+        void add(u64 tBits) { hash_combine_size_t(mValue, tBits); }
+        void add(f32 tValue) { add((u64)std::bit_cast<u32>(tValue)); }
+        void add(float3 tValue) { add(tValue.X); add(tValue.Y); add(tValue.Z); }
+        void add(const mat4& tValue) { for (const auto& column : tValue.Ptr) for (const f32 value : column) add(value); }
+        void add(quaternion tValue) { add(tValue.X); add(tValue.Y); add(tValue.Z); add(tValue.Theta); }
+    };
+
+    int runHashCheck(const char* tExpected)
+    {
+        constexpr u64 cCount = 100003; // Deliberately not a multiple of any lane width or block size
+
+        HashInputs inputs;
+        OutputHash hash;
+
+        // Matrices and quaternions
+        for (u32 i = 0; i < 256; ++i) {
+            const mat4 view       = lookAtMatrixRh(inputs.nextFloat3(-50.0f, 50.0f), inputs.nextFloat3(-50.0f, 50.0f), { 0.0f, 1.0f, 0.0f });
+            const mat4 projection = perspectiveMatrixRh(inputs.nextF32(30.0f, 90.0f), inputs.nextF32(1.0f, 2.5f), 0.1f, 1000.0f);
+            const mat4 model      = mat4MulRH(translateMatrix(inputs.nextFloat3(-10.0f, 10.0f)),
+                                              RotateMatrix(inputs.nextF32(0.0f, 360.0f), inputs.nextFloat3(-1.0f, 1.0f)));
+
+            hash.add(mat4MulRH(projection, mat4MulRH(view, model)));
+            hash.add(invertMat4(model));
+
+            const quaternion from = EulerToQuaternion(inputs.nextF32(-180.0f, 180.0f), inputs.nextF32(-90.0f, 90.0f), inputs.nextF32(-180.0f, 180.0f));
+            const quaternion to   = mat4ToQuaternion(model);
+            const quaternion mid  = slerp(from, to, inputs.nextF32(0.0f, 1.0f));
+            hash.add(mid);
+            hash.add(rotateVector(mid, inputs.nextFloat3(-1.0f, 1.0f)));
+        }
+
+        // Batched kernels
+        std::vector<float3> points(cCount);
+        for (float3& point : points) point = inputs.nextFloat3(-100.0f, 100.0f);
+
+        std::vector<float3> transformed(cCount);
+        transformPoints(mat4MulRH(translateMatrix({ 1.0f, 2.0f, 3.0f }), RotateMatrix(33.0f, { 0.3f, 1.0f, -0.2f })), points, transformed);
+        normalizeArray(transformed);
+
+        std::vector<f32> dots(cCount);
+        dotArray(points, transformed, dots);
+        for (const float3& point : transformed) hash.add(point);
+        for (const f32 dot : dots) hash.add(dot);
+
+        // Scalar and fast transcendentals, half floats
+        for (u64 i = 0; i < cCount; ++i) {
+            const f32 angle    = inputs.nextF32(-100.0f, 100.0f);
+            const f32 positive = inputs.nextF32(0.001f, 80.0f);
+            hash.add(f32Sin(angle));
+            hash.add(f32Cos(angle));
+            hash.add(f32Acos(inputs.nextF32(-1.0f, 1.0f)));
+            hash.add(ct::fast::sin(angle));
+            hash.add(ct::fast::exp(inputs.nextF32(-80.0f, 80.0f)));
+            hash.add(ct::fast::log(positive));
+            hash.add(ct::fast::rsqrt(positive));
+            hash.add((u64)ct::floatToHalf(angle));
+        }
+
+        // Parallel sums have to agree for every thread count, including none.
+        std::vector<f32> values(cCount * 8);
+        for (f32& value : values) value = inputs.nextF32(-1000.0f, 1000.0f);
+
+        const f32 serialSum = ct::parallelSum(nullptr, values);
+        bool sumsAgree = true;
+        for (const int threadCount : { 1, 2, 3, 8 }) {
+            ct::WorkQueue workQueue(threadCount);
+            const f32 sum = ct::parallelSum(&workQueue, values);
+            if (std::bit_cast<u32>(sum) != std::bit_cast<u32>(serialSum)) {
+                std::fprintf(stderr, "parallelSum with %d threads: %.9g, expected %.9g\n", threadCount, sum, serialSum);
+                sumsAgree = false;
+            }
+        }
+        hash.add(serialSum);
+        hash.add(sumArray(dots));
+
+#if CT_MATH_DETERMINISTIC
+        constexpr const char* cMode = "deterministic";
+#else
+        constexpr const char* cMode = "default";
+#endif
+        std::printf("chibi-math-bench, backend: %s, float mode: %s\n", getBackendName(), cMode);
+        std::printf("hash: %016llx\n", (unsigned long long)hash.mValue);
+
+        if (!sumsAgree) {
+            return 1;
+        }
+
+        if (tExpected && std::strtoull(tExpected, nullptr, 16) != hash.mValue) {
+            std::fprintf(stderr, "Hash mismatch, expected %s.\n", tExpected);
+            return 1;
+        }
+        return 0;
+    }
+
+    //
+    // Tolerance checks
+    //
+
+    // Matches the bound documented on invertMat4.
+    constexpr f64 cInvertMat4Tolerance = 32.0 * F32_EPSILON;
+
+    // Reference inverse in f64, Gauss-Jordan with partial pivoting. Same column-major layout as mat4.
+    void invertMat4F64(const mat4& tMatrix, f64 tInverse[4][4])
+    {
+        f64 rows[4][8];
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                rows[row][column]     = tMatrix.Ptr[column][row];
+                rows[row][column + 4] = row == column ? 1.0 : 0.0;
+            }
+        }
+
+        for (int pivot = 0; pivot < 4; ++pivot) {
+            int best = pivot;
+            for (int row = pivot + 1; row < 4; ++row) {
+                if (std::abs(rows[row][pivot]) > std::abs(rows[best][pivot])) best = row;
+            }
+            std::swap(rows[pivot], rows[best]);
+
+            const f64 scale = 1.0 / rows[pivot][pivot];
+            for (f64& value : rows[pivot]) value *= scale;
+
+            for (int row = 0; row < 4; ++row) {
+                if (row == pivot) continue;
+                const f64 factor = rows[row][pivot];
+                for (int column = 0; column < 8; ++column) rows[row][column] -= factor * rows[pivot][column];
+            }
+        }
+
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                tInverse[column][row] = rows[row][column + 4];
+            }
+        }
+    }
+
+    // Largest difference between two inverses, relative to the largest element of the reference.
+    f64 getRelativeError(const mat4& tInverse, const f64 tReference[4][4])
+    {
+        f64 largest = 0.0;
+        f64 error   = 0.0;
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                largest = std::max(largest, std::abs(tReference[column][row]));
+                error   = std::max(error, std::abs(f64(tInverse.Ptr[column][row]) - tReference[column][row]));
+            }
+        }
+        return error / largest;
+    }
+
+    // Huge angles leave the range where constexprWrapAngle rounds through an integer. They are reduced with an exact
+    // fmod instead, so the result has to match std::fmod bit for bit and sin/cos have to stay within [-1, 1].
+    static_assert(constexprSin(1e20) >= -1.0 && constexprSin(1e20) <= 1.0, "Large angles must reduce without UB");
+    static_assert(constexprCos(-3.4e38) >= -1.0 && constexprCos(-3.4e38) <= 1.0, "Large angles must reduce without UB");
+
+    bool checkLargeAngles()
+    {
+        constexpr f64 cTwoPi = 2.0 * std::numbers::pi;
+
+        bool passed = true;
+        for (const f64 angle : { 1.5e10, -1.5e10, 1e15, 9.3e18, -9.3e18, 1e20, -1e20, 3.4e38, -3.4e38, 1e300 }) {
+            f64 expected = std::fmod(std::abs(angle), cTwoPi);
+            if (expected > std::numbers::pi) expected -= cTwoPi;
+            expected = (angle < 0.0) ? -expected : expected;
+
+            const f64 wrapped = constexprWrapAngle(angle);
+            const f32 sine    = f32Sin((f32)std::clamp(angle, -3.4e38, 3.4e38));
+            const f32 cosine  = f32Cos((f32)std::clamp(angle, -3.4e38, 3.4e38));
+            if (wrapped != expected || !(std::abs(sine) <= 1.0f) || !(std::abs(cosine) <= 1.0f)) {
+                std::fprintf(stderr, "Angle %g: wrapped %.17g, expected %.17g, sin %g, cos %g\n", angle, wrapped, expected, sine, cosine);
+                passed = false;
+            }
+        }
+        return passed;
+    }
+
+    // Worst angle between a unit normal and its octahedral round trip. Measured 6.4e-5 rad for Oct16 and 1.65e-2 rad
+    // (about 0.95 degrees) for Oct8 over these inputs, the bounds leave some headroom.
+    constexpr f64 cOct16Tolerance = 8e-5;
+    constexpr f64 cOct8Tolerance  = 2e-2;
+
+    f64 getAngleBetween(float3 tLeft, float3 tRight)
+    {
+        const f64 x = f64(tLeft.Y) * tRight.Z - f64(tLeft.Z) * tRight.Y;
+        const f64 y = f64(tLeft.Z) * tRight.X - f64(tLeft.X) * tRight.Z;
+        const f64 z = f64(tLeft.X) * tRight.Y - f64(tLeft.Y) * tRight.X;
+        const f64 dot = f64(tLeft.X) * tRight.X + f64(tLeft.Y) * tRight.Y + f64(tLeft.Z) * tRight.Z;
+        return std::atan2(std::sqrt(x * x + y * y + z * z), dot);
+    }
+
+    // The batch octahedral kernels have to produce the same bits as the single value functions, including the scalar
+    // tail (odd count) and the zero vector, and the round trip has to stay within the bounds above.
+    bool checkOctahedralNormals()
+    {
+        HashInputs inputs;
+
+        std::vector<float3> normals = { { 0.0f, 0.0f, 0.0f }, { -0.0f, 0.0f, -0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+                                        { 0.0f, 0.0f, -1.0f }, { -0.0f, 0.0f, 1.0f } };
+        while (normals.size() < 100003) {
+            const float3 normal = inputs.nextFloat3(-1.0f, 1.0f);
+            if (normal.lengthSq() > 1e-6f) normals.push_back(normal.getNorm());
+        }
+
+        std::vector<u32>    packed16(normals.size());
+        std::vector<u16>    packed8(normals.size());
+        std::vector<float3> unpacked16(normals.size());
+        std::vector<float3> unpacked8(normals.size());
+        ct::packNormalsOct16(normals, packed16);
+        ct::packNormalsOct8(normals, packed8);
+        ct::unpackNormalsOct16(packed16, unpacked16);
+        ct::unpackNormalsOct8(packed8, unpacked8);
+
+        const auto sameBits = [](float3 tLeft, float3 tRight) { return std::memcmp(&tLeft, &tRight, sizeof(float3)) == 0; };
+
+        u64 mismatches = 0;
+        f64 worst16    = 0.0;
+        f64 worst8     = 0.0;
+        for (size_t i = 0; i < normals.size(); ++i) {
+            mismatches += packed16[i] != ct::packNormalOct16(normals[i]);
+            mismatches += packed8[i] != ct::packNormalOct8(normals[i]);
+            mismatches += !sameBits(unpacked16[i], ct::unpackNormalOct16(packed16[i]));
+            mismatches += !sameBits(unpacked8[i], ct::unpackNormalOct8(packed8[i]));
+
+            if (normals[i].lengthSq() > 0.0f) {
+                worst16 = std::max(worst16, getAngleBetween(normals[i], unpacked16[i]));
+                worst8  = std::max(worst8, getAngleBetween(normals[i], unpacked8[i]));
+            }
+        }
+
+        // Every Oct8 code, including the ones no normal encodes to
+        std::vector<u16> codes(1 << 16);
+        for (size_t i = 0; i < codes.size(); ++i) codes[i] = u16(i);
+        std::vector<float3> decoded(codes.size());
+        ct::unpackNormalsOct8(codes, decoded);
+        for (size_t i = 0; i < codes.size(); ++i) {
+            mismatches += !sameBits(decoded[i], ct::unpackNormalOct8(codes[i]));
+        }
+
+        std::printf("oct16 round trip vs input:       %.3g rad (tolerance %.3g)\n", worst16, cOct16Tolerance);
+        std::printf("oct8 round trip vs input:        %.3g rad (tolerance %.3g)\n", worst8, cOct8Tolerance);
+        std::printf("oct batch vs single mismatches:  %llu\n", (unsigned long long)mismatches);
+
+        return mismatches == 0 && worst16 <= cOct16Tolerance && worst8 <= cOct8Tolerance;
+    }
+
+    int runToleranceCheck()
+    {
+        HashInputs inputs;
+        f64 worstSimd   = 0.0;
+        f64 worstScalar = 0.0;
+        f64 worstPaths  = 0.0;
+
+        // The matrices invertMat4 is used on: model transforms with non-uniform scale, views and projections.
+        for (u32 i = 0; i < 30000; ++i) {
+            mat4 matrix;
+            switch (i % 3) {
+                case 0: {
+                    const f32 scale = inputs.nextF32(0.01f, 100.0f);
+                    matrix = mat4MulRH(translateMatrix(inputs.nextFloat3(-100.0f, 100.0f)),
+                             mat4MulRH(RotateMatrix(inputs.nextF32(0.0f, 360.0f), inputs.nextFloat3(-1.0f, 1.0f)),
+                                       scaleMatrix(scale, scale * inputs.nextF32(0.5f, 2.0f), scale * inputs.nextF32(0.5f, 2.0f))));
+                } break;
+                case 1: {
+                    matrix = lookAtMatrixRh(inputs.nextFloat3(-100.0f, 100.0f), inputs.nextFloat3(-100.0f, 100.0f), { 0.0f, 1.0f, 0.0f });
+                } break;
+                default: {
+                    matrix = perspectiveMatrixRh(inputs.nextF32(30.0f, 90.0f), inputs.nextF32(1.0f, 2.5f), inputs.nextF32(0.01f, 1.0f), 1000.0f);
+                } break;
+            }
+
+            f64 reference[4][4];
+            invertMat4F64(matrix, reference);
+            const mat4 simd   = invertMat4(matrix);
+            const mat4 scalar = invertMat4Scalar(matrix);
+
+            f64 scalarAsF64[4][4];
+            for (int column = 0; column < 4; ++column) {
+                for (int row = 0; row < 4; ++row) scalarAsF64[column][row] = scalar.Ptr[column][row];
+            }
+
+            worstSimd   = std::max(worstSimd, getRelativeError(simd, reference));
+            worstScalar = std::max(worstScalar, getRelativeError(scalar, reference));
+            worstPaths  = std::max(worstPaths, getRelativeError(simd, scalarAsF64));
+        }
+
+        std::printf("chibi-math-bench, backend: %s\n", getBackendName());
+        std::printf("invertMat4 vs f64:               %.3g\n", worstSimd);
+        std::printf("invertMat4Scalar vs f64:         %.3g\n", worstScalar);
+        std::printf("invertMat4 vs invertMat4Scalar:  %.3g (tolerance %.3g)\n", worstPaths, cInvertMat4Tolerance);
+
+        const bool inverseFits = worstSimd <= cInvertMat4Tolerance && worstScalar <= cInvertMat4Tolerance && worstPaths <= cInvertMat4Tolerance;
+        if (!inverseFits) {
+            std::fprintf(stderr, "invertMat4 exceeds its documented tolerance.\n");
+        }
+
+        const bool anglesReduce = checkLargeAngles();
+        std::printf("large angle reduction:           %s\n", anglesReduce ? "ok" : "FAILED");
+
+        const bool octFits = checkOctahedralNormals();
+        if (!octFits) {
+            std::fprintf(stderr, "The octahedral normal kernels disagree or exceed their tolerance.\n");
+        }
+
+        return (inverseFits && anglesReduce && octFits) ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* jsonPath    = nullptr;
+    const char* filter      = nullptr;
+    u32         sampleCount = 5;
+    bool        hashOnly    = false;
+    bool        checkOnly   = false;
+    const char* expectHash  = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sampleCount = (u32)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--hash") == 0) {
+            hashOnly = true;
+        } else if (std::strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+            expectHash = argv[++i];
+        } else if (std::strcmp(argv[i], "--check") == 0) {
+            checkOnly = true;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json <file>] [--filter <substring>] [--samples <count>]\n", argv[0]);
+            std::fprintf(stderr, "       %s --hash [--expect <hex>]\n", argv[0]);
+            std::fprintf(stderr, "       %s --check\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (hashOnly) {
+        return runHashCheck(expectHash);
+    }
+
+    if (checkOnly) {
+        return runToleranceCheck();
+    }
+
+    std::printf("chibi-math-bench, backend: %s\n\n", getBackendName());
+    std::printf("%-34s %-5s %12s %12s %10s\n", "benchmark", "level", "ops", "ns/op", "GB/s");
+
+    std::vector<BenchResult> results;
+    for (const Benchmark& benchmark : makeBenchmarks()) {
+        if (filter && !std::strstr(benchmark.mName, filter)) {
+            continue;
+        }
+
+        for (const WorkingSet& workingSet : cWorkingSets) {
+            const BenchResult result = measure(benchmark, workingSet, sampleCount);
+            std::printf("%-34s %-5s %12llu %12.3f %10.2f\n", result.mName.c_str(), result.mLevel,
+                        (unsigned long long)result.mOpCount, result.mNsPerOp, result.mGBPerSecond);
+            results.push_back(result);
+        }
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, sampleCount)) {
+        return 1;
+    }
+
+    return 0;
+}
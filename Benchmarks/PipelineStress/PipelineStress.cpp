@@ -0,0 +1,82 @@
+//
+// chibi-pipeline-stress
+//
+// Starts and stops ct::FramePipeline over and over on one long-lived WorkQueue, the way Engine::runPipelined does
+// when a game exits: the pipeline is a stack object, the queue outlives it. Every run ends on a frame whose update
+// asks to stop, so the update task is often still returning from its completion signal when the pipeline goes out
+// of scope. Each frame also checks that render sees the snapshot the previous update published.
+//
+// Usage:
+//   chibi-pipeline-stress [--runs <count>] [--threads <count>]
+//
+// Only meaningful in a sanitizer build (see CT_SANITIZER in the root CMakeLists.txt), e.g.
+//   cmake -S . -B build-asan -DCT_SANITIZER=address && cmake --build build-asan --target chibi-pipeline-stress
+// Exits with 1 if render ever read the wrong snapshot.
+//
+
+#include <Systems/FramePipeline.h>
+#include <Systems/WorkQueue.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    u32 runCount    = 2000;
+    int threadCount = 4;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runCount = (u32)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--runs <count>] [--threads <count>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    ct::WorkQueue workQueue(threadCount);
+
+    u64 frameCount = 0;
+    u64 errorCount = 0;
+    for (u32 run = 0; run < runCount; ++run) {
+        ct::FramePipeline pipeline(workQueue);
+        std::array<u64, ct::FramePipeline::cSnapshotCount> snapshots{};
+
+        // Vary the run length so shutdown lands on different frames relative to the workers.
+        const u64 lastFrame = 1 + run % 7;
+        u64 frame = 0;
+
+        const ct::FramePipeline::UpdateFunc update = [&](u32 tWriteSnapshot) {
+            frame += 1;
+            snapshots[tWriteSnapshot] = frame;
+            return frame < lastFrame;
+        };
+
+        // Runs concurrently with the update of the next frame, which writes the other slot.
+        u64 expected = 1;
+        const ct::FramePipeline::RenderFunc render = [&](u32 tReadSnapshot) {
+            if (snapshots[tReadSnapshot] != expected) {
+                errorCount += 1;
+            }
+            return true;
+        };
+
+        if (!pipeline.prime(update)) {
+            continue;
+        }
+
+        while (pipeline.runFrame(update, render)) {
+            expected += 1;
+        }
+        frameCount += frame;
+    }
+
+    std::printf("chibi-pipeline-stress: %u runs, %llu frames, %llu errors\n", runCount,
+                (unsigned long long)frameCount, (unsigned long long)errorCount);
+    return errorCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+//
+// chibi-queue-bench
+//
+// Throughput of util::MpmcQueue and util::SpscQueue against a std::mutex guarded std::deque, the obvious thing they
+// replace. Each run moves a fixed number of u64 values from the producer threads to the consumer threads through a
+// small queue and reports the wall time per value, so the numbers include contention and full/empty retries. Each
+// result is the best of several samples.
+//
+// Usage:
+//   chibi-queue-bench [--json <file>] [--filter <substring>] [--samples <count>]
+//
+// Like chibi-math-bench, the JSON output is meant to be diffed between runs on the same machine and build flags. The
+// multi-threaded rows need at least as many cores as threads to mean anything. For correctness see
+// chibi-queue-stress.
+//
+
+#include <Util/ConcurrentQueue.h>
+#include <Platform/Timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Keeps the optimiser from discarding results that are otherwise never read.
+    volatile u64 gSink = 0;
+
+    constexpr size_t cQueueCapacity = 1024;
+    constexpr u64    cItemsPerRun   = 1u << 20;
+
+    // Same interface as the lock-free queues.
+    class MutexQueue
+    {
+    public:
+        explicit MutexQueue(size_t tCapacity) : mCapacity(tCapacity) {}
+
+        bool tryPush(u64 tValue)
+        {
+            std::lock_guard lock(mLock);
+            if (mValues.size() == mCapacity) {
+                return false;
+            }
+            mValues.push_back(tValue);
+            return true;
+        }
+
+        std::optional<u64> tryPop()
+        {
+            std::lock_guard lock(mLock);
+            if (mValues.empty()) {
+                return std::nullopt;
+            }
+            const u64 value = mValues.front();
+            mValues.pop_front();
+            return value;
+        }
+
+    private:
+        std::mutex      mLock;
+        std::deque<u64> mValues;
+        size_t          mCapacity;
+    };
+
+    struct Benchmark
+    {
+        std::string          mName;
+        u32                  mProducers;
+        u32                  mConsumers;
+        std::function<f64()> mRun; // Returns the seconds one run took
+    };
+
+    struct BenchResult
+    {
+        std::string mName;
+        u32         mProducers;
+        u32         mConsumers;
+        f64         mNsPerItem;
+    };
+
+    // Moves cItemsPerRun values from tProducers threads to tConsumers threads, spinning with a yield on full/empty.
+    template<class Queue>
+    f64 runQueue(u32 tProducers, u32 tConsumers)
+    {
+        Queue queue(cQueueCapacity);
+        std::atomic<bool> go{false};
+        std::atomic<u64>  consumed{0};
+        std::atomic<u64>  sum{0};
+
+        std::vector<std::thread> threads;
+        for (u32 producer = 0; producer < tProducers; ++producer) {
+            threads.emplace_back([&, producer] {
+                while (!go.load(std::memory_order_acquire)) {}
+                for (u64 value = producer; value < cItemsPerRun; value += tProducers) {
+                    while (!queue.tryPush(value)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (u32 consumer = 0; consumer < tConsumers; ++consumer) {
+            threads.emplace_back([&] {
+                while (!go.load(std::memory_order_acquire)) {}
+                u64 localSum = 0;
+                while (consumed.load(std::memory_order_relaxed) < cItemsPerRun) {
+                    if (std::optional<u64> value = queue.tryPop()) {
+                        localSum += *value;
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                sum.fetch_add(localSum, std::memory_order_relaxed);
+            });
+        }
+
+        ct::os::Timer timer;
+        timer.start();
+        go.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        timer.update();
+
+        gSink = gSink + sum.load();
+        return timer.getSecondsElapsed();
+    }
+
+    //
+    // The suite
+    //
+
+    template<class Queue>
+    void addQueueBenchmark(std::vector<Benchmark>& tBenchmarks, const char* tName, u32 tProducers, u32 tConsumers)
+    {
+        tBenchmarks.push_back({ tName, tProducers, tConsumers, [tProducers, tConsumers] {
+            return runQueue<Queue>(tProducers, tConsumers);
+        }});
+    }
+
+    std::vector<Benchmark> makeBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+        addQueueBenchmark<util::SpscQueue<u64>>(benchmarks, "SpscQueue", 1, 1);
+
+        for (const u32 threads : { 1u, 2u, 4u }) {
+            addQueueBenchmark<util::MpmcQueue<u64>>(benchmarks, "MpmcQueue", threads, threads);
+            addQueueBenchmark<MutexQueue>(benchmarks, "mutex deque", threads, threads);
+        }
+
+        // Many producers feeding one consumer, the shape of the work queue and the log.
+        addQueueBenchmark<util::MpmcQueue<u64>>(benchmarks, "MpmcQueue", 4, 1);
+        addQueueBenchmark<MutexQueue>(benchmarks, "mutex deque", 4, 1);
+        return benchmarks;
+    }
+
+    BenchResult measure(const Benchmark& tBenchmark, u32 tSampleCount)
+    {
+        // The first run warms up the allocator and spins up the cores.
+        tBenchmark.mRun();
+
+        // The minimum is the least noisy estimate, anything slower was interrupted by something else.
+        f64 bestSeconds = std::numeric_limits<f64>::max();
+        for (u32 sample = 0; sample < tSampleCount; ++sample) {
+            bestSeconds = std::min(bestSeconds, tBenchmark.mRun());
+        }
+
+        BenchResult result;
+        result.mName      = tBenchmark.mName;
+        result.mProducers = tBenchmark.mProducers;
+        result.mConsumers = tBenchmark.mConsumers;
+        result.mNsPerItem = bestSeconds * 1e9 / f64(cItemsPerRun);
+        return result;
+    }
+
+    bool writeJson(const char* tPath, const std::vector<BenchResult>& tResults, u32 tSampleCount)
+    {
+        FILE* file = std::fopen(tPath, "w");
+        if (!file) {
+            std::fprintf(stderr, "Failed to open '%s' for writing.\n", tPath);
+            return false;
+        }
+
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+        std::fprintf(file, "  \"samples\": %u,\n", tSampleCount);
+        std::fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i < tResults.size(); ++i) {
+            const BenchResult& result = tResults[i];
+            std::fprintf(file, "    { \"name\": \"%s\", \"producers\": %u, \"consumers\": %u, \"ns_per_item\": %.4f }%s\n",
+                         result.mName.c_str(), result.mProducers, result.mConsumers, result.mNsPerItem,
+                         (i + 1 < tResults.size()) ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+
+        std::fclose(file);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* jsonPath    = nullptr;
+    const char* filter      = nullptr;
+    u32         sampleCount = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sampleCount = (u32)std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--json <file>] [--filter <substring>] [--samples <count>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("chibi-queue-bench, hardware threads: %u\n\n", std::thread::hardware_concurrency());
+    std::printf("%-16s %9s %9s %12s\n", "benchmark", "producers", "consumers", "ns/item");
+
+    std::vector<BenchResult> results;
+    for (const Benchmark& benchmark : makeBenchmarks()) {
+        if (filter && !std::strstr(benchmark.mName.c_str(), filter)) {
+            continue;
+        }
+
+        const BenchResult result = measure(benchmark, sampleCount);
+        std::printf("%-16s %9u %9u %12.2f\n", result.mName.c_str(), result.mProducers, result.mConsumers, result.mNsPerItem);
+        results.push_back(result);
+    }
+
+    if (jsonPath && !writeJson(jsonPath, results, sampleCount)) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+//
+// chibi-queue-stress
+//
+// Correctness run for util::MpmcQueue and util::SpscQueue.
+//
+// - mpmc: several producers and consumers share one small queue, so it is full and empty often and the cells wrap
+//   many laps. Every value pushed must be popped exactly once, and each consumer must see the values of any one
+//   producer in the order they were pushed.
+// - spsc: one producer and one consumer, every value must arrive exactly once and in order.
+//
+// The values carry a heap allocated string, so a sanitizer build also catches a value that is moved out twice,
+// destroyed twice or leaked by the queue destructor.
+//
+// Usage:
+//   chibi-queue-stress [--producers <count>] [--consumers <count>] [--items <count per producer>]
+//
+// Only meaningful in a sanitizer build (see CT_SANITIZER in the root CMakeLists.txt):
+//   cmake -S . -B build-tsan -DCT_SANITIZER=thread && cmake --build build-tsan --target chibi-queue-stress
+// Exits with 1 if any check failed.
+//
+
+#include <Util/ConcurrentQueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Small enough that producers regularly find the queue full.
+    constexpr size_t cQueueCapacity = 64;
+
+    struct Item
+    {
+        u32         mProducer{0};
+        u32         mSequence{0};
+        std::string mCheck{}; // Longer than the small string buffer, so it owns a heap block
+    };
+
+    std::string makeCheck(u32 tProducer, u32 tSequence)
+    {
+        char check[64];
+        std::snprintf(check, sizeof(check), "producer %u, item %u, padded past SSO", tProducer, tSequence);
+        return check;
+    }
+
+    std::atomic<u64> gErrorCount{0};
+
+    void check(bool tCondition, const char* tWhat)
+    {
+        if (!tCondition && gErrorCount.fetch_add(1) < 8) {
+            std::fprintf(stderr, "check failed: %s\n", tWhat);
+        }
+    }
+
+    void runMpmc(u32 tProducerCount, u32 tConsumerCount, u32 tItemsPerProducer)
+    {
+        util::MpmcQueue<Item> queue(cQueueCapacity);
+
+        const u64 totalItems = u64(tProducerCount) * tItemsPerProducer;
+        std::unique_ptr<std::atomic<u8>[]> popCounts(new std::atomic<u8>[totalItems]{});
+        std::atomic<u64> poppedCount{0};
+
+        std::vector<std::thread> threads;
+        for (u32 producer = 0; producer < tProducerCount; ++producer) {
+            threads.emplace_back([&queue, producer, tItemsPerProducer] {
+                for (u32 sequence = 0; sequence < tItemsPerProducer; ++sequence) {
+                    Item item{ producer, sequence, makeCheck(producer, sequence) };
+                    while (!queue.tryPush(std::move(item))) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (u32 consumer = 0; consumer < tConsumerCount; ++consumer) {
+            threads.emplace_back([&, tProducerCount] {
+                // The last sequence this consumer saw from each producer.
+                std::vector<s64> lastSequence(tProducerCount, -1);
+
+                while (poppedCount.load(std::memory_order_relaxed) < totalItems) {
+                    std::optional<Item> item = queue.tryPop();
+                    if (!item) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    poppedCount.fetch_add(1, std::memory_order_relaxed);
+                    if (item->mProducer >= tProducerCount || item->mSequence >= tItemsPerProducer) {
+                        check(false, "mpmc: value was never pushed");
+                        continue;
+                    }
+
+                    check(item->mCheck == makeCheck(item->mProducer, item->mSequence), "mpmc: value arrived intact");
+                    check(s64(item->mSequence) > lastSequence[item->mProducer], "mpmc: per producer order kept");
+                    lastSequence[item->mProducer] = item->mSequence;
+
+                    popCounts[u64(item->mProducer) * tItemsPerProducer + item->mSequence].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (u64 i = 0; i < totalItems; ++i) {
+            check(popCounts[i].load() == 1, "mpmc: every value popped exactly once");
+        }
+        check(!queue.tryPop().has_value(), "mpmc: queue is empty afterwards");
+
+        // Leave values behind for the destructor to clean up.
+        for (u32 i = 0; i < cQueueCapacity / 2; ++i) {
+            check(queue.tryPush(Item{ 0, i, makeCheck(0, i) }), "mpmc: push into a drained queue");
+        }
+    }
+
+    void runSpsc(u32 tItemCount)
+    {
+        util::SpscQueue<Item> queue(cQueueCapacity);
+
+        std::thread producer([&queue, tItemCount] {
+            for (u32 sequence = 0; sequence < tItemCount; ++sequence) {
+                Item item{ 0, sequence, makeCheck(0, sequence) };
+                while (!queue.tryPush(std::move(item))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        for (u32 expected = 0; expected < tItemCount;) {
+            std::optional<Item> item = queue.tryPop();
+            if (!item) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            check(item->mSequence == expected, "spsc: values arrive in order");
+            check(item->mCheck == makeCheck(0, item->mSequence), "spsc: value arrived intact");
+            expected = item->mSequence + 1;
+        }
+
+        producer.join();
+        check(!queue.tryPop().has_value(), "spsc: queue is empty afterwards");
+
+        for (u32 i = 0; i < cQueueCapacity / 2; ++i) {
+            check(queue.tryPush(Item{ 0, i, makeCheck(0, i) }), "spsc: push into a drained queue");
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    u32 producerCount    = 4;
+    u32 consumerCount    = 4;
+    u32 itemsPerProducer = 100000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--producers") == 0 && i + 1 < argc) {
+            producerCount = (u32)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--consumers") == 0 && i + 1 < argc) {
+            consumerCount = (u32)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--items") == 0 && i + 1 < argc) {
+            itemsPerProducer = (u32)std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--producers <count>] [--consumers <count>] [--items <count per producer>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    runMpmc(producerCount, consumerCount, itemsPerProducer);
+    runSpsc(producerCount * itemsPerProducer);
+
+    const u64 errors = gErrorCount.load();
+    std::printf("chibi-queue-stress: %u producers, %u consumers, %u items per producer, %llu errors\n", producerCount,
+                consumerCount, itemsPerProducer, (unsigned long long)errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+//
+// chibi-storage-stress
+//
+// Hammers util::ConcurrentSparseStorage from several threads to validate the lock-free free stack and the
+// generation CAS in destroy.
+//
+// - churn: every thread creates and destroys its own handles, checking on destroy that nobody else was handed the
+//   same row in the meantime (a free stack ABA bug would give one slot to two threads).
+// - race: threads trade handles through a shared table. Ownership moves with an atomic exchange, and every thread
+//   also destroys handles it no longer owns (double destroy). Only the first destroy of a handle may succeed, so
+//   the storage has to end up empty and no row may ever be handed out twice.
+//
+// Usage:
+//   chibi-storage-stress [--threads <count>] [--ops <count per thread>]
+//
+// Only meaningful in a sanitizer build (see CT_SANITIZER in the root CMakeLists.txt):
+//   cmake -S . -B build-tsan -DCT_SANITIZER=thread -DCMAKE_BUILD_TYPE=Debug
+//   cmake --build build-tsan --target chibi-storage-stress && ./build-tsan/Benchmarks/chibi-storage-stress
+// Exits with 1 if any check failed.
+//
+
+#include <Util/ConcurrentSparseStorage.h>
+#include <Systems/StorageHelpers.h>
+#include <Systems/WorkQueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Payload
+    {
+        u64 mOwner{0};
+        u64 mCheck{0};
+    };
+
+    // 12 generation bits: with LIFO reuse a stale handle has to survive 2048 reuses of its slot before destroying it
+    // could hit a newer generation, far more than the handles in this test live for.
+    using Storage  = util::ConcurrentSparseStorage<20, 12, struct StressTag, Payload>;
+    using HandleId = Storage::IdType;
+
+    constexpr size_t cHandlesPerThread = 64;
+    constexpr size_t cSharedCells      = 256;
+
+    std::atomic<u64> gErrorCount{0};
+
+    void check(bool tCondition, const char* tWhat)
+    {
+        if (!tCondition && gErrorCount.fetch_add(1) < 8) {
+            std::fprintf(stderr, "check failed: %s\n", tWhat);
+        }
+    }
+
+    u64 makeStamp(u32 tThread, u64 tOp) { return (u64(tThread) << 48) | tOp; }
+
+    void runChurn(Storage& tStorage, u32 tThreadCount, u64 tOpsPerThread)
+    {
+        std::vector<std::thread> threads;
+        for (u32 thread = 0; thread < tThreadCount; ++thread) {
+            threads.emplace_back([&tStorage, thread, tOpsPerThread] {
+                std::mt19937 rng(thread + 1);
+                std::vector<std::pair<HandleId, u64>> owned;
+
+                for (u64 op = 0; op < tOpsPerThread; ++op) {
+                    if (owned.size() < cHandlesPerThread && (owned.empty() || (rng() & 1))) {
+                        const u64 stamp = makeStamp(thread, op);
+                        const HandleId id = tStorage.create(Payload{ stamp, ~stamp });
+                        check(tStorage.isIdValid(id), "churn: a new handle is valid");
+                        owned.push_back({ id, stamp });
+                        continue;
+                    }
+
+                    const size_t index = rng() % owned.size();
+                    const auto [id, stamp] = owned[index];
+                    const Payload& payload = tStorage.getReadable<Payload>(id);
+                    check(payload.mOwner == stamp && payload.mCheck == ~stamp, "churn: row untouched while owned");
+
+                    tStorage.destroy(id);
+                    check(!tStorage.isIdValid(id), "churn: a destroyed handle is invalid");
+
+                    owned[index] = owned.back();
+                    owned.pop_back();
+                }
+
+                for (const auto& [id, stamp] : owned) {
+                    tStorage.destroy(id);
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void runRace(Storage& tStorage, u32 tThreadCount, u64 tOpsPerThread)
+    {
+        std::vector<std::atomic<HandleId>> cells(cSharedCells);
+        for (auto& cell : cells) {
+            cell.store(HandleId());
+        }
+
+        std::vector<std::thread> threads;
+        for (u32 thread = 0; thread < tThreadCount; ++thread) {
+            threads.emplace_back([&tStorage, &cells, thread, tOpsPerThread] {
+                std::mt19937 rng(1000 + thread);
+                std::vector<HandleId> stale;
+
+                for (u64 op = 0; op < tOpsPerThread; ++op) {
+                    std::atomic<HandleId>& cell = cells[rng() % cells.size()];
+
+                    // Either publish a new handle or take the current one, whatever was in the cell is now ours.
+                    HandleId taken;
+                    if (rng() & 1) {
+                        const u64 stamp = makeStamp(thread, op);
+                        taken = cell.exchange(tStorage.create(Payload{ stamp, ~stamp }));
+                    } else {
+                        taken = cell.exchange(HandleId());
+                    }
+
+                    if (taken == HandleId()) {
+                        continue;
+                    }
+
+                    const Payload& payload = tStorage.getReadable<Payload>(taken);
+                    check(payload.mCheck == ~payload.mOwner, "race: row untouched while owned");
+                    tStorage.destroy(taken);
+
+                    // Destroy a few handles that were already destroyed, possibly while their slot is reused.
+                    stale.push_back(taken);
+                    if (stale.size() > 16) {
+                        for (const HandleId id : stale) {
+                            tStorage.destroy(id);
+                        }
+                        stale.clear();
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (auto& cell : cells) {
+            const HandleId id = cell.exchange(HandleId());
+            if (!(id == HandleId())) {
+                check(tStorage.isIdValid(id), "race: a published handle is still valid");
+                tStorage.destroy(id);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    u32 threadCount = 4;
+    u64 opsPerThread = 200000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = (u32)std::max(2, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            opsPerThread = (u64)std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Usage: %s [--threads <count>] [--ops <count per thread>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Storage storage(threadCount * cHandlesPerThread + cSharedCells);
+
+    runChurn(storage, threadCount, opsPerThread);
+    check(storage.getNumLiveObjects() == 0, "churn: every handle was destroyed");
+
+    runRace(storage, threadCount, opsPerThread);
+    check(storage.getNumLiveObjects() == 0, "race: every handle was destroyed exactly once");
+
+    // The rows handed out by the free stack are still readable from a parallel pass.
+    ct::WorkQueue workQueue((int)threadCount);
+    const u64 rowCount = storage.cap();
+    for (u64 i = 0; i < rowCount; ++i) {
+        (void)storage.create(Payload{ i, ~i });
+    }
+
+    std::atomic<u64> sum{0};
+    ct::forEachParallel<Payload>(&workQueue, storage, [&](const Payload& tPayload) {
+        sum.fetch_add(tPayload.mOwner, std::memory_order_relaxed);
+    });
+    check(sum.load() == rowCount * (rowCount - 1) / 2, "forEachParallel: visits every live row once");
+
+    const u64 errors = gErrorCount.load();
+    std::printf("chibi-storage-stress: %u threads, %llu ops per thread, %llu errors\n", threadCount,
+                (unsigned long long)opsPerThread, (unsigned long long)errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -8,11 +8,13 @@
 #include "Types.h"
 
 #include "Platform/Window.h"
+#include "Platform/FramePacer.h"
 
 #include "Systems/ShaderLoader.h"
 
 namespace ct {
     class Game;
+    class WorkQueue;
 }
 
 class GpuState;
@@ -23,6 +25,8 @@ namespace ct {
         size_t           mWindowWidth;
         size_t           mWindowHeight;
         const char*      mAssetDirectory;
+        bool             mIsPipelined{false}; // See GameInfo::mIsPipelined
+        f64              mTargetFrameRate{60.0}; // <= 0 runs uncapped
     };
 
     class Engine {
@@ -35,6 +39,9 @@ namespace ct {
         void run(Game* tGame);
 
         GpuState* getGpuState() const;
+        WorkQueue* getWorkQueue() const;
+
+        os::FramePacer& getFramePacer() { return mFramePacer; }
 
         ShaderResource loadShader(std::string_view tShaderName, ShaderStage tStage);
         void unloadShader(ShaderResource tShader);
@@ -42,9 +49,15 @@ namespace ct {
     private:
         std::unique_ptr<os::Window> mClientWindow{nullptr};
         std::unique_ptr<GpuState>   mGpuState{nullptr};
+        std::unique_ptr<WorkQueue>  mWorkQueue{nullptr};
         std::filesystem::path       mAssetDirectory{};
 
         ShaderLoader                mShaderLoader;
+        bool                        mIsPipelined{false};
+        os::FramePacer              mFramePacer;
+
+        void runSerial(Game* tGame);
+        void runPipelined(Game* tGame);
     };
 
     using EngineSptr = std::shared_ptr<Engine>;
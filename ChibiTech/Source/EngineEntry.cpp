@@ -17,6 +17,9 @@
 
 #include "Gpu/GpuState.h"
 
+#include "Systems/FramePipeline.h"
+#include "Systems/WorkQueue.h"
+
 #include "util/SparseStorage.h"
 
 namespace {
@@ -39,6 +42,8 @@ namespace ct {
     : mClientWindow(nullptr)
     , mAssetDirectory(tInfo.mAssetDirectory)
     , mShaderLoader(mAssetDirectory / "Shaders")
+    , mIsPipelined(tInfo.mIsPipelined)
+    , mFramePacer(tInfo.mTargetFrameRate)
     {
         os::initOSState();
 
@@ -51,11 +56,15 @@ namespace ct {
         mClientWindow = std::make_unique<os::Window>(tInfo.mWindowWidth, tInfo.mWindowHeight, tInfo.WindowTitle);
         mGpuState = std::make_unique<GpuState>(*mClientWindow);
 
+        // Leave a core for the main thread.
+        mWorkQueue = std::make_unique<WorkQueue>(WorkQueue::getSystemThreadCount() - 1);
+
         console::info("Engine initialized");
     }
 
     void Engine::shutdown()
     {
+        mWorkQueue->release();
         mGpuState->destroy();
 
         glfwTerminate();
@@ -66,21 +75,27 @@ namespace ct {
     {
         console::info("Engine running.");
 
-        // TODO(enylnn): respond to the refresh rate of the monitor.
-        constexpr f32 cRefreshRateHz = 1.0f / 60.0f;
+        if (mIsPipelined) {
+            runPipelined(tGame);
+        }
+        else {
+            runSerial(tGame);
+        }
 
-        auto elapsedTimer = os::Timer();
-        elapsedTimer.start();
+        const os::FrameTimeStats stats = mFramePacer.getFrameTimeStats();
+        console::info("Frame times over the last %u frames: avg %.3lf ms, p50 %.3lf ms, p95 %.3lf ms, p99 %.3lf ms, max %.3lf ms",
+                      stats.mSampleCount, stats.mAverageMS, stats.mP50MS, stats.mP95MS, stats.mP99MS, stats.mMaxMS);
 
-        auto frameTimer = os::Timer();
+        console::info("Engine finished running.");
+    }
 
+    void Engine::runSerial(Game* tGame)
+    {
         while (true) {
             if (mClientWindow && !mClientWindow->isRunning()) {
                 break;
             }
 
-            frameTimer.start();
-
             // poll for user input
             mClientWindow->pollInputs();
 
@@ -96,31 +111,53 @@ namespace ct {
                 break;
             }
 
-            // End of the frame
-            elapsedTimer.update();
-            frameTimer.update();
-
             // Meet the target frame rate so we don't melt the CPU/GPU
-            const f64 targetRefreshRate      = cRefreshRateHz;
-            const f64 workSecondsElapsed     = frameTimer.getSecondsElapsed();
-            const f64 secondsElapsedForFrame = workSecondsElapsed;
-            if (secondsElapsedForFrame < targetRefreshRate)
-            {
-                s64 sleepMS = (s64)(1000.0 * (targetRefreshRate - secondsElapsedForFrame));
-                if (sleepMS > 0)
-                {
-                    os::sleepMainThread((u32)sleepMS);
-                }
-            }
+            mFramePacer.waitForNextFrame();
         }
+    }
 
-        console::info("Engine finished running.");
+    void Engine::runPipelined(Game* tGame)
+    {
+        FramePipeline pipeline(*mWorkQueue);
+
+        const FramePipeline::UpdateFunc update = [this, tGame](u32 tWriteSnapshot) {
+            return tGame->onUpdatePipelined(*this, tWriteSnapshot);
+        };
+
+        const FramePipeline::RenderFunc render = [this, tGame](u32 tReadSnapshot) {
+            return tGame->onRenderPipelined(*this, tReadSnapshot);
+        };
+
+        // Input is polled on the main thread before the update is kicked, so the worker never touches the window.
+        mClientWindow->pollInputs();
+        if (!pipeline.prime(update)) {
+            return;
+        }
+
+        while (true) {
+            if (mClientWindow && !mClientWindow->isRunning()) {
+                break;
+            }
+
+            mClientWindow->pollInputs();
+
+            if (!pipeline.runFrame(update, render)) {
+                break;
+            }
+
+            // Meet the target frame rate so we don't melt the CPU/GPU
+            mFramePacer.waitForNextFrame();
+        }
     }
 
     GpuState* Engine::getGpuState() const {
         return mGpuState.get();
     }
 
+    WorkQueue* Engine::getWorkQueue() const {
+        return mWorkQueue.get();
+    }
+
     Engine::~Engine() {
         // required for partial types to know how to destruct
     }
@@ -17,10 +17,12 @@ static void GameEntryPoint()
     ct::GameInfo gameInfo = game->getGameInfo();
 
     auto createInfo = ct::EngineInfo{
-        .WindowTitle     = gameInfo.mWindowTitle.empty() ? "Chibi Tech" : gameInfo.mWindowTitle,
-        .mWindowWidth    = gameInfo.mWindowWidth  < 8 ? 1920 : gameInfo.mWindowWidth,
-        .mWindowHeight   = gameInfo.mWindowHeight < 8 ? 1080 : gameInfo.mWindowHeight,
-        .mAssetDirectory = gameInfo.mAssetPath,
+        .WindowTitle      = gameInfo.mWindowTitle.empty() ? "Chibi Tech" : gameInfo.mWindowTitle,
+        .mWindowWidth     = gameInfo.mWindowWidth  < 8 ? 1920 : gameInfo.mWindowWidth,
+        .mWindowHeight    = gameInfo.mWindowHeight < 8 ? 1080 : gameInfo.mWindowHeight,
+        .mAssetDirectory  = gameInfo.mAssetPath,
+        .mIsPipelined     = gameInfo.mIsPipelined,
+        .mTargetFrameRate = gameInfo.mTargetFrameRate,
     };
 
     ct::createEngine(createInfo);
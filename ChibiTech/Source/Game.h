@@ -2,6 +2,9 @@
 
 #include <string_view>
 
+#include "Types.h"
+#include "Platform/Console.h"
+
 namespace ct {
     class Engine;
 
@@ -10,6 +13,13 @@ namespace ct {
         size_t           mWindowWidth{0};
         size_t           mWindowHeight{0};
         const char*      mAssetPath;
+
+        // When set, onUpdatePipelined for frame N+1 runs on a worker thread while onRenderPipelined records
+        // frame N on the main thread. See FramePipeline for the snapshot contract.
+        bool             mIsPipelined{false};
+
+        // TODO(enlynn): respond to the refresh rate of the monitor. <= 0 runs uncapped.
+        f64              mTargetFrameRate{60.0};
     };
 
     class Game {
@@ -20,5 +30,16 @@ namespace ct {
         virtual bool onUpdate(Engine& tEngine)  { return true; }
         virtual bool onRender(Engine& tEngine)  { return true; }
         virtual bool onDestroy(Engine& tEngine) { return true; }
+
+        // Pipelined frames only. Update must only write snapshot tWriteSnapshot and must not touch the GPU,
+        // render must only read snapshot tReadSnapshot. A game that sets mIsPipelined has to override both: there is
+        // no safe default, onUpdate and onRender would run at the same time on two threads over shared state.
+        virtual bool onUpdatePipelined(Engine& tEngine, u32 tWriteSnapshot) {
+            console::fatal("GameInfo::mIsPipelined is set, but the game does not override onUpdatePipelined.");
+        }
+
+        virtual bool onRenderPipelined(Engine& tEngine, u32 tReadSnapshot) {
+            console::fatal("GameInfo::mIsPipelined is set, but the game does not override onRenderPipelined.");
+        }
     };
 }
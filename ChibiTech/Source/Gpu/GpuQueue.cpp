@@ -3,6 +3,7 @@
 #include "GpuDevice.h"
 
 #include <Platform/Assert.h>
+#include <Util/SmallVector.h>
 
 #include <vector>
 
@@ -112,7 +113,7 @@ GpuCommandListUPtr GpuQueue::getCommandList(GpuCommandListType Type)
 
 GpuFence GpuQueue::executeCommandLists(std::span<GpuCommandListUPtr> tCommandLists)
 {
-    std::vector<ID3D12CommandList*> toBeSubmitted;
+    util::SmallVector<ID3D12CommandList*, 16> toBeSubmitted;
 	toBeSubmitted.reserve(tCommandLists.size());
 
 	for(auto& list : tCommandLists)
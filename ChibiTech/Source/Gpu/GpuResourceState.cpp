@@ -4,36 +4,16 @@
 #include <Platform/Assert.h>
 #include <Platform/Console.h>
 
-static GpuResourceStateMapEntry*
+static GpuResourceState*
 GetResourceMapEntry(GpuResourceStateMap& ResourceMap, ID3D12Resource* Handle)
 {
-    ForRange (int, i, ResourceMap.size())
-    {
-        GpuResourceStateMapEntry* Entry = &ResourceMap[i];
-        if (Entry->mResourceHandle == Handle) return Entry;
-    }
-
-    return nullptr;
-}
-
-static void
-RemoveResourceMapEntry(GpuResourceStateMap& ResourceMap, ID3D12Resource* Handle)
-{
-    ForRange (int, i, ResourceMap.size())
-    {
-        GpuResourceStateMapEntry* Entry = &ResourceMap[i];
-        // Order is not preserved in the map, so a Swap-Delete is fine.
-        if (Entry->mResourceHandle == Handle) {
-            ResourceMap[i] = ResourceMap.back();
-            ResourceMap.pop_back();
-        }
-    }
+    auto Entry = ResourceMap.find(Handle);
+    return Entry != ResourceMap.end() ? &Entry->second : nullptr;
 }
 
 GpuResourceState::GpuResourceState(D3D12_RESOURCE_STATES State)
 {
-    mState             = State;
-    mSubresourcesCount = 0;
+    mState = State;
 }
 
 void GpuResourceState::setSubresourceState(u32 Subresource, D3D12_RESOURCE_STATES State)
@@ -41,13 +21,13 @@ void GpuResourceState::setSubresourceState(u32 Subresource, D3D12_RESOURCE_STATE
     // If we are transitioning all resources, then no need to track a subresource
     if (Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
     {
-        mState             = State;
-        mSubresourcesCount = 0;
+        mState = State;
+        mSubresources.clear();
         return;
     }
 
     // Updating a single Resource, let's see if it is already being tracked.
-    ForRange(u32, i, mSubresourcesCount)
+    ForRange(u32, i, mSubresources.size())
     {
         if (Subresource == mSubresources[i].mIndex)
         {
@@ -57,21 +37,18 @@ void GpuResourceState::setSubresourceState(u32 Subresource, D3D12_RESOURCE_STATE
     }
 
     // Subresource is not found, let's insert it.
-    ASSERT(mSubresourcesCount + 1 < cMaxSubresources);
-
     GpuSubresourceState NewSubresource = {};
     NewSubresource.mIndex = Subresource;
     NewSubresource.mState = State;
 
-    mSubresources[mSubresourcesCount] = NewSubresource;
-    mSubresourcesCount += 1;
+    mSubresources.push_back(NewSubresource);
 }
 
 D3D12_RESOURCE_STATES GpuResourceState::getSubresourceState(u32 Subresource)
 {
     D3D12_RESOURCE_STATES Result = mState;
 
-    ForRange(u32, i, mSubresourcesCount)
+    ForRange(u32, i, mSubresources.size())
     {
         if (Subresource == mSubresources[i].mIndex)
         {
@@ -109,15 +86,15 @@ void GpuResourceStateTracker::resourceBarrier(D3D12_RESOURCE_BARRIER& Barrier)
         D3D12_RESOURCE_TRANSITION_BARRIER& TransitionBarrier = Barrier.Transition;
 
         // Is this a known Barrier, if so, we know the last used state.
-        GpuResourceStateMapEntry* KnownResource = GetResourceMapEntry(mFinalResourceState, TransitionBarrier.pResource);
+        GpuResourceState* KnownResource = GetResourceMapEntry(mFinalResourceState, TransitionBarrier.pResource);
         if (KnownResource)
         {
             // If this is an updated state and ALL_SUBRESOURCES, then transition all known subresources.
-            if (TransitionBarrier.Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES && KnownResource->mState.mSubresourcesCount > 0)
+            if (TransitionBarrier.Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES && !KnownResource->mSubresources.empty())
             {
-                ForRange (u32, i, KnownResource->mState.mSubresourcesCount)
+                ForRange (u32, i, KnownResource->mSubresources.size())
                 {
-                    GpuSubresourceState& SubresourceState = KnownResource->mState.mSubresources[i];
+                    GpuSubresourceState& SubresourceState = KnownResource->mSubresources[i];
                     if (SubresourceState.mState != TransitionBarrier.StateAfter)
                     {
                         D3D12_RESOURCE_BARRIER NewBarrier = Barrier;
@@ -129,7 +106,7 @@ void GpuResourceStateTracker::resourceBarrier(D3D12_RESOURCE_BARRIER& Barrier)
             }
             else
             { // Transitioning a specific subresource, add a barrier if it's final state is changing
-                D3D12_RESOURCE_STATES BeforeState = KnownResource->mState.getSubresourceState(
+                D3D12_RESOURCE_STATES BeforeState = KnownResource->getSubresourceState(
                         TransitionBarrier.Subresource);
                 if (BeforeState != TransitionBarrier.StateAfter)
                 {
@@ -140,7 +117,7 @@ void GpuResourceStateTracker::resourceBarrier(D3D12_RESOURCE_BARRIER& Barrier)
             }
 
             // Update the Resource State
-            KnownResource->mState.setSubresourceState(TransitionBarrier.Subresource, TransitionBarrier.StateAfter);
+            KnownResource->setSubresourceState(TransitionBarrier.Subresource, TransitionBarrier.StateAfter);
         }
         else
         {
@@ -152,8 +129,7 @@ void GpuResourceStateTracker::resourceBarrier(D3D12_RESOURCE_BARRIER& Barrier)
             GpuResourceState State{};
             State.setSubresourceState(TransitionBarrier.Subresource, TransitionBarrier.StateAfter);
 
-            GpuResourceStateMapEntry Entry = { .mResourceHandle = TransitionBarrier.pResource, .mState = State };
-            mFinalResourceState.push_back(Entry);
+            mFinalResourceState.try_emplace(TransitionBarrier.pResource, State);
         }
     }
     else
@@ -225,22 +201,15 @@ void GpuResourceStateTracker::reset()
 void GpuGlobalResourceState::submitResourceStates(GpuResourceStateTracker& StateTracker)
 {
     const GpuResourceStateMap& FinalResourceStates = StateTracker.getFinalResourceState();
-    for (const auto& State : FinalResourceStates)
+    for (const auto& [Handle, State] : FinalResourceStates)
     {
-        GpuResourceStateMapEntry* KnownResource = GetResourceMapEntry(mKnownStates, State.mResourceHandle);
-        if (KnownResource)
-            *KnownResource = State;
-        else
-        {
-            GpuResourceStateMapEntry NewState = State;
-            mKnownStates.push_back(NewState);
-        }
+        mKnownStates.insert_or_assign(Handle, State);
     }
 }
 
 void GpuGlobalResourceState::addResource(struct GpuResource &Resource, D3D12_RESOURCE_STATES InitialState, UINT SubResource)
 {
-    GpuResourceStateMapEntry* KnownResource = GetResourceMapEntry(mKnownStates, Resource.asHandle());
+    GpuResourceState* KnownResource = GetResourceMapEntry(mKnownStates, Resource.asHandle());
     if (KnownResource)
     {
         // This is a known Resource, we can't override the existing state
@@ -251,9 +220,9 @@ void GpuGlobalResourceState::addResource(struct GpuResource &Resource, D3D12_RES
         }
 
         // Is this one of the subresources? If so, can't override the existing subresource
-        ForRange(u32, i, KnownResource->mState.mSubresourcesCount)
+        ForRange(u32, i, KnownResource->mSubresources.size())
         {
-            GpuSubresourceState& SubresourceState = KnownResource->mState.mSubresources[i];
+            GpuSubresourceState& SubresourceState = KnownResource->mSubresources[i];
             if (SubresourceState.mIndex == SubResource)
             {
                 ct::console::warn("Attempting to add a Resource to the global state map, but Resource exists. Replacing old Resource");
@@ -262,24 +231,20 @@ void GpuGlobalResourceState::addResource(struct GpuResource &Resource, D3D12_RES
         }
 
         // Add the subresource, but not if it exceeds the allowed amount of subresources
-        KnownResource->mState.setSubresourceState(SubResource, InitialState);
+        KnownResource->setSubresourceState(SubResource, InitialState);
     }
     else
     {
         GpuResourceState NewState{};
         NewState.setSubresourceState(SubResource, InitialState);
 
-        GpuResourceStateMapEntry NewEntry = {};
-        NewEntry.mState          = NewState;
-        NewEntry.mResourceHandle = Resource.asHandle();
-
-        mKnownStates.push_back(NewEntry);
+        mKnownStates.try_emplace(Resource.asHandle(), NewState);
     }
 }
 
 void GpuGlobalResourceState::removeResource(const struct GpuResource &Resource)
 {
-    RemoveResourceMapEntry(mKnownStates, Resource.asHandle());
+    mKnownStates.erase(Resource.asHandle());
 }
 
 // flush any pending Resource barriers to the command list
@@ -287,7 +252,8 @@ u32 GpuGlobalResourceState::flushPendingResourceBarriers(struct GpuCommandList &
 {
     const std::vector<D3D12_RESOURCE_BARRIER>& PendingBarriers = StateTracker.getPendingBarriers();
 
-    std::vector<D3D12_RESOURCE_BARRIER> BarriersToSubmit = std::vector<D3D12_RESOURCE_BARRIER>();
+    // Usually only a handful of barriers, which fit without a heap allocation.
+    util::SmallVector<D3D12_RESOURCE_BARRIER, 16> BarriersToSubmit;
     BarriersToSubmit.reserve(PendingBarriers.size());
 
     for (const auto& Barrier : PendingBarriers)
@@ -297,26 +263,26 @@ u32 GpuGlobalResourceState::flushPendingResourceBarriers(struct GpuCommandList &
         const D3D12_RESOURCE_TRANSITION_BARRIER& TransitionBarrier = Barrier.Transition;
 
         // Is this a known Barrier, if so, we know the last used state.
-        GpuResourceStateMapEntry* KnownResource = GetResourceMapEntry(mKnownStates, TransitionBarrier.pResource);
+        GpuResourceState* KnownResource = GetResourceMapEntry(mKnownStates, TransitionBarrier.pResource);
         if (KnownResource)
         { // If this is an updated state and ALL_SUBRESOURCES, then transition all known subresources.
             if (TransitionBarrier.Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
             {
-                if (KnownResource->mState.mSubresourcesCount == 0)
+                if (KnownResource->mSubresources.empty())
                 {
-                    if (KnownResource->mState.mState != TransitionBarrier.StateAfter)
+                    if (KnownResource->mState != TransitionBarrier.StateAfter)
                     {
                         D3D12_RESOURCE_BARRIER NewBarrier = Barrier;
                         NewBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-                        NewBarrier.Transition.StateBefore = KnownResource->mState.mState;
+                        NewBarrier.Transition.StateBefore = KnownResource->mState;
                         BarriersToSubmit.push_back(NewBarrier);
                     }
                 }
                 else
                 {
-                    ForRange(u32, i, KnownResource->mState.mSubresourcesCount)
+                    ForRange(u32, i, KnownResource->mSubresources.size())
                     {
-                        GpuSubresourceState& SubresourceState = KnownResource->mState.mSubresources[i];
+                        GpuSubresourceState& SubresourceState = KnownResource->mSubresources[i];
                         if (SubresourceState.mState != TransitionBarrier.StateAfter)
                         {
                             D3D12_RESOURCE_BARRIER NewBarrier = Barrier;
@@ -330,7 +296,7 @@ u32 GpuGlobalResourceState::flushPendingResourceBarriers(struct GpuCommandList &
             else
             { // Transitioning a specific subresource, add a barrier if it's final state is changing
                 D3D12_RESOURCE_STATES BeforeState =
-                        KnownResource->mState.getSubresourceState(TransitionBarrier.Subresource);
+                        KnownResource->getSubresourceState(TransitionBarrier.Subresource);
                 if (BeforeState != TransitionBarrier.StateAfter)
                 {
                     D3D12_RESOURCE_BARRIER NewBarrier = Barrier;
@@ -340,7 +306,7 @@ u32 GpuGlobalResourceState::flushPendingResourceBarriers(struct GpuCommandList &
             }
 
             // Update the Resource State
-            //KnownResource->mState.setSubresourceState(transitionBarrier.Subresource, transitionBarrier.StateAfter);
+            //KnownResource->setSubresourceState(transitionBarrier.Subresource, transitionBarrier.StateAfter);
         }
         else
         {
@@ -353,8 +319,7 @@ u32 GpuGlobalResourceState::flushPendingResourceBarriers(struct GpuCommandList &
             GpuResourceState State{};
             State.setSubresourceState(TransitionBarrier.Subresource, TransitionBarrier.StateAfter);
 
-            GpuResourceStateMapEntry Entry = { .mResourceHandle = TransitionBarrier.pResource, .mState = State };
-            mKnownStates.push_back(Entry);
+            mKnownStates.try_emplace(TransitionBarrier.pResource, State);
         }
     }
 
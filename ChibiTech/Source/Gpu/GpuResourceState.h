@@ -3,6 +3,9 @@
 
 #include "D3D12Common.h"
 
+#include <Util/FlatHashMap.h>
+#include <Util/SmallVector.h>
+
 #include <vector>
 
 struct GpuSubresourceState
@@ -19,22 +22,16 @@ struct GpuResourceState
     void setSubresourceState(u32 Subresource, D3D12_RESOURCE_STATES State = D3D12_RESOURCE_STATE_COMMON);
     D3D12_RESOURCE_STATES getSubresourceState(u32 Subresource);
 
-    D3D12_RESOURCE_STATES mState                          = D3D12_RESOURCE_STATE_COMMON;
-
-    // TODO(enlynn): Not entirely sure what a reasonable upper bound for subresources would be. For now
-    // going to just declare 10 and see how it goes. If it much more than this, will likely need a Dynamic array.
-    static constexpr u32 cMaxSubresources                 = 10;
-    GpuSubresourceState   mSubresources[cMaxSubresources] = {};
-    u32                   mSubresourcesCount              = 0;
-};
+    D3D12_RESOURCE_STATES mState = D3D12_RESOURCE_STATE_COMMON;
 
-struct GpuResourceStateMapEntry
-{
-    ID3D12Resource*  mResourceHandle{nullptr};
-    GpuResourceState mState{};
+    // Subresources whose state was set individually. Most resources only ever track a few, full mip chains and
+    // texture arrays spill to the heap.
+    static constexpr u32 cInlineSubresources = 8;
+    util::SmallVector<GpuSubresourceState, cInlineSubresources> mSubresources;
 };
 
-using GpuResourceStateMap = std::vector<GpuResourceStateMapEntry>;
+// Known state of each tracked resource, keyed by its handle.
+using GpuResourceStateMap = util::FlatHashMap<ID3D12Resource*, GpuResourceState>;
 
 class GpuResourceStateTracker
 {
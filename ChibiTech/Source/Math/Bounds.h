@@ -0,0 +1,241 @@
+//
+// Bounding volumes
+//
+// aabb    - axis aligned box. Each corner is padded to 4 floats so it loads straight into a SIMD register.
+// bsphere - sphere, center and radius packed into 4 floats.
+//
+// aabb makeAabb(float3 Min, float3 Max)
+// aabb makeAabb(const PointBounds& Bounds)
+// float3 center(const aabb& Box)
+// float3 extents(const aabb& Box)
+// f32 surfaceArea(const aabb& Box)
+// aabb merge(const aabb& Left, const aabb& Right)
+// aabb merge(const aabb& Box, float3 Point)
+// aabb expand(const aabb& Box, f32 Margin)
+// bool overlaps(const aabb& Left, const aabb& Right)
+// bool contains(const aabb& Outer, const aabb& Inner)
+// bool contains(const aabb& Box, float3 Point)
+// aabb transformAabb(const mat4& Matrix, const aabb& Box)
+// bool intersectRay(const aabb& Box, float3 Origin, float3 InverseDirection, f32 MaxDistance, f32& HitDistance)
+//
+// bsphere makeBsphere(float3 Center, f32 Radius)
+// bsphere merge(const bsphere& Left, const bsphere& Right)
+// bool overlaps(const bsphere& Left, const bsphere& Right)
+// bool overlaps(const aabb& Box, const bsphere& Sphere)
+// bool contains(const bsphere& Sphere, float3 Point)
+// aabb boundingBox(const bsphere& Sphere)
+// bsphere boundingSphere(const aabb& Box)
+//
+
+#pragma once
+
+#include "Math.h"
+#include "MathBatch.h"
+
+struct aabb
+{
+    float3 Min;
+    f32    Pad0{0.0f};
+    float3 Max;
+    f32    Pad1{0.0f};
+};
+
+struct bsphere
+{
+    float3 Center;
+    f32    Radius;
+};
+
+static_assert(sizeof(aabb) == 8 * sizeof(f32) && sizeof(bsphere) == 4 * sizeof(f32), "Bounding volumes must stay SIMD sized");
+
+namespace bounds_detail {
+    inline simd::f32x4 loadMin(const aabb& Box) { return simd::load(&Box.Min.X); }
+    inline simd::f32x4 loadMax(const aabb& Box) { return simd::load(&Box.Max.X); }
+
+    inline aabb storeAabb(simd::f32x4 Min, simd::f32x4 Max)
+    {
+        aabb Result;
+        simd::store(&Result.Min.X, Min);
+        simd::store(&Result.Max.X, Max);
+        return Result;
+    }
+}
+
+//
+// aabb Functions
+//
+
+inline aabb makeAabb(float3 Min, float3 Max)
+{
+    aabb Result;
+    Result.Min = Min;
+    Result.Max = Max;
+    return Result;
+}
+
+inline aabb makeAabb(const PointBounds& Bounds)
+{
+    return makeAabb(Bounds.Min, Bounds.Max);
+}
+
+inline float3 center(const aabb& Box)
+{
+    return (Box.Min + Box.Max) * 0.5f;
+}
+
+// Half size along each axis
+inline float3 extents(const aabb& Box)
+{
+    return (Box.Max - Box.Min) * 0.5f;
+}
+
+inline f32 surfaceArea(const aabb& Box)
+{
+    const float3 Size = Box.Max - Box.Min;
+    return 2.0f * (Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X);
+}
+
+inline aabb merge(const aabb& Left, const aabb& Right)
+{
+    using namespace bounds_detail;
+    return storeAabb(simd::min(loadMin(Left), loadMin(Right)), simd::max(loadMax(Left), loadMax(Right)));
+}
+
+inline aabb merge(const aabb& Box, float3 Point)
+{
+    using namespace bounds_detail;
+    const simd::f32x4 P = simd::set(Point.X, Point.Y, Point.Z, 0.0f);
+    return storeAabb(simd::min(loadMin(Box), P), simd::max(loadMax(Box), P));
+}
+
+inline aabb expand(const aabb& Box, f32 Margin)
+{
+    using namespace bounds_detail;
+    const simd::f32x4 M = simd::set(Margin, Margin, Margin, 0.0f);
+    return storeAabb(simd::sub(loadMin(Box), M), simd::add(loadMax(Box), M));
+}
+
+// Touching boxes overlap.
+inline bool overlaps(const aabb& Left, const aabb& Right)
+{
+    using namespace bounds_detail;
+    const simd::f32x4 Separated = simd::bitOr(simd::lessThan(loadMax(Left), loadMin(Right)),
+                                              simd::lessThan(loadMax(Right), loadMin(Left)));
+    return (simd::moveMask(Separated) & 0x7) == 0;
+}
+
+inline bool contains(const aabb& Outer, const aabb& Inner)
+{
+    using namespace bounds_detail;
+    const simd::f32x4 Outside = simd::bitOr(simd::lessThan(loadMin(Inner), loadMin(Outer)),
+                                            simd::lessThan(loadMax(Outer), loadMax(Inner)));
+    return (simd::moveMask(Outside) & 0x7) == 0;
+}
+
+inline bool contains(const aabb& Box, float3 Point)
+{
+    using namespace bounds_detail;
+    const simd::f32x4 P       = simd::set(Point.X, Point.Y, Point.Z, 0.0f);
+    const simd::f32x4 Outside = simd::bitOr(simd::lessThan(P, loadMin(Box)), simd::lessThan(loadMax(Box), P));
+    return (simd::moveMask(Outside) & 0x7) == 0;
+}
+
+// Bounds of the transformed box (Arvo's method). Exact for the box, not for whatever the box was bounding.
+inline aabb transformAabb(const mat4& Matrix, const aabb& Box)
+{
+    const float3 Center  = center(Box);
+    const float3 Extents = extents(Box);
+
+    float3 NewCenter, NewExtents;
+    for (int Row = 0; Row < 3; ++Row)
+    {
+        NewCenter.Ptr[Row]  = Matrix.Ptr[3][Row];
+        NewExtents.Ptr[Row] = 0.0f;
+        for (int Col = 0; Col < 3; ++Col)
+        {
+            NewCenter.Ptr[Row]  += Matrix.Ptr[Col][Row] * Center.Ptr[Col];
+            NewExtents.Ptr[Row] += f32Abs(Matrix.Ptr[Col][Row]) * Extents.Ptr[Col];
+        }
+    }
+
+    return makeAabb(NewCenter - NewExtents, NewCenter + NewExtents);
+}
+
+// Slab test. InverseDirection is 1 / Direction per component, precomputed since a ray is usually tested against
+// many boxes. HitDistance is the entry distance, or 0 when Origin is inside the box.
+inline bool intersectRay(const aabb& Box, float3 Origin, float3 InverseDirection, f32 MaxDistance, f32& HitDistance)
+{
+    using namespace bounds_detail;
+
+    const simd::f32x4 O    = simd::set(Origin.X, Origin.Y, Origin.Z, 0.0f);
+    const simd::f32x4 InvD = simd::set(InverseDirection.X, InverseDirection.Y, InverseDirection.Z, 0.0f);
+
+    const simd::f32x4 T0   = simd::mul(simd::sub(loadMin(Box), O), InvD);
+    const simd::f32x4 T1   = simd::mul(simd::sub(loadMax(Box), O), InvD);
+    const simd::f32x4 Near = simd::min(T0, T1);
+    const simd::f32x4 Far  = simd::max(T0, T1);
+
+    // Lane 3 is padding, reduce over XYZ only
+    const f32 Entry = fmaxf(fmaxf(simd::getLane<0>(Near), simd::getLane<1>(Near)), fmaxf(simd::getLane<2>(Near), 0.0f));
+    const f32 Exit  = fminf(fminf(simd::getLane<0>(Far), simd::getLane<1>(Far)), fminf(simd::getLane<2>(Far), MaxDistance));
+
+    HitDistance = Entry;
+    return Entry <= Exit;
+}
+
+//
+// bsphere Functions
+//
+
+inline bsphere makeBsphere(float3 Center, f32 Radius)
+{
+    return { Center, Radius };
+}
+
+// Smallest sphere enclosing both spheres.
+inline bsphere merge(const bsphere& Left, const bsphere& Right)
+{
+    const float3 Offset   = Right.Center - Left.Center;
+    const f32    Distance = Offset.length();
+
+    if (Distance + Right.Radius <= Left.Radius) return Left;
+    if (Distance + Left.Radius <= Right.Radius) return Right;
+
+    const f32 Radius = (Distance + Left.Radius + Right.Radius) * 0.5f;
+    return { Left.Center + Offset * ((Radius - Left.Radius) / Distance), Radius };
+}
+
+inline bool overlaps(const bsphere& Left, const bsphere& Right)
+{
+    const f32 Radius = Left.Radius + Right.Radius;
+    return (Right.Center - Left.Center).lengthSq() <= Radius * Radius;
+}
+
+inline bool overlaps(const aabb& Box, const bsphere& Sphere)
+{
+    using namespace bounds_detail;
+
+    // Distance from the center to the closest point in the box
+    const simd::f32x4 C     = simd::load(&Sphere.Center.X);
+    const simd::f32x4 Delta = simd::sub(simd::max(simd::min(C, loadMax(Box)), loadMin(Box)), C);
+    const simd::f32x4 Sq    = simd::mul(Delta, Delta);
+
+    const f32 DistanceSq = simd::getLane<0>(Sq) + simd::getLane<1>(Sq) + simd::getLane<2>(Sq);
+    return DistanceSq <= Sphere.Radius * Sphere.Radius;
+}
+
+inline bool contains(const bsphere& Sphere, float3 Point)
+{
+    return (Point - Sphere.Center).lengthSq() <= Sphere.Radius * Sphere.Radius;
+}
+
+inline aabb boundingBox(const bsphere& Sphere)
+{
+    const float3 R = { Sphere.Radius, Sphere.Radius, Sphere.Radius };
+    return makeAabb(Sphere.Center - R, Sphere.Center + R);
+}
+
+inline bsphere boundingSphere(const aabb& Box)
+{
+    return { center(Box), extents(Box).length() };
+}
@@ -0,0 +1,216 @@
+//
+// Fast approximations of the libm functions, for hot paths that don't need full precision.
+//
+// Accuracy tiers, pick the cheapest one the call site can tolerate:
+//   Full precision - sqrtf/sinf/... and the Math.h functions built on them (float3::norm, perspectiveMatrixRh).
+//   ct::fast       - refined estimates and short polynomials. Errors below are the measured worst case over the
+//                    stated domain, "rel" is relative error and "abs" is absolute error.
+//   ct::fast::*Estimate - the raw hardware estimate, no refinement. About 12 bits.
+//
+//   Function      | Domain                  | Max error
+//   --------------+-------------------------+-------------------------------------------------
+//   rsqrtEstimate | x > 0                   | 3.3e-4 rel (scalar backend: 4.7e-6)
+//   rcpEstimate   | x != 0                  | 3.0e-4 rel (scalar backend: exact)
+//   rsqrt         | x > 0                   | 2.5e-7 rel
+//   rcp           | x != 0                  | 2.0e-7 rel
+//   sin, cos      | |x| <= 8192             | 2.9e-7 abs (|x| <= 2pi: 2.2e-7 abs)
+//   exp           | [-87, 88], saturates    | 2.6e-7 rel
+//   log           | positive normal floats  | 1.4e-7 * max(1, |ln x|) abs
+//
+// Every function has a scalar, simd::f32x4 and (with AVX) simd::f32x8 overload. The scalar versions share the
+// polynomial code with the vector ones, so a scalar and a SIMD call produce the same bits on a given backend. The
+// estimates come from the hardware though, so results differ slightly between SSE, NEON and the scalar backend.
+// With CT_MATH_DETERMINISTIC the estimates are exact divides and every backend produces the same bits.
+//
+
+#pragma once
+
+#include "Math.h"
+
+namespace ct::fast {
+    namespace detail {
+        // Scalar stand-ins for the simd:: primitives, so that one template covers every lane width. Calls on
+        // simd types resolve to the simd:: functions through ADL.
+        inline f32 add(f32 tLeft, f32 tRight) { return tLeft + tRight; }
+        inline f32 sub(f32 tLeft, f32 tRight) { return tLeft - tRight; }
+        inline f32 mul(f32 tLeft, f32 tRight) { return tLeft * tRight; }
+        inline f32 div(f32 tLeft, f32 tRight) { return tLeft / tRight; }
+        inline f32 min(f32 tLeft, f32 tRight) { return tLeft < tRight ? tLeft : tRight; }
+        inline f32 max(f32 tLeft, f32 tRight) { return tLeft > tRight ? tLeft : tRight; }
+
+        inline f32 rsqrtEstimate(f32 tValue) { return simd::getLane<0>(simd::rsqrtEstimate(simd::splat(tValue))); }
+        inline f32 rcpEstimate(f32 tValue)   { return simd::getLane<0>(simd::rcpEstimate(simd::splat(tValue))); }
+        inline f32 roundNearest(f32 tValue)  { return std::nearbyint(tValue); }
+
+        inline f32 exp2Integer(f32 tExponent)
+        {
+            return std::bit_cast<f32>(u32((s32)tExponent + 127) << 23);
+        }
+
+        inline f32 splitExponent(f32 tValue, f32& tExponent)
+        {
+            const u32 bits = std::bit_cast<u32>(tValue);
+            tExponent = f32(s32(bits >> 23) - 127);
+            return std::bit_cast<f32>((bits & 0x007fffffu) | 0x3f800000u);
+        }
+
+        // Broadcasts a constant to the lane width of the first argument.
+        inline f32         splatLike(f32, f32 tValue)         { return tValue; }
+        inline simd::f32x4 splatLike(simd::f32x4, f32 tValue) { return simd::splat(tValue); }
+#if CT_MATH_SIMD_AVX
+        inline simd::f32x8 splatLike(simd::f32x8, f32 tValue) { return simd::splat8(tValue); }
+#endif
+
+        constexpr f32 cInvTwoPi   = 0.159154943091895335f;
+        constexpr f32 cTwoPiHi    = 6.28125f;                 // Few mantissa bits, so k * cTwoPiHi is exact
+        constexpr f32 cTwoPiLo    = 0.0019353071795864769f;   // 2pi - cTwoPiHi
+        constexpr f32 cPi         = 3.14159265358979323846f;
+        constexpr f32 cHalfPiHi   = 1.5703125f;
+        constexpr f32 cHalfPiLo   = 4.8382679489661923e-4f;   // pi/2 - cHalfPiHi
+        constexpr f32 cLog2E      = 1.44269504088896341f;
+        constexpr f32 cLn2Hi      = 0.693145751953125f;
+        constexpr f32 cLn2Lo      = 1.42860676533018e-6f;
+
+        // One Newton-Raphson step roughly doubles the bits of the estimate.
+        template<typename V>
+        V rsqrt(V tValue)
+        {
+            const V estimate = rsqrtEstimate(tValue);
+            const V halfX    = mul(tValue, splatLike(tValue, 0.5f));
+            return mul(estimate, sub(splatLike(tValue, 1.5f), mul(halfX, mul(estimate, estimate))));
+        }
+
+        template<typename V>
+        V rcp(V tValue)
+        {
+            const V estimate = rcpEstimate(tValue);
+            return mul(estimate, sub(splatLike(tValue, 2.0f), mul(tValue, estimate)));
+        }
+
+        // Taylor series up to x^11, accurate to ~6e-8 on [-pi/2, pi/2]
+        template<typename V>
+        V sinPolynomial(V tValue)
+        {
+            const V x2 = mul(tValue, tValue);
+
+            V result = splatLike(tValue, -2.50521083854417188e-8f);
+            result = add(mul(result, x2), splatLike(tValue,  2.75573192239858907e-6f));
+            result = add(mul(result, x2), splatLike(tValue, -1.98412698412698413e-4f));
+            result = add(mul(result, x2), splatLike(tValue,  8.33333333333333333e-3f));
+            result = add(mul(result, x2), splatLike(tValue, -1.66666666666666667e-1f));
+            result = add(mul(result, x2), splatLike(tValue, 1.0f));
+            return mul(result, tValue);
+        }
+
+        // Reduces to [-pi, pi] with a two-part 2pi so large inputs don't lose all their bits.
+        template<typename V>
+        V reduceAngle(V tValue)
+        {
+            const V k = roundNearest(mul(tValue, splatLike(tValue, cInvTwoPi)));
+            return sub(sub(tValue, mul(k, splatLike(tValue, cTwoPiHi))), mul(k, splatLike(tValue, cTwoPiLo)));
+        }
+
+        template<typename V>
+        V sin(V tValue)
+        {
+            const V r = reduceAngle(tValue);
+
+            // sin(pi - r) == sin(r), folds [-pi, pi] into [-pi/2, pi/2] without a branch or select.
+            const V pi = splatLike(tValue, cPi);
+            return sinPolynomial(max(min(r, sub(pi, r)), sub(sub(splatLike(tValue, 0.0f), pi), r)));
+        }
+
+        template<typename V>
+        V cos(V tValue)
+        {
+            const V r    = reduceAngle(tValue);
+            const V absR = max(r, sub(splatLike(tValue, 0.0f), r));
+
+            // cos(r) == sin(pi/2 - |r|), with pi/2 split so the subtraction stays exact.
+            return sinPolynomial(add(sub(splatLike(tValue, cHalfPiHi), absR), splatLike(tValue, cHalfPiLo)));
+        }
+
+        // e^x = 2^n * e^r with r in [-ln2/2, ln2/2]
+        template<typename V>
+        V exp(V tValue)
+        {
+            const V x = min(max(tValue, splatLike(tValue, -87.0f)), splatLike(tValue, 88.0f));
+            const V n = roundNearest(mul(x, splatLike(tValue, cLog2E)));
+            const V r = sub(sub(x, mul(n, splatLike(tValue, cLn2Hi))), mul(n, splatLike(tValue, cLn2Lo)));
+
+            V result = splatLike(tValue, 1.0f / 720.0f);
+            result = add(mul(result, r), splatLike(tValue, 1.0f / 120.0f));
+            result = add(mul(result, r), splatLike(tValue, 1.0f / 24.0f));
+            result = add(mul(result, r), splatLike(tValue, 1.0f / 6.0f));
+            result = add(mul(result, r), splatLike(tValue, 0.5f));
+            result = add(mul(result, r), splatLike(tValue, 1.0f));
+            result = add(mul(result, r), splatLike(tValue, 1.0f));
+            return mul(result, exp2Integer(n));
+        }
+
+        // ln(x) = e * ln2 + ln(m), ln(m) = 2 * atanh((m - 1) / (m + 1)) with the series in t = (m - 1) / (m + 1)
+        template<typename V>
+        V log(V tValue)
+        {
+            V exponent;
+            const V mantissa = splitExponent(tValue, exponent);
+
+            const V one = splatLike(tValue, 1.0f);
+            const V t   = div(sub(mantissa, one), add(mantissa, one));
+            const V t2  = mul(t, t);
+
+            V series = splatLike(tValue, 2.0f / 13.0f);
+            series = add(mul(series, t2), splatLike(tValue, 2.0f / 11.0f));
+            series = add(mul(series, t2), splatLike(tValue, 2.0f / 9.0f));
+            series = add(mul(series, t2), splatLike(tValue, 2.0f / 7.0f));
+            series = add(mul(series, t2), splatLike(tValue, 2.0f / 5.0f));
+            series = add(mul(series, t2), splatLike(tValue, 2.0f / 3.0f));
+            series = add(mul(series, t2), splatLike(tValue, 2.0f));
+            series = mul(series, t);
+
+            return add(mul(exponent, splatLike(tValue, cLn2Hi)), add(series, mul(exponent, splatLike(tValue, cLn2Lo))));
+        }
+    } // detail
+
+    inline f32 rsqrtEstimate(f32 tValue) { return detail::rsqrtEstimate(tValue); }
+    inline f32 rcpEstimate(f32 tValue)   { return detail::rcpEstimate(tValue); }
+    inline f32 rsqrt(f32 tValue)         { return detail::rsqrt(tValue); }
+    inline f32 rcp(f32 tValue)           { return detail::rcp(tValue); }
+    inline f32 sin(f32 tValue)           { return detail::sin(tValue); }
+    inline f32 cos(f32 tValue)           { return detail::cos(tValue); }
+    inline f32 exp(f32 tValue)           { return detail::exp(tValue); }
+    inline f32 log(f32 tValue)           { return detail::log(tValue); }
+
+    inline void sinCos(f32 tValue, f32& tSin, f32& tCos)
+    {
+        tSin = detail::sin(tValue);
+        tCos = detail::cos(tValue);
+    }
+
+    // float3::norm() using rsqrt. Zero-length vectors are returned unchanged.
+    inline float3 normalize(float3 tVector)
+    {
+        const f32 lengthSq = tVector.lengthSq();
+        return lengthSq > 0.0f ? tVector * rsqrt(lengthSq) : tVector;
+    }
+
+    inline simd::f32x4 rsqrtEstimate(simd::f32x4 tValue) { return simd::rsqrtEstimate(tValue); }
+    inline simd::f32x4 rcpEstimate(simd::f32x4 tValue)   { return simd::rcpEstimate(tValue); }
+    inline simd::f32x4 rsqrt(simd::f32x4 tValue)         { return detail::rsqrt(tValue); }
+    inline simd::f32x4 rcp(simd::f32x4 tValue)           { return detail::rcp(tValue); }
+    inline simd::f32x4 sin(simd::f32x4 tValue)           { return detail::sin(tValue); }
+    inline simd::f32x4 cos(simd::f32x4 tValue)           { return detail::cos(tValue); }
+    inline simd::f32x4 exp(simd::f32x4 tValue)           { return detail::exp(tValue); }
+    inline simd::f32x4 log(simd::f32x4 tValue)           { return detail::log(tValue); }
+
+#if CT_MATH_SIMD_AVX
+    inline simd::f32x8 rsqrtEstimate(simd::f32x8 tValue) { return simd::rsqrtEstimate(tValue); }
+    inline simd::f32x8 rcpEstimate(simd::f32x8 tValue)   { return simd::rcpEstimate(tValue); }
+    inline simd::f32x8 rsqrt(simd::f32x8 tValue)         { return detail::rsqrt(tValue); }
+    inline simd::f32x8 rcp(simd::f32x8 tValue)           { return detail::rcp(tValue); }
+    inline simd::f32x8 sin(simd::f32x8 tValue)           { return detail::sin(tValue); }
+    inline simd::f32x8 cos(simd::f32x8 tValue)           { return detail::cos(tValue); }
+    inline simd::f32x8 exp(simd::f32x8 tValue)           { return detail::exp(tValue); }
+    inline simd::f32x8 log(simd::f32x8 tValue)           { return detail::log(tValue); }
+#endif
+} // ct::fast
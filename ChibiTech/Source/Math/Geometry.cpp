@@ -1,4 +1,5 @@
 #include "Geometry.h"
+#include "FastMath.h"
 
 #include <Platform/Assert.h>
 
@@ -102,8 +103,8 @@ namespace ct {
 #if 1
             f32 v = 1 - (f32)i / (f32)verticalSegments;
             f32 latitude = ( (f32)i * F32_PI / (f32)verticalSegments ) - F32_PIDIV2;
-            f32 dy  = sinf(latitude);
-            f32 dxz = cosf(latitude);
+            f32 dy, dxz;
+            fast::sinCos(latitude, dy, dxz);
 #endif
 
             // Create a single ring of sphere.mVertices at this latitude.
@@ -113,8 +114,8 @@ namespace ct {
                 f32 u = (f32)j / (f32)horizontalSegments;
 
                 f32 longitude = (f32)j * F32_2PI / (f32)horizontalSegments;
-                f32 dx = sinf(longitude);
-                f32 dz = cosf(longitude);
+                f32 dx, dz;
+                fast::sinCos(longitude, dx, dz);
 
                 dx *= dxz;
                 dz *= dxz;
@@ -6,6 +6,26 @@
 //
 // float2, float3, and float4 implements the usual math operators (+ - * /).
 //
+// float4 and mat4 operations are backed by SIMD when the target supports it, see MathSimd.h. The SIMD paths keep
+// the scalar operation order, so results are identical to the scalar backend. invertMat4 is the exception, see its
+// comment for the tolerance.
+//
+// The vector operators and the mat4 builders (translate, scale, rotate, lookAt, perspective, multiply, invert) are
+// constexpr, so fixed transforms can be baked at compile time:
+//
+//     constexpr mat4 cProjection = perspectiveMatrixRh(45.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+//
+// Constant evaluation always takes the scalar path and uses f64 approximations for sqrt/sin/cos/tan, within 1 ulp
+// of the runtime functions. The random, quaternion and fma-based helpers are runtime only.
+//
+// Deterministic mode (CT_MATH_DETERMINISTIC, see the CT_MATH_DETERMINISTIC CMake option) makes results bit-identical
+// across compilers, platforms and SIMD backends:
+//   - The build disables FMA contraction, so a * b + c is always two roundings. f32FusedMultiplyAdd is the only
+//     fused operation, in both modes, and std::fma is correctly rounded everywhere.
+//   - f32Sin/f32Cos/f32Tan/f32Acos use the f64 series below instead of the platform's libm, at runtime too.
+//   - invertMat4 takes the scalar path, and the MathSimd.h estimates become exact divides.
+// sqrt, +, -, * and / are correctly rounded by IEEE 754, so they need no special handling.
+//
 // float2 Additions Functions:
 //
 // float3 Additions Functions:
@@ -20,6 +40,7 @@
 //
 // mat4 mat4MulRH(mat4 Left, mat4 Right);
 // mat4 invertMat4(mat4 Matrix);
+// mat4 invertMat4Scalar(mat4 Matrix);
 // mat4 scaleMatrix(f32 ScaleX, f32 ScaleY, f32 ScaleZ);
 // mat4 transposeMatrix(mat4 InMatrix);
 // float4 mat4TranslatePoint(mat4 Matrix, float4 Point);
@@ -35,6 +56,17 @@
 // Quaternion Math
 //
 // mat4 QuaternionToRotationMatrix(quaternion Quaternion)
+// quaternion mat4ToQuaternion(mat4 Matrix)
+// quaternion operator*(quaternion Left, quaternion Right)
+// quaternion conjugate(quaternion Quaternion)
+// f32 dot(quaternion Left, quaternion Right)
+// float3 rotateVector(quaternion Rotation, float3 Vector)
+// quaternion nlerp(quaternion From, quaternion To, f32 Factor)
+// quaternion slerp(quaternion From, quaternion To, f32 Factor)
+//
+// dualQuaternion makeDualQuaternion(quaternion Rotation, float3 Translation)
+// dualQuaternion mat4ToDualQuaternion(mat4 Matrix)
+// float3 dualQuaternionTransformPoint(dualQuaternion Transform, float3 Point)
 //
 //------------------------------------------
 // More Misc. / Geometric Functions
@@ -63,9 +95,12 @@
 
 #include <Types.h>
 
+#include "MathSimd.h"
+
 #include <cmath>
 #include <limits>
 #include <numbers> // requires c++ 20
+#include <type_traits>
 
 constexpr f32 F32_EPSILON = std::numeric_limits<float>::epsilon() * 0.5f;
 constexpr f32 F32_PI      = std::numbers::pi_v<float>;
@@ -109,21 +144,21 @@ struct float2
         f32 Ptr[2];
     };
 
-    inline f32    length()   const;
-    inline f32    lengthSq() const;
-    inline float2& norm();
+    constexpr f32    length()   const;
+    constexpr f32    lengthSq() const;
+    constexpr float2& norm();
 
-    inline float2& operator+=(float2 Other);
-    inline float2& operator+=(f32   Other);
+    constexpr float2& operator+=(float2 Other);
+    constexpr float2& operator+=(f32   Other);
 
-    inline float2& operator-=(float2 Other);
-    inline float2& operator-=(f32   Other);
+    constexpr float2& operator-=(float2 Other);
+    constexpr float2& operator-=(f32   Other);
 
-    inline float2& operator*=(float2 Other);
-    inline float2& operator*=(f32   Other);
+    constexpr float2& operator*=(float2 Other);
+    constexpr float2& operator*=(f32   Other);
 
-    inline float2& operator/=(float2 Other);
-    inline float2& operator/=(f32   Other);
+    constexpr float2& operator/=(float2 Other);
+    constexpr float2& operator/=(f32   Other);
 };
 
 struct float3
@@ -136,26 +171,26 @@ struct float3
         f32 Ptr[3];
     };
 
-    inline f32     length()   const;
-    inline f32     lengthSq() const;
-    inline float3& norm();
-    inline float3  getNorm() const;
+    constexpr f32     length()   const;
+    constexpr f32     lengthSq() const;
+    constexpr float3& norm();
+    constexpr float3  getNorm() const;
 
-    inline float3& operator+=(float3 Other);
-    inline float3& operator+=(float2 Other);
-    inline float3& operator+=(f32   Other);
+    constexpr float3& operator+=(float3 Other);
+    constexpr float3& operator+=(float2 Other);
+    constexpr float3& operator+=(f32   Other);
 
-    inline float3& operator-=(float3 Other);
-    inline float3& operator-=(float2 Other);
-    inline float3& operator-=(f32   Other);
+    constexpr float3& operator-=(float3 Other);
+    constexpr float3& operator-=(float2 Other);
+    constexpr float3& operator-=(f32   Other);
 
-    inline float3& operator*=(float3 Other);
-    inline float3& operator*=(float2 Other);
-    inline float3& operator*=(f32   Other);
+    constexpr float3& operator*=(float3 Other);
+    constexpr float3& operator*=(float2 Other);
+    constexpr float3& operator*=(f32   Other);
 
-    inline float3& operator/=(float3 Other);
-    inline float3& operator/=(float2 Other);
-    inline float3& operator/=(f32   Other);
+    constexpr float3& operator/=(float3 Other);
+    constexpr float3& operator/=(float2 Other);
+    constexpr float3& operator/=(f32   Other);
 };
 
 struct float4
@@ -169,39 +204,39 @@ struct float4
         f32 Ptr[4];
     };
 
-    inline f32     length()   const;
-    inline f32     lengthSq() const;
-    inline float4& norm();
+    constexpr f32     length()   const;
+    constexpr f32     lengthSq() const;
+    constexpr float4& norm();
 
     // The Per-Component Operators only apply to the maximum width of a vector. For example, if you add a
     // float4 and float2, then only the XY components are added.
 
     // Per Component Add
-    inline float4& operator+=(float4 Other);
-    inline float4& operator+=(float3 Other);
-    inline float4& operator+=(float2 Other);
+    constexpr float4& operator+=(float4 Other);
+    constexpr float4& operator+=(float3 Other);
+    constexpr float4& operator+=(float2 Other);
 
     // Per Component Subtract
-    inline float4& operator-=(float4 Other);
-    inline float4& operator-=(float3 Other);
-    inline float4& operator-=(float2 Other);
+    constexpr float4& operator-=(float4 Other);
+    constexpr float4& operator-=(float3 Other);
+    constexpr float4& operator-=(float2 Other);
 
     // Per Component Multiply
-    inline float4& operator*=(float4 Other);
-    inline float4& operator*=(float3 Other);
-    inline float4& operator*=(float2 Other);
+    constexpr float4& operator*=(float4 Other);
+    constexpr float4& operator*=(float3 Other);
+    constexpr float4& operator*=(float2 Other);
 
     // Divide - this is a little special since this is the one function that can crash a program
     // If a component gets a div-by-zero, the result will be 0.
-    inline float4& operator/=(float4 Other);
-    inline float4& operator/=(float3 Other);
-    inline float4& operator/=(float2 Other);
+    constexpr float4& operator/=(float4 Other);
+    constexpr float4& operator/=(float3 Other);
+    constexpr float4& operator/=(float2 Other);
 
     // The following operators apply to the entire vector.
-    inline float4& operator+=(f32 Other);
-    inline float4& operator-=(f32 Other);
-    inline float4& operator*=(f32 Other);
-    inline float4& operator/=(f32 Other);
+    constexpr float4& operator+=(f32 Other);
+    constexpr float4& operator-=(f32 Other);
+    constexpr float4& operator*=(f32 Other);
+    constexpr float4& operator/=(f32 Other);
 };
 
 struct quaternion
@@ -224,6 +259,15 @@ struct quaternion
     inline quaternion& Norm();
 };
 
+// Rigid transform (rotation + translation) as a pair of quaternions. Real holds the rotation, Dual holds
+// 0.5 * Translation * Real. Unlike matrices, they can be blended without introducing scale or shear, which is what
+// makes them useful for skinning.
+struct dualQuaternion
+{
+    quaternion Real;
+    quaternion Dual;
+};
+
 struct mat4
 {
     union
@@ -232,28 +276,28 @@ struct mat4
         f32 Ptr[4][4];
     };
 
-    mat4() : mat4(1.0f) {}
+    constexpr mat4() : mat4(1.0f) {}
 
-    mat4(f32 Value)
-    {
-        C0 = { Value,    0.0f, 0.0f, 0.0f  };
-        C1 = { 0.0f, Value,    0.0f, 0.0f  };
-        C2 = { 0.0f, 0.0f, Value   , 0.0f  };
-        C3 = { 0.0f, 0.0f, 0.0f, Value     };
-    }
+    // Initialises Ptr, which is the member every constexpr mat4 function reads and writes.
+    constexpr mat4(f32 Value)
+        : Ptr{ { Value, 0.0f,  0.0f,  0.0f  },
+               { 0.0f,  Value, 0.0f,  0.0f  },
+               { 0.0f,  0.0f,  Value, 0.0f  },
+               { 0.0f,  0.0f,  0.0f,  Value } }
+    {}
 };
 
 using vec2 = float2;
 using vec3 = float3;
 using vec4 = float4;
 
-static constexpr float2 cFloat2Zero = { .Ptr = {0, 0       } };
-static constexpr float3 cFloat3Zero = { .Ptr = {0, 0, 0    } };
-static constexpr float4 cfloat4Zero = { .Ptr = {0, 0, 0, 0 } };
+static constexpr float2 cFloat2Zero = { 0.0f, 0.0f };
+static constexpr float3 cFloat3Zero = { 0.0f, 0.0f, 0.0f };
+static constexpr float4 cfloat4Zero = { 0.0f, 0.0f, 0.0f, 0.0f };
 
-static constexpr float2 cFloat2One = { .Ptr = {1, 1       } };
-static constexpr float3 cFloat3One = { .Ptr = {1, 1, 1    } };
-static constexpr float4 cFloat4One = { .Ptr = {1, 1, 1, 1 } };
+static constexpr float2 cFloat2One = { 1.0f, 1.0f };
+static constexpr float3 cFloat3One = { 1.0f, 1.0f, 1.0f };
+static constexpr float4 cFloat4One = { 1.0f, 1.0f, 1.0f, 1.0f };
 
 //
 // Misc. Functions
@@ -269,11 +313,178 @@ inline bool f32IsInf(f32 Value)
     return std::isinf(Value);
 }
 
-inline f32 degreesToRadians(f32 Degrees)
+constexpr f32 degreesToRadians(f32 Degrees)
 {
     return Degrees * (F32_PI / 180.0f);
 }
 
+constexpr f32 f32Abs(f32 Value)
+{
+    return (Value < 0.0f) ? -Value : Value;
+}
+
+// --------------------------------------------------------------------
+// Compile-time sqrt/sin/cos
+//
+// <cmath> isn't constexpr until C++26, so these are used when a constexpr function is evaluated by the compiler.
+// They work in f64, so after rounding to f32 they land within 1 ulp of the runtime functions. At runtime the
+// f32Sqrt/f32Sin/f32Cos/f32Tan/f32Acos wrappers call straight into <cmath>, runtime results are unchanged, unless
+// CT_MATH_DETERMINISTIC is set. Then the runtime uses these series as well, since they are plain IEEE arithmetic and
+// round the same way on every platform, while libm implementations differ in the last bit.
+
+constexpr f64 constexprSqrt(f64 Value)
+{
+    if (!(Value >= 0.0)) return std::numeric_limits<f64>::quiet_NaN();
+    if (Value == 0.0 || Value == std::numeric_limits<f64>::infinity()) return Value;
+
+    // Newton's method from a guess that is >= the root decreases monotonically, stop once it no longer does.
+    f64 Guess = (Value >= 1.0) ? Value : 1.0;
+    while (true)
+    {
+        const f64 Next = 0.5 * (Guess + Value / Guess);
+        if (Next >= Guess) return Guess;
+        Guess = Next;
+    }
+}
+
+// Wraps the angle into [-pi, pi] then evaluates the Taylor series. 12 terms keeps the truncation error below 1e-12
+// over that range.
+//
+// Rounding the turn count through an integer is exact and cheap for the angles that show up in practice, but the cast is
+// undefined once the count leaves the s64 range. Beyond 2^31 turns the angle is instead reduced with an exact fmod by
+// TwoPi, by subtracting TwoPi * 2^k from the largest k down. Each subtraction is exact (both operands are within a
+// factor of two), so the result is the same on every platform. The input must be finite.
+constexpr f64 constexprWrapAngle(f64 Radians)
+{
+    constexpr f64 TwoPi = 2.0 * std::numbers::pi;
+
+    const f64 Turns = Radians / TwoPi;
+    if (Turns > -2147483648.0 && Turns < 2147483648.0)
+    {
+        const f64 Whole = (f64)(s64)(Turns + ((Turns >= 0.0) ? 0.5 : -0.5));
+        return Radians - Whole * TwoPi;
+    }
+
+    const f64 Sign = (Radians < 0.0) ? -1.0 : 1.0;
+    f64 Remainder = Radians * Sign;
+
+    f64 Multiple = TwoPi;
+    while (Multiple * 2.0 <= Remainder) Multiple *= 2.0;
+    while (Multiple >= TwoPi)
+    {
+        if (Remainder >= Multiple) Remainder -= Multiple;
+        Multiple *= 0.5;
+    }
+
+    if (Remainder > std::numbers::pi) Remainder -= TwoPi;
+    return Remainder * Sign;
+}
+
+constexpr f64 constexprSin(f64 Radians)
+{
+    if (!(Radians - Radians == 0.0)) return std::numeric_limits<f64>::quiet_NaN(); // NaN or Inf
+
+    const f64 X  = constexprWrapAngle(Radians);
+    const f64 X2 = X * X;
+
+    f64 Term = X;
+    f64 Sum  = X;
+    for (int N = 1; N < 12; ++N)
+    {
+        Term *= -X2 / f64((2 * N) * (2 * N + 1));
+        Sum  += Term;
+    }
+    return Sum;
+}
+
+constexpr f64 constexprCos(f64 Radians)
+{
+    if (!(Radians - Radians == 0.0)) return std::numeric_limits<f64>::quiet_NaN(); // NaN or Inf
+
+    const f64 X  = constexprWrapAngle(Radians);
+    const f64 X2 = X * X;
+
+    f64 Term = 1.0;
+    f64 Sum  = 1.0;
+    for (int N = 1; N < 12; ++N)
+    {
+        Term *= -X2 / f64((2 * N - 1) * (2 * N));
+        Sum  += Term;
+    }
+    return Sum;
+}
+
+// Two argument halvings bring |x| below tan(pi/16), where 12 terms of the series are plenty.
+constexpr f64 constexprAtan(f64 Value)
+{
+    if (Value != Value) return Value;
+    if (Value < 0.0) return -constexprAtan(-Value);
+    if (Value > 1.0) return std::numbers::pi / 2.0 - constexprAtan(1.0 / Value);
+
+    f64 X = Value;
+    for (int Halving = 0; Halving < 2; ++Halving)
+    {
+        X = X / (1.0 + constexprSqrt(1.0 + X * X));
+    }
+
+    const f64 X2 = X * X;
+
+    f64 Term = X;
+    f64 Sum  = X;
+    for (int N = 1; N < 12; ++N)
+    {
+        Term *= -X2;
+        Sum  += Term / f64(2 * N + 1);
+    }
+    return Sum * 4.0;
+}
+
+constexpr f64 constexprAcos(f64 Value)
+{
+    if (!(Value >= -1.0 && Value <= 1.0)) return std::numeric_limits<f64>::quiet_NaN();
+    if (Value == -1.0) return std::numbers::pi;
+
+    // acos(x) = 2 atan(sqrt((1 - x) / (1 + x)))
+    return 2.0 * constexprAtan(constexprSqrt((1.0 - Value) / (1.0 + Value)));
+}
+
+constexpr f32 f32Sqrt(f32 Value)
+{
+    if (std::is_constant_evaluated()) return (f32)constexprSqrt(Value);
+    return std::sqrt(Value);
+}
+
+#if CT_MATH_DETERMINISTIC
+constexpr f32 f32Sin(f32 Radians)  { return (f32)constexprSin(Radians); }
+constexpr f32 f32Cos(f32 Radians)  { return (f32)constexprCos(Radians); }
+constexpr f32 f32Tan(f32 Radians)  { return (f32)(constexprSin(Radians) / constexprCos(Radians)); }
+constexpr f32 f32Acos(f32 Value)   { return (f32)constexprAcos(Value); }
+#else
+constexpr f32 f32Sin(f32 Radians)
+{
+    if (std::is_constant_evaluated()) return (f32)constexprSin(Radians);
+    return std::sin(Radians);
+}
+
+constexpr f32 f32Cos(f32 Radians)
+{
+    if (std::is_constant_evaluated()) return (f32)constexprCos(Radians);
+    return std::cos(Radians);
+}
+
+constexpr f32 f32Tan(f32 Radians)
+{
+    if (std::is_constant_evaluated()) return (f32)(constexprSin(Radians) / constexprCos(Radians));
+    return std::tan(Radians);
+}
+
+constexpr f32 f32Acos(f32 Value)
+{
+    if (std::is_constant_evaluated()) return (f32)constexprAcos(Value);
+    return std::acos(Value);
+}
+#endif
+
 // --------------------------------------------------------------------
 // NOTE(enlynn): This is a lazy attempt at addressing FP-error
 //
@@ -281,18 +492,19 @@ inline f32 degreesToRadians(f32 Degrees)
 
 // This function is not symmetrical - F32IsEqual(Left, Right) might not always equal f32IsEqual(Right, Left)
 // TODO(enlynn): properly handle floating point error.
-inline bool f32IsEqual(f32 Left, f32 Right)
+constexpr bool f32IsEqual(f32 Left, f32 Right)
 {
-    return std::abs(Left - Right) <= F32_EPSILON * std::abs(Left);
+    return f32Abs(Left - Right) <= F32_EPSILON * f32Abs(Left);
 }
 
-inline bool f32IsZero(f32 Value)
+constexpr bool f32IsZero(f32 Value)
 {
     return f32IsEqual(Value, 0.0f);
 }
 
 // --------------------------------------------------------------------
 
+// A * B + C with a single rounding. std::fma is exact on every platform, in software where the CPU has no FMA.
 inline f32 f32FusedMultiplyAdd(f32 A, f32 B, f32 C)
 { // A * B + C
     return std::fma(A, B, C);
@@ -307,63 +519,63 @@ inline f32 lerp(f32 Min, f32 Max, f32 Factor)
 // Boilerplate Math Operator Overloads: float2
 //
 
-inline float2& float2::operator+=(float2 Other)
+constexpr float2& float2::operator+=(float2 Other)
 {
     X += Other.X;
     Y += Other.Y;
     return *this;
 }
 
-inline float2& float2::operator+=(f32 Other)
+constexpr float2& float2::operator+=(f32 Other)
 {
     X += Other;
     Y += Other;
     return *this;
 }
 
-inline float2& float2::operator-=(float2 Other)
+constexpr float2& float2::operator-=(float2 Other)
 {
     X -= Other.X;
     Y -= Other.Y;
     return *this;
 }
 
-inline float2& float2::operator-=(f32 Other)
+constexpr float2& float2::operator-=(f32 Other)
 {
     X -= Other;
     Y -= Other;
     return *this;
 }
 
-inline float2& float2::operator*=(float2 Other)
+constexpr float2& float2::operator*=(float2 Other)
 {
     X *= Other.X;
     Y *= Other.Y;
     return *this;
 }
 
-inline float2& float2::operator*=(f32 Other)
+constexpr float2& float2::operator*=(f32 Other)
 {
     X *= Other;
     Y *= Other;
     return *this;
 }
 
-inline float2& float2::operator/=(float2 Other)
+constexpr float2& float2::operator/=(float2 Other)
 {
     X = f32IsZero(Other.X) ? 0.0f : X / Other.X;
     Y = f32IsZero(Other.Y) ? 0.0f : Y / Other.Y;
     return *this;
 }
 
-inline float2& float2::operator/=(f32 Other)
+constexpr float2& float2::operator/=(f32 Other)
 {
     X = f32IsZero(Other) ? 0.0f : X / Other;
     Y = f32IsZero(Other) ? 0.0f : Y / Other;
     return *this;
 }
 
-inline float2 operator+(float2 Left, float2 Right)
+constexpr float2 operator+(float2 Left, float2 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = Left.X + Right.X;
@@ -371,7 +583,7 @@ inline float2 operator+(float2 Left, float2 Right)
     return Result;
 }
 
-inline float2 operator+(float2 Left, f32 Right)
+constexpr float2 operator+(float2 Left, f32 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = Left.X + Right;
@@ -379,7 +591,7 @@ inline float2 operator+(float2 Left, f32 Right)
     return Result;
 }
 
-inline float2 operator-(float2 Left, float2 Right)
+constexpr float2 operator-(float2 Left, float2 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = Left.X - Right.X;
@@ -387,7 +599,7 @@ inline float2 operator-(float2 Left, float2 Right)
     return Result;
 }
 
-inline float2 operator-(float2 Left, f32 Right)
+constexpr float2 operator-(float2 Left, f32 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = Left.X - Right;
@@ -395,7 +607,7 @@ inline float2 operator-(float2 Left, f32 Right)
     return Result;
 }
 
-inline float2 operator*(float2 Left, float2 Right)
+constexpr float2 operator*(float2 Left, float2 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = Left.X * Right.X;
@@ -403,7 +615,7 @@ inline float2 operator*(float2 Left, float2 Right)
     return Result;
 }
 
-inline float2 operator*(float2 Left, f32 Right)
+constexpr float2 operator*(float2 Left, f32 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = Left.X * Right;
@@ -411,7 +623,7 @@ inline float2 operator*(float2 Left, f32 Right)
     return Result;
 }
 
-inline float2 operator/(float2 Left, float2 Right)
+constexpr float2 operator/(float2 Left, float2 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = f32IsZero(Right.X) ? 0.0f : Left.X / Right.X;
@@ -419,7 +631,7 @@ inline float2 operator/(float2 Left, float2 Right)
     return Result;
 }
 
-inline float2 operator/(float2 Left, f32 Right)
+constexpr float2 operator/(float2 Left, f32 Right)
 {
     float2 Result = cFloat2Zero;
     Result.X = f32IsZero(Right) ? 0.0f : Left.X / Right;
@@ -427,10 +639,10 @@ inline float2 operator/(float2 Left, f32 Right)
     return Result;
 }
 
-inline f32 float2::length() const   { return sqrt(X * X + Y * Y); }
-inline f32 float2::lengthSq() const { return X * X + Y * Y;          }
+constexpr f32 float2::length() const   { return f32Sqrt(X * X + Y * Y); }
+constexpr f32 float2::lengthSq() const { return X * X + Y * Y;          }
 
-inline float2& float2::norm()
+constexpr float2& float2::norm()
 {
     f32 Len = length();
     if (!f32IsZero(Len))
@@ -441,7 +653,7 @@ inline float2& float2::norm()
     return *this;
 }
 
-inline f32 Dot(float2 Left, float2 Right)
+constexpr f32 Dot(float2 Left, float2 Right)
 {
     return Left.X * Right.X + Left.Y * Right.Y;
 }
@@ -450,7 +662,7 @@ inline f32 Dot(float2 Left, float2 Right)
 // Boilerplate Math Operator Overloads: float3
 
 
-inline float3& float3::operator+=(float3 Other)
+constexpr float3& float3::operator+=(float3 Other)
 {
     X += Other.X;
     Y += Other.Y;
@@ -458,14 +670,14 @@ inline float3& float3::operator+=(float3 Other)
     return *this;
 }
 
-inline float3& float3::operator+=(float2 Other)
+constexpr float3& float3::operator+=(float2 Other)
 {
     X += Other.X;
     Y += Other.Y;
     return *this;
 }
 
-inline float3& float3::operator+=(f32 Other)
+constexpr float3& float3::operator+=(f32 Other)
 {
     X += Other;
     Y += Other;
@@ -473,7 +685,7 @@ inline float3& float3::operator+=(f32 Other)
     return *this;
 }
 
-inline float3& float3::operator-=(float3 Other)
+constexpr float3& float3::operator-=(float3 Other)
 {
     X -= Other.X;
     Y -= Other.Y;
@@ -481,14 +693,14 @@ inline float3& float3::operator-=(float3 Other)
     return *this;
 }
 
-inline float3& float3::operator-=(float2 Other)
+constexpr float3& float3::operator-=(float2 Other)
 {
     X -= Other.X;
     Y -= Other.Y;
     return *this;
 }
 
-inline float3& float3::operator-=(f32   Other)
+constexpr float3& float3::operator-=(f32   Other)
 {
     X -= Other;
     Y -= Other;
@@ -496,7 +708,7 @@ inline float3& float3::operator-=(f32   Other)
     return *this;
 }
 
-inline float3& float3::operator*=(float3 Other)
+constexpr float3& float3::operator*=(float3 Other)
 {
     X *= Other.X;
     Y *= Other.Y;
@@ -504,14 +716,14 @@ inline float3& float3::operator*=(float3 Other)
     return *this;
 }
 
-inline float3& float3::operator*=(float2 Other)
+constexpr float3& float3::operator*=(float2 Other)
 {
     X *= Other.X;
     Y *= Other.Y;
     return *this;
 }
 
-inline float3& float3::operator*=(f32 Other)
+constexpr float3& float3::operator*=(f32 Other)
 {
     X *= Other;
     Y *= Other;
@@ -519,7 +731,7 @@ inline float3& float3::operator*=(f32 Other)
     return *this;
 }
 
-inline float3& float3::operator/=(float3 Other)
+constexpr float3& float3::operator/=(float3 Other)
 {
     X = f32IsZero(Other.X) ? 0.0f : X / Other.X;
     Y = f32IsZero(Other.Y) ? 0.0f : Y / Other.Y;
@@ -527,14 +739,14 @@ inline float3& float3::operator/=(float3 Other)
     return *this;
 }
 
-inline float3& float3::operator/=(float2 Other)
+constexpr float3& float3::operator/=(float2 Other)
 {
     X = f32IsZero(Other.X) ? 0.0f : X / Other.X;
     Y = f32IsZero(Other.Y) ? 0.0f : Y / Other.Y;
     return *this;
 }
 
-inline float3& float3::operator/=(f32 Other)
+constexpr float3& float3::operator/=(f32 Other)
 {
     X = f32IsZero(Other) ? 0.0f : X / Other;
     Y = f32IsZero(Other) ? 0.0f : Y / Other;
@@ -542,7 +754,7 @@ inline float3& float3::operator/=(f32 Other)
     return *this;
 }
 
-inline float3 operator+(float3 Left, float3 Right)
+constexpr float3 operator+(float3 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X + Right.X;
@@ -551,7 +763,7 @@ inline float3 operator+(float3 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator+(float3 Left, float2 Right)
+constexpr float3 operator+(float3 Left, float2 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X + Right.X;
@@ -559,7 +771,7 @@ inline float3 operator+(float3 Left, float2 Right)
     return Result;
 }
 
-inline float3 operator+(float2 Left, float3 Right)
+constexpr float3 operator+(float2 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X + Right.X;
@@ -567,7 +779,7 @@ inline float3 operator+(float2 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator+(float3 Left, f32 Right)
+constexpr float3 operator+(float3 Left, f32 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X + Right;
@@ -576,7 +788,7 @@ inline float3 operator+(float3 Left, f32 Right)
     return Result;
 }
 
-inline float3 operator+(f32 Left, float3 Right)
+constexpr float3 operator+(f32 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left + Right.X;
@@ -586,7 +798,7 @@ inline float3 operator+(f32 Left, float3 Right)
 }
 
 // Subtract
-inline float3 operator-(float3 Left, float3 Right)
+constexpr float3 operator-(float3 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X - Right.X;
@@ -595,7 +807,7 @@ inline float3 operator-(float3 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator-(float3 Left, float2 Right)
+constexpr float3 operator-(float3 Left, float2 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X - Right.X;
@@ -603,7 +815,7 @@ inline float3 operator-(float3 Left, float2 Right)
     return Result;
 }
 
-inline float3 operator-(float2 Left, float3 Right)
+constexpr float3 operator-(float2 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X - Right.X;
@@ -611,7 +823,7 @@ inline float3 operator-(float2 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator-(float3 Left, f32 Right)
+constexpr float3 operator-(float3 Left, f32 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X - Right;
@@ -620,7 +832,7 @@ inline float3 operator-(float3 Left, f32 Right)
     return Result;
 }
 
-inline float3 operator-(f32 Left, float3 Right)
+constexpr float3 operator-(f32 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left - Right.X;
@@ -630,7 +842,7 @@ inline float3 operator-(f32 Left, float3 Right)
 }
 
 // Multiply
-inline float3 operator*(float3 Left, float3 Right)
+constexpr float3 operator*(float3 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X * Right.X;
@@ -639,7 +851,7 @@ inline float3 operator*(float3 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator*(float3 Left, float2 Right)
+constexpr float3 operator*(float3 Left, float2 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X * Right.X;
@@ -647,7 +859,7 @@ inline float3 operator*(float3 Left, float2 Right)
     return Result;
 }
 
-inline float3 operator*(float2 Left, float3 Right)
+constexpr float3 operator*(float2 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X * Right.X;
@@ -655,7 +867,7 @@ inline float3 operator*(float2 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator*(float3 Left, f32 Right)
+constexpr float3 operator*(float3 Left, f32 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left.X * Right;
@@ -664,7 +876,7 @@ inline float3 operator*(float3 Left, f32 Right)
     return Result;
 }
 
-inline float3 operator*(f32 Left, float3 Right)
+constexpr float3 operator*(f32 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = Left * Right.X;
@@ -674,7 +886,7 @@ inline float3 operator*(f32 Left, float3 Right)
 }
 
 // Divide
-inline float3 operator/(float3 Left, float3 Right)
+constexpr float3 operator/(float3 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = f32IsZero(Right.X) ? 0.0f : Left.X / Right.X;
@@ -683,7 +895,7 @@ inline float3 operator/(float3 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator/(float3 Left, float2 Right)
+constexpr float3 operator/(float3 Left, float2 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = f32IsZero(Right.X) ? 0.0f : Left.X / Right.X;
@@ -691,7 +903,7 @@ inline float3 operator/(float3 Left, float2 Right)
     return Result;
 }
 
-inline float3 operator/(float2 Left, float3 Right)
+constexpr float3 operator/(float2 Left, float3 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = f32IsZero(Right.X) ? 0.0f : Left.X / Right.X;
@@ -699,7 +911,7 @@ inline float3 operator/(float2 Left, float3 Right)
     return Result;
 }
 
-inline float3 operator/(float3 Left, f32 Right)
+constexpr float3 operator/(float3 Left, f32 Right)
 {
     float3 Result = cFloat3Zero;
     Result.X = f32IsZero(Right) ? 0.0f : Left.X / Right;
@@ -708,10 +920,10 @@ inline float3 operator/(float3 Left, f32 Right)
     return Result;
 }
 
-inline f32 float3::length()   const { return sqrt(X * X + Y * Y + Z * Z); }
-inline f32 float3::lengthSq() const { return X * X + Y * Y + Z * Z;          }
+constexpr f32 float3::length()   const { return f32Sqrt(X * X + Y * Y + Z * Z); }
+constexpr f32 float3::lengthSq() const { return X * X + Y * Y + Z * Z;          }
 
-inline float3& float3::norm()
+constexpr float3& float3::norm()
 {
     f32 Len = length();
     if (!f32IsZero(Len))
@@ -723,7 +935,7 @@ inline float3& float3::norm()
     return *this;
 }
 
-inline float3 float3::getNorm() const {
+constexpr float3 float3::getNorm() const {
     f32 Len = length();
     if (!f32IsZero(Len))
     {
@@ -736,7 +948,7 @@ inline float3 float3::getNorm() const {
     return *this;
 }
 
-inline f32 dot(float3 Left, float3 Right)
+constexpr f32 dot(float3 Left, float3 Right)
 {
     return Left.X * Right.X + Left.Y * Right.Y + Left.Z * Right.Z;
 }
@@ -746,7 +958,7 @@ inline f32 dot(float3 Left, float3 Right)
 //
 //
 
-inline float3 cross(float3 Left, float3 Right)
+constexpr float3 cross(float3 Left, float3 Right)
 {
     float3 Result;
 
@@ -762,16 +974,22 @@ inline float3 cross(float3 Left, float3 Right)
 //
 
 // Per component add-equals
-inline float4& float4::operator+=(float4 Other)
+constexpr float4& float4::operator+=(float4 Other)
 {
-    X += Other.X;
-    Y += Other.Y;
-    Z += Other.Z;
-    W += Other.W;
+    if (std::is_constant_evaluated())
+    {
+        X += Other.X;
+        Y += Other.Y;
+        Z += Other.Z;
+        W += Other.W;
+        return *this;
+    }
+
+    simd::store(Ptr, simd::add(simd::load(Ptr), simd::load(Other.Ptr)));
     return *this;
 }
 
-inline float4& float4::operator+=(float3 Other)
+constexpr float4& float4::operator+=(float3 Other)
 {
     X += Other.X;
     Y += Other.Y;
@@ -779,7 +997,7 @@ inline float4& float4::operator+=(float3 Other)
     return *this;
 }
 
-inline float4& float4::operator+=(float2 Other)
+constexpr float4& float4::operator+=(float2 Other)
 {
     X += Other.X;
     Y += Other.Y;
@@ -787,16 +1005,22 @@ inline float4& float4::operator+=(float2 Other)
 }
 
 // Per Component Subtract-equals
-inline float4& float4::operator-=(float4 Other)
+constexpr float4& float4::operator-=(float4 Other)
 {
-    X -= Other.X;
-    Y -= Other.Y;
-    Z -= Other.Z;
-    W -= Other.W;
+    if (std::is_constant_evaluated())
+    {
+        X -= Other.X;
+        Y -= Other.Y;
+        Z -= Other.Z;
+        W -= Other.W;
+        return *this;
+    }
+
+    simd::store(Ptr, simd::sub(simd::load(Ptr), simd::load(Other.Ptr)));
     return *this;
 }
 
-inline float4& float4::operator-=(float3 Other)
+constexpr float4& float4::operator-=(float3 Other)
 {
     X -= Other.X;
     Y -= Other.Y;
@@ -804,7 +1028,7 @@ inline float4& float4::operator-=(float3 Other)
     return *this;
 }
 
-inline float4& float4::operator-=(float2 Other)
+constexpr float4& float4::operator-=(float2 Other)
 {
     X -= Other.X;
     Y -= Other.Y;
@@ -812,16 +1036,22 @@ inline float4& float4::operator-=(float2 Other)
 }
 
 // Per Component Multiply-equals
-inline float4& float4::operator*=(float4 Other)
+constexpr float4& float4::operator*=(float4 Other)
 {
-    X *= Other.X;
-    Y *= Other.Y;
-    Z *= Other.Z;
-    W *= Other.W;
+    if (std::is_constant_evaluated())
+    {
+        X *= Other.X;
+        Y *= Other.Y;
+        Z *= Other.Z;
+        W *= Other.W;
+        return *this;
+    }
+
+    simd::store(Ptr, simd::mul(simd::load(Ptr), simd::load(Other.Ptr)));
     return *this;
 }
 
-inline float4& float4::operator*=(float3 Other)
+constexpr float4& float4::operator*=(float3 Other)
 {
     X *= Other.X;
     Y *= Other.Y;
@@ -829,7 +1059,7 @@ inline float4& float4::operator*=(float3 Other)
     return *this;
 }
 
-inline float4& float4::operator*=(float2 Other)
+constexpr float4& float4::operator*=(float2 Other)
 {
     X *= Other.X;
     Y *= Other.Y;
@@ -837,74 +1067,97 @@ inline float4& float4::operator*=(float2 Other)
 }
 
 // Per Component Multiply-equals
-inline float4& float4::operator/=(float4 Other)
+constexpr float4& float4::operator/=(float4 Other)
 {
     X = (f32IsZero(Other.X)) ? 0.0f : X / Other.X;
     Y = (f32IsZero(Other.Y)) ? 0.0f : Y / Other.Y;
     Z = (f32IsZero(Other.Z)) ? 0.0f : Z / Other.Z;
     W = (f32IsZero(Other.W)) ? 0.0f : W / Other.W;
+    return *this;
 }
 
-inline float4& float4::operator/=(float3 Other)
+constexpr float4& float4::operator/=(float3 Other)
 {
     X = (f32IsZero(Other.X)) ? 0.0f : X / Other.X;
     Y = (f32IsZero(Other.Y)) ? 0.0f : Y / Other.Y;
     Z = (f32IsZero(Other.Z)) ? 0.0f : Z / Other.Z;
+    return *this;
 }
 
-inline float4& float4::operator/=(float2 Other)
+constexpr float4& float4::operator/=(float2 Other)
 {
     X = (f32IsZero(Other.X)) ? 0.0f : X / Other.X;
     Y = (f32IsZero(Other.Y)) ? 0.0f : Y / Other.Y;
+    return *this;
 }
 
 // The following operators apply to the entire vector.
-inline float4& float4::operator+=(f32 Other)
+constexpr float4& float4::operator+=(f32 Other)
 {
-    X += Other;
-    Y += Other;
-    Z += Other;
-    W += Other;
+    if (std::is_constant_evaluated())
+    {
+        X += Other;
+        Y += Other;
+        Z += Other;
+        W += Other;
+        return *this;
+    }
+
+    simd::store(Ptr, simd::add(simd::load(Ptr), simd::splat(Other)));
+    return *this;
 }
 
-inline float4& float4::operator-=(f32 Other)
+constexpr float4& float4::operator-=(f32 Other)
 {
-    X -= Other;
-    Y -= Other;
-    Z -= Other;
-    W -= Other;
+    if (std::is_constant_evaluated())
+    {
+        X -= Other;
+        Y -= Other;
+        Z -= Other;
+        W -= Other;
+        return *this;
+    }
+
+    simd::store(Ptr, simd::sub(simd::load(Ptr), simd::splat(Other)));
+    return *this;
 }
 
-inline float4& float4::operator*=(f32 Other)
+constexpr float4& float4::operator*=(f32 Other)
 {
-    X *= Other;
-    Y *= Other;
-    Z *= Other;
-    W *= Other;
+    if (std::is_constant_evaluated())
+    {
+        X *= Other;
+        Y *= Other;
+        Z *= Other;
+        W *= Other;
+        return *this;
+    }
+
+    simd::store(Ptr, simd::mul(simd::load(Ptr), simd::splat(Other)));
+    return *this;
 }
 
-inline float4& float4::operator/=(f32 Other)
+constexpr float4& float4::operator/=(f32 Other)
 {
     X = (f32IsZero(Other)) ? 0.0f : X / Other;
     Y = (f32IsZero(Other)) ? 0.0f : Y / Other;
     Z = (f32IsZero(Other)) ? 0.0f : Z / Other;
     W = (f32IsZero(Other)) ? 0.0f : W / Other;
+    return *this;
 }
 
 // Add Operator
-inline float4 operator+(float4 Left, float4 Right)
+constexpr float4 operator+(float4 Left, float4 Right)
 {
-    float4 Result = cfloat4Zero;
-
-    Result.X = Left.X + Right.X;
-    Result.Y = Left.Y + Right.Y;
-    Result.Z = Left.Z + Right.Z;
-    Result.W = Left.W + Right.W;
+    if (std::is_constant_evaluated())
+        return { Left.X + Right.X, Left.Y + Right.Y, Left.Z + Right.Z, Left.W + Right.W };
 
+    float4 Result;
+    simd::store(Result.Ptr, simd::add(simd::load(Left.Ptr), simd::load(Right.Ptr)));
     return Result;
 }
 
-inline float4 operator+(float4 Left, float3 Right)
+constexpr float4 operator+(float4 Left, float3 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -915,7 +1168,7 @@ inline float4 operator+(float4 Left, float3 Right)
     return Result;
 }
 
-inline float4 operator+(float3 Left, float4 Right)
+constexpr float4 operator+(float3 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -926,7 +1179,7 @@ inline float4 operator+(float3 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator+(float4 Left, float2 Right)
+constexpr float4 operator+(float4 Left, float2 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -936,7 +1189,7 @@ inline float4 operator+(float4 Left, float2 Right)
     return Result;
 }
 
-inline float4 operator+(float2 Left, float4 Right)
+constexpr float4 operator+(float2 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -946,32 +1199,28 @@ inline float4 operator+(float2 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator+(float4 Left, f32 Right)
+constexpr float4 operator+(float4 Left, f32 Right)
 {
-    float4 Result = cfloat4Zero;
-
-    Result.X = Left.X + Right;
-    Result.Y = Left.Y + Right;
-    Result.Z = Left.Z + Right;
-    Result.W = Left.W + Right;
+    if (std::is_constant_evaluated())
+        return { Left.X + Right, Left.Y + Right, Left.Z + Right, Left.W + Right };
 
+    float4 Result;
+    simd::store(Result.Ptr, simd::add(simd::load(Left.Ptr), simd::splat(Right)));
     return Result;
 }
 
 // Sub Operator
-inline float4 operator-(float4 Left, float4 Right)
+constexpr float4 operator-(float4 Left, float4 Right)
 {
-    float4 Result = cfloat4Zero;
-
-    Result.X = Left.X - Right.X;
-    Result.Y = Left.Y - Right.Y;
-    Result.Z = Left.Z - Right.Z;
-    Result.W = Left.W - Right.W;
+    if (std::is_constant_evaluated())
+        return { Left.X - Right.X, Left.Y - Right.Y, Left.Z - Right.Z, Left.W - Right.W };
 
+    float4 Result;
+    simd::store(Result.Ptr, simd::sub(simd::load(Left.Ptr), simd::load(Right.Ptr)));
     return Result;
 }
 
-inline float4 operator-(float4 Left, float3 Right)
+constexpr float4 operator-(float4 Left, float3 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -982,7 +1231,7 @@ inline float4 operator-(float4 Left, float3 Right)
     return Result;
 }
 
-inline float4 operator-(float3 Left, float4 Right)
+constexpr float4 operator-(float3 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -992,7 +1241,7 @@ inline float4 operator-(float3 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator-(float4 Left, float2 Right)
+constexpr float4 operator-(float4 Left, float2 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1002,7 +1251,7 @@ inline float4 operator-(float4 Left, float2 Right)
     return Result;
 }
 
-inline float4 operator-(float2 Left, float4 Right)
+constexpr float4 operator-(float2 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1012,32 +1261,28 @@ inline float4 operator-(float2 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator-(float4 Left, f32 Right)
+constexpr float4 operator-(float4 Left, f32 Right)
 {
-    float4 Result = cfloat4Zero;
-
-    Result.X = Left.X - Right;
-    Result.Y = Left.Y - Right;
-    Result.Z = Left.Z - Right;
-    Result.W = Left.W - Right;
+    if (std::is_constant_evaluated())
+        return { Left.X - Right, Left.Y - Right, Left.Z - Right, Left.W - Right };
 
+    float4 Result;
+    simd::store(Result.Ptr, simd::sub(simd::load(Left.Ptr), simd::splat(Right)));
     return Result;
 }
 
 // Multiplication Operator
-inline float4 operator*(float4 Left, float4 Right)
+constexpr float4 operator*(float4 Left, float4 Right)
 {
-    float4 Result = cfloat4Zero;
-
-    Result.X = Left.X * Right.X;
-    Result.Y = Left.Y * Right.Y;
-    Result.Z = Left.Z * Right.Z;
-    Result.W = Left.W * Right.W;
+    if (std::is_constant_evaluated())
+        return { Left.X * Right.X, Left.Y * Right.Y, Left.Z * Right.Z, Left.W * Right.W };
 
+    float4 Result;
+    simd::store(Result.Ptr, simd::mul(simd::load(Left.Ptr), simd::load(Right.Ptr)));
     return Result;
 }
 
-inline float4 operator*(float4 Left, float3 Right)
+constexpr float4 operator*(float4 Left, float3 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1048,7 +1293,7 @@ inline float4 operator*(float4 Left, float3 Right)
     return Result;
 }
 
-inline float4 operator*(float3 Left, float4 Right)
+constexpr float4 operator*(float3 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1059,7 +1304,7 @@ inline float4 operator*(float3 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator*(float4 Left, float2 Right)
+constexpr float4 operator*(float4 Left, float2 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1069,7 +1314,7 @@ inline float4 operator*(float4 Left, float2 Right)
     return Result;
 }
 
-inline float4 operator*(float2 Left, float4 Right)
+constexpr float4 operator*(float2 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1079,20 +1324,18 @@ inline float4 operator*(float2 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator*(float4 Left, f32 Right)
+constexpr float4 operator*(float4 Left, f32 Right)
 {
-    float4 Result = cfloat4Zero;
-
-    Result.X = Left.X * Right;
-    Result.Y = Left.Y * Right;
-    Result.Z = Left.Z * Right;
-    Result.W = Left.W * Right;
+    if (std::is_constant_evaluated())
+        return { Left.X * Right, Left.Y * Right, Left.Z * Right, Left.W * Right };
 
+    float4 Result;
+    simd::store(Result.Ptr, simd::mul(simd::load(Left.Ptr), simd::splat(Right)));
     return Result;
 }
 
 // Division Operator
-inline float4 operator/(float4 Left, float4 Right)
+constexpr float4 operator/(float4 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1104,7 +1347,7 @@ inline float4 operator/(float4 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator/(float4 Left, float3 Right)
+constexpr float4 operator/(float4 Left, float3 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1115,7 +1358,7 @@ inline float4 operator/(float4 Left, float3 Right)
     return Result;
 }
 
-inline float4 operator/(float3 Left, float4 Right)
+constexpr float4 operator/(float3 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1126,7 +1369,7 @@ inline float4 operator/(float3 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator/(float4 Left, float2 Right)
+constexpr float4 operator/(float4 Left, float2 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1136,7 +1379,7 @@ inline float4 operator/(float4 Left, float2 Right)
     return Result;
 }
 
-inline float4 operator/(float2 Left, float4 Right)
+constexpr float4 operator/(float2 Left, float4 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1146,7 +1389,7 @@ inline float4 operator/(float2 Left, float4 Right)
     return Result;
 }
 
-inline float4 operator/(float4 Left, f32 Right)
+constexpr float4 operator/(float4 Left, f32 Right)
 {
     float4 Result = cfloat4Zero;
 
@@ -1164,10 +1407,10 @@ inline float4 operator/(float4 Left, f32 Right)
 // f32    dot(float4 Left, float4 Right)
 // float4  cross(float4 Left, float4 Right)
 
-inline f32 float4::length()   const { return sqrt(X * X + Y * Y + Z * Z + W * W); }
-inline f32 float4::lengthSq() const { return X * X + Y * Y + Z * Z + W * W;          }
+constexpr f32 float4::length()   const { return f32Sqrt(X * X + Y * Y + Z * Z + W * W); }
+constexpr f32 float4::lengthSq() const { return X * X + Y * Y + Z * Z + W * W;          }
 
-inline float4& float4::norm()
+constexpr float4& float4::norm()
 {
     f32 Len = length();
     if (!f32IsZero(Len))
@@ -1180,16 +1423,34 @@ inline float4& float4::norm()
     return *this;
 }
 
-inline f32 dot(float4 Left, float4 Right)
+constexpr f32 dot(float4 Left, float4 Right)
 {
-    return Left.X * Right.X + Left.Y * Right.Y + Left.Z * Right.Z + Left.W * Right.W;
+    if (std::is_constant_evaluated())
+        return Left.X * Right.X + Left.Y * Right.Y + Left.Z * Right.Z + Left.W * Right.W;
+
+    return simd::sumInOrder(simd::mul(simd::load(Left.Ptr), simd::load(Right.Ptr)));
 }
 
-inline float4 cross(float4 Left, float4 Right)
+constexpr float4 cross(float4 Left, float4 Right)
 {
+    if (std::is_constant_evaluated())
+    {
+        const float3 Xyz = cross(float3{ Left.X, Left.Y, Left.Z }, float3{ Right.X, Right.Y, Right.Z });
+        return { Xyz.X, Xyz.Y, Xyz.Z, 1.0f };
+    }
+
+    // (Left.yzx * Right.zxy) - (Left.zxy * Right.yzx)
+    const simd::f32x4 l = simd::load(Left.Ptr);
+    const simd::f32x4 r = simd::load(Right.Ptr);
+
+    const simd::f32x4 lYZX = simd::shuffle<1, 2, 0, 3>(l, l);
+    const simd::f32x4 lZXY = simd::shuffle<2, 0, 1, 3>(l, l);
+    const simd::f32x4 rYZX = simd::shuffle<1, 2, 0, 3>(r, r);
+    const simd::f32x4 rZXY = simd::shuffle<2, 0, 1, 3>(r, r);
+
     float4 Result;
-    Result.XYZ = cross(Left.XYZ, Right.XYZ);
-    Result.W   = 1.0f;
+    simd::store(Result.Ptr, simd::sub(simd::mul(lYZX, rZXY), simd::mul(lZXY, rYZX)));
+    Result.W = 1.0f;
     return Result;
 }
 
@@ -1197,8 +1458,56 @@ inline float4 cross(float4 Left, float4 Right)
 // mat4 Functions
 //
 
-inline mat4 mat4MulRH(mat4 Left, mat4 Right)
+// Each result column is a linear combination of Left's columns weighted by the matching column of Right. The
+// products are summed in the same order as the row-dot-column form, so every backend produces identical bits.
+constexpr mat4 mat4MulRH(mat4 Left, mat4 Right)
 {
+#if !CT_MATH_SIMD_SCALAR
+    if (!std::is_constant_evaluated())
+    {
+        mat4 Result;
+
+        const simd::f32x4 l0 = simd::load(Left.C0.Ptr);
+        const simd::f32x4 l1 = simd::load(Left.C1.Ptr);
+        const simd::f32x4 l2 = simd::load(Left.C2.Ptr);
+        const simd::f32x4 l3 = simd::load(Left.C3.Ptr);
+
+#if CT_MATH_SIMD_AVX
+        // Two columns of Right per iteration
+        const simd::f32x8 l00 = simd::broadcast4(l0);
+        const simd::f32x8 l11 = simd::broadcast4(l1);
+        const simd::f32x8 l22 = simd::broadcast4(l2);
+        const simd::f32x8 l33 = simd::broadcast4(l3);
+
+        for (int Col = 0; Col < 4; Col += 2)
+        {
+            const simd::f32x8 r = simd::load8(Right.Ptr[Col]);
+
+            simd::f32x8 Sum = simd::mul(l00, simd::splatLanePerHalf<0>(r));
+            Sum = simd::add(Sum, simd::mul(l11, simd::splatLanePerHalf<1>(r)));
+            Sum = simd::add(Sum, simd::mul(l22, simd::splatLanePerHalf<2>(r)));
+            Sum = simd::add(Sum, simd::mul(l33, simd::splatLanePerHalf<3>(r)));
+
+            simd::store8(Result.Ptr[Col], Sum);
+        }
+#else
+        for (int Col = 0; Col < 4; ++Col)
+        {
+            const simd::f32x4 r = simd::load(Right.Ptr[Col]);
+
+            simd::f32x4 Sum = simd::mul(l0, simd::shuffle<0, 0, 0, 0>(r, r));
+            Sum = simd::add(Sum, simd::mul(l1, simd::shuffle<1, 1, 1, 1>(r, r)));
+            Sum = simd::add(Sum, simd::mul(l2, simd::shuffle<2, 2, 2, 2>(r, r)));
+            Sum = simd::add(Sum, simd::mul(l3, simd::shuffle<3, 3, 3, 3>(r, r)));
+
+            simd::store(Result.Ptr[Col], Sum);
+        }
+#endif
+
+        return Result;
+    }
+#endif
+
     mat4 Result;
 
     float4 lr0 = {Left.Ptr[0][0], Left.Ptr[1][0], Left.Ptr[2][0], Left.Ptr[3][0] };
@@ -1206,31 +1515,37 @@ inline mat4 mat4MulRH(mat4 Left, mat4 Right)
     float4 lr2 = {Left.Ptr[0][2], Left.Ptr[1][2], Left.Ptr[2][2], Left.Ptr[3][2] };
     float4 lr3 = {Left.Ptr[0][3], Left.Ptr[1][3], Left.Ptr[2][3], Left.Ptr[3][3] };
 
-    Result.Ptr[0][0] = dot(lr0, Right.C0);
-    Result.Ptr[0][1] = dot(lr1, Right.C0);
-    Result.Ptr[0][2] = dot(lr2, Right.C0);
-    Result.Ptr[0][3] = dot(lr3, Right.C0);
+    float4 rc0 = {Right.Ptr[0][0], Right.Ptr[0][1], Right.Ptr[0][2], Right.Ptr[0][3] };
+    float4 rc1 = {Right.Ptr[1][0], Right.Ptr[1][1], Right.Ptr[1][2], Right.Ptr[1][3] };
+    float4 rc2 = {Right.Ptr[2][0], Right.Ptr[2][1], Right.Ptr[2][2], Right.Ptr[2][3] };
+    float4 rc3 = {Right.Ptr[3][0], Right.Ptr[3][1], Right.Ptr[3][2], Right.Ptr[3][3] };
+
+    Result.Ptr[0][0] = dot(lr0, rc0);
+    Result.Ptr[0][1] = dot(lr1, rc0);
+    Result.Ptr[0][2] = dot(lr2, rc0);
+    Result.Ptr[0][3] = dot(lr3, rc0);
 
-    Result.Ptr[1][0] = dot(lr0, Right.C1);
-    Result.Ptr[1][1] = dot(lr1, Right.C1);
-    Result.Ptr[1][2] = dot(lr2, Right.C1);
-    Result.Ptr[1][3] = dot(lr3, Right.C1);
+    Result.Ptr[1][0] = dot(lr0, rc1);
+    Result.Ptr[1][1] = dot(lr1, rc1);
+    Result.Ptr[1][2] = dot(lr2, rc1);
+    Result.Ptr[1][3] = dot(lr3, rc1);
 
-    Result.Ptr[2][0] = dot(lr0, Right.C2);
-    Result.Ptr[2][1] = dot(lr1, Right.C2);
-    Result.Ptr[2][2] = dot(lr2, Right.C2);
-    Result.Ptr[2][3] = dot(lr3, Right.C2);
+    Result.Ptr[2][0] = dot(lr0, rc2);
+    Result.Ptr[2][1] = dot(lr1, rc2);
+    Result.Ptr[2][2] = dot(lr2, rc2);
+    Result.Ptr[2][3] = dot(lr3, rc2);
 
-    Result.Ptr[3][0] = dot(lr0, Right.C3);
-    Result.Ptr[3][1] = dot(lr1, Right.C3);
-    Result.Ptr[3][2] = dot(lr2, Right.C3);
-    Result.Ptr[3][3] = dot(lr3, Right.C3);
+    Result.Ptr[3][0] = dot(lr0, rc3);
+    Result.Ptr[3][1] = dot(lr1, rc3);
+    Result.Ptr[3][2] = dot(lr2, rc3);
+    Result.Ptr[3][3] = dot(lr3, rc3);
 
     return Result;
 }
 
+// Reference implementation, also used by the scalar backend.
 // https://gist.github.com/mattatz/86fff4b32d198d0928d0fa4ff32cf6fa
-inline mat4 invertMat4(mat4 Matrix)
+constexpr mat4 invertMat4Scalar(mat4 Matrix)
 {
     float n11 = Matrix.Ptr[0][0], n12 = Matrix.Ptr[1][0], n13 = Matrix.Ptr[2][0], n14 = Matrix.Ptr[3][0];
     float n21 = Matrix.Ptr[0][1], n22 = Matrix.Ptr[1][1], n23 = Matrix.Ptr[2][1], n24 = Matrix.Ptr[3][1];
@@ -1270,8 +1585,78 @@ inline mat4 invertMat4(mat4 Matrix)
     return Result;
 }
 
+// Block-wise 2x2 inverse. The sub-expressions are grouped differently from invertMat4Scalar, so results are not
+// bit-identical. Measure the difference relative to the largest element of the inverse, not per element in ulp:
+// entries near zero can differ by thousands of ulp. On TRS, view and projection matrices both paths stay within
+// 8 * F32_EPSILON of that element (about 5e-7) of the f64 inverse and of each other. `chibi-math-bench --check`
+// enforces 32 * F32_EPSILON. Error grows with the condition number, as it does for any inverse.
+// CT_MATH_DETERMINISTIC always takes the scalar path.
+// See: https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+constexpr mat4 invertMat4(mat4 Matrix)
+{
+#if !CT_MATH_SIMD_SCALAR && !CT_MATH_DETERMINISTIC
+    if (!std::is_constant_evaluated())
+    {
+        using namespace simd;
+
+        // 2x2 matrices are stored as (m00, m01, m10, m11)
+        const auto mat2Mul    = [](f32x4 A, f32x4 B) { return add(mul(A, shuffle<0, 3, 0, 3>(B, B)), mul(shuffle<1, 0, 3, 2>(A, A), shuffle<2, 1, 2, 1>(B, B))); };
+        const auto mat2AdjMul = [](f32x4 A, f32x4 B) { return sub(mul(shuffle<3, 3, 0, 0>(A, A), B), mul(shuffle<1, 1, 2, 2>(A, A), shuffle<2, 3, 0, 1>(B, B))); };
+        const auto mat2MulAdj = [](f32x4 A, f32x4 B) { return sub(mul(A, shuffle<3, 0, 3, 0>(B, B)), mul(shuffle<1, 0, 3, 2>(A, A), shuffle<2, 1, 2, 1>(B, B))); };
+
+        const f32x4 c0 = load(Matrix.C0.Ptr);
+        const f32x4 c1 = load(Matrix.C1.Ptr);
+        const f32x4 c2 = load(Matrix.C2.Ptr);
+        const f32x4 c3 = load(Matrix.C3.Ptr);
+
+        // Sub-matrices of the transpose. inverse(transpose(M)) == transpose(inverse(M)), so working on columns and
+        // writing columns back out gives the inverse of M.
+        const f32x4 A = shuffle<0, 1, 0, 1>(c0, c1);
+        const f32x4 B = shuffle<2, 3, 2, 3>(c0, c1);
+        const f32x4 C = shuffle<0, 1, 0, 1>(c2, c3);
+        const f32x4 D = shuffle<2, 3, 2, 3>(c2, c3);
+
+        // (|A|, |B|, |C|, |D|)
+        const f32x4 detSub = sub(mul(shuffle<0, 2, 0, 2>(c0, c2), shuffle<1, 3, 1, 3>(c1, c3)),
+                                 mul(shuffle<1, 3, 1, 3>(c0, c2), shuffle<0, 2, 0, 2>(c1, c3)));
+        const f32x4 detA = shuffle<0, 0, 0, 0>(detSub, detSub);
+        const f32x4 detB = shuffle<1, 1, 1, 1>(detSub, detSub);
+        const f32x4 detC = shuffle<2, 2, 2, 2>(detSub, detSub);
+        const f32x4 detD = shuffle<3, 3, 3, 3>(detSub, detSub);
+
+        const f32x4 DC = mat2AdjMul(D, C);
+        const f32x4 AB = mat2AdjMul(A, B);
+
+        f32x4 X = sub(mul(detD, A), mat2Mul(B, DC));
+        f32x4 W = sub(mul(detA, D), mat2Mul(C, AB));
+        f32x4 Y = sub(mul(detB, C), mat2MulAdj(D, AB));
+        f32x4 Z = sub(mul(detC, B), mat2MulAdj(A, DC));
+
+        // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+        const f32 trace = sumInOrder(mul(AB, shuffle<0, 2, 1, 3>(DC, DC)));
+        const f32 det   = (getLane<0>(detA) * getLane<0>(detD) + getLane<0>(detB) * getLane<0>(detC)) - trace;
+        const f32 idet  = 1.0f / det;
+
+        const f32x4 adjSign = set(idet, -idet, -idet, idet);
+        X = mul(X, adjSign);
+        Y = mul(Y, adjSign);
+        Z = mul(Z, adjSign);
+        W = mul(W, adjSign);
+
+        mat4 Result;
+        store(Result.C0.Ptr, shuffle<3, 1, 3, 1>(X, Y));
+        store(Result.C1.Ptr, shuffle<2, 0, 2, 0>(X, Y));
+        store(Result.C2.Ptr, shuffle<3, 1, 3, 1>(Z, W));
+        store(Result.C3.Ptr, shuffle<2, 0, 2, 0>(Z, W));
+        return Result;
+    }
+#endif
+
+    return invertMat4Scalar(Matrix);
+}
+
 // Creates a scaling matrix
-inline mat4 scaleMatrix(f32 ScaleX, f32 ScaleY, f32 ScaleZ)
+constexpr mat4 scaleMatrix(f32 ScaleX, f32 ScaleY, f32 ScaleZ)
 {
     mat4 Result = mat4();
 
@@ -1282,8 +1667,30 @@ inline mat4 scaleMatrix(f32 ScaleX, f32 ScaleY, f32 ScaleZ)
     return Result;
 }
 
-inline mat4 transposeMatrix(mat4 InMatrix)
+constexpr mat4 transposeMatrix(mat4 InMatrix)
 {
+#if !CT_MATH_SIMD_SCALAR
+    if (!std::is_constant_evaluated())
+    {
+        const simd::f32x4 c0 = simd::load(InMatrix.C0.Ptr);
+        const simd::f32x4 c1 = simd::load(InMatrix.C1.Ptr);
+        const simd::f32x4 c2 = simd::load(InMatrix.C2.Ptr);
+        const simd::f32x4 c3 = simd::load(InMatrix.C3.Ptr);
+
+        const simd::f32x4 t0 = simd::shuffle<0, 1, 0, 1>(c0, c1); // x0 y0 x1 y1
+        const simd::f32x4 t1 = simd::shuffle<2, 3, 2, 3>(c0, c1); // z0 w0 z1 w1
+        const simd::f32x4 t2 = simd::shuffle<0, 1, 0, 1>(c2, c3); // x2 y2 x3 y3
+        const simd::f32x4 t3 = simd::shuffle<2, 3, 2, 3>(c2, c3); // z2 w2 z3 w3
+
+        mat4 Result;
+        simd::store(Result.C0.Ptr, simd::shuffle<0, 2, 0, 2>(t0, t2));
+        simd::store(Result.C1.Ptr, simd::shuffle<1, 3, 1, 3>(t0, t2));
+        simd::store(Result.C2.Ptr, simd::shuffle<0, 2, 0, 2>(t1, t3));
+        simd::store(Result.C3.Ptr, simd::shuffle<1, 3, 1, 3>(t1, t3));
+        return Result;
+    }
+#endif
+
     mat4 Result = mat4();
 
     Result.Ptr[0][0] = InMatrix.Ptr[0][0];
@@ -1309,8 +1716,25 @@ inline mat4 transposeMatrix(mat4 InMatrix)
     return Result;
 }
 
-inline float4 mat4TranslatePoint(mat4 Matrix, float4 Point)
+constexpr float4 mat4TranslatePoint(mat4 Matrix, float4 Point)
 {
+#if !CT_MATH_SIMD_SCALAR
+    if (!std::is_constant_evaluated())
+    {
+        // Linear combination of the columns, summed in the same order as the row dot products.
+        const simd::f32x4 p = simd::load(Point.Ptr);
+
+        simd::f32x4 Sum = simd::mul(simd::load(Matrix.C0.Ptr), simd::shuffle<0, 0, 0, 0>(p, p));
+        Sum = simd::add(Sum, simd::mul(simd::load(Matrix.C1.Ptr), simd::shuffle<1, 1, 1, 1>(p, p)));
+        Sum = simd::add(Sum, simd::mul(simd::load(Matrix.C2.Ptr), simd::shuffle<2, 2, 2, 2>(p, p)));
+        Sum = simd::add(Sum, simd::mul(simd::load(Matrix.C3.Ptr), simd::shuffle<3, 3, 3, 3>(p, p)));
+
+        float4 Result;
+        simd::store(Result.Ptr, Sum);
+        return Result;
+    }
+#endif
+
     float4 r0 = {Matrix.Ptr[0][0], Matrix.Ptr[1][0], Matrix.Ptr[2][0], Matrix.Ptr[3][0] };
     float4 r1 = {Matrix.Ptr[0][1], Matrix.Ptr[1][1], Matrix.Ptr[2][1], Matrix.Ptr[3][1] };
     float4 r2 = {Matrix.Ptr[0][2], Matrix.Ptr[1][2], Matrix.Ptr[2][2], Matrix.Ptr[3][2] };
@@ -1325,7 +1749,7 @@ inline float4 mat4TranslatePoint(mat4 Matrix, float4 Point)
 }
 
 // Creates a translation matrix
-inline mat4 translateMatrix(float3 TranslateVector)
+constexpr mat4 translateMatrix(float3 TranslateVector)
 {
     mat4 Result = mat4();
 
@@ -1336,7 +1760,7 @@ inline mat4 translateMatrix(float3 TranslateVector)
     return Result;
 }
 
-inline mat4 lookAtMatrixRh(float3 EyePosition, float3 EyeLookAtPoint, float3 UpVector)
+constexpr mat4 lookAtMatrixRh(float3 EyePosition, float3 EyeLookAtPoint, float3 UpVector)
 {
     mat4 Result = mat4();
 
@@ -1373,12 +1797,12 @@ inline mat4 lookAtMatrixRh(float3 EyePosition, float3 EyeLookAtPoint, float3 UpV
     return Result;
 }
 
-inline mat4 perspectiveMatrixRh(f32 FieldOfView, f32 AspectRatio, f32 NearPlane, f32 FarPlane)
+constexpr mat4 perspectiveMatrixRh(f32 FieldOfView, f32 AspectRatio, f32 NearPlane, f32 FarPlane)
 {
     mat4 Result = mat4(0.0f);
 
     f32 Radians = degreesToRadians(FieldOfView);
-    f32 Cotangent = 1.0f / tanf(Radians * 0.5f);
+    f32 Cotangent = 1.0f / f32Tan(Radians * 0.5f);
 
     Result.Ptr[0][0] = Cotangent / AspectRatio;
     Result.Ptr[1][1] = Cotangent;
@@ -1390,12 +1814,12 @@ inline mat4 perspectiveMatrixRh(f32 FieldOfView, f32 AspectRatio, f32 NearPlane,
     return Result;
 }
 
-inline mat4 RotateXMatrix(f32 Theta)
+constexpr mat4 RotateXMatrix(f32 Theta)
 {
     Theta = degreesToRadians(Theta);
 
-    f32 c = cosf(Theta);
-    f32 s = sinf(Theta);
+    f32 c = f32Cos(Theta);
+    f32 s = f32Sin(Theta);
 
     mat4 Result;
 
@@ -1422,12 +1846,12 @@ inline mat4 RotateXMatrix(f32 Theta)
     return Result;
 }
 
-inline mat4 RotateYMatrix(f32 Theta)
+constexpr mat4 RotateYMatrix(f32 Theta)
 {
     Theta = degreesToRadians(Theta);
 
-    f32 c = cosf(Theta);
-    f32 s = sinf(Theta);
+    f32 c = f32Cos(Theta);
+    f32 s = f32Sin(Theta);
 
     mat4 Result;
 
@@ -1454,12 +1878,12 @@ inline mat4 RotateYMatrix(f32 Theta)
     return Result;
 }
 
-inline mat4 RotateZMatrix(f32 Theta)
+constexpr mat4 RotateZMatrix(f32 Theta)
 {
     Theta = degreesToRadians(Theta);
 
-    f32 c = cosf(Theta);
-    f32 s = sinf(Theta);
+    f32 c = f32Cos(Theta);
+    f32 s = f32Sin(Theta);
 
     mat4 Result;
 
@@ -1486,13 +1910,13 @@ inline mat4 RotateZMatrix(f32 Theta)
     return Result;
 }
 
-inline mat4 RotateMatrix(f32 Theta, float3 RotationAxis)
+constexpr mat4 RotateMatrix(f32 Theta, float3 RotationAxis)
 {
     Theta = degreesToRadians(Theta);
     RotationAxis.norm();
 
-    f32 c = cosf(Theta);
-    f32 s = sinf(Theta);
+    f32 c = f32Cos(Theta);
+    f32 s = f32Sin(Theta);
     f32 d = 1.0f - c;
 
     f32 x = RotationAxis.X * d;
@@ -1549,12 +1973,12 @@ inline quaternion EulerToQuaternion(f32 Roll, f32 Pitch, f32 Yaw)
     Pitch = degreesToRadians(Pitch);
     Yaw   = degreesToRadians(Yaw);
 
-    f32 cy = cosf(Yaw * 0.5f);
-    f32 sy = sinf(Yaw * 0.5f);
-    f32 cp = cosf(Pitch * 0.5f);
-    f32 sp = sinf(Pitch * 0.5f);
-    f32 cr = cosf(Roll * 0.5f);
-    f32 sr = sinf(Roll * 0.5f);
+    f32 cy = f32Cos(Yaw * 0.5f);
+    f32 sy = f32Sin(Yaw * 0.5f);
+    f32 cp = f32Cos(Pitch * 0.5f);
+    f32 sp = f32Sin(Pitch * 0.5f);
+    f32 cr = f32Cos(Roll * 0.5f);
+    f32 sr = f32Sin(Roll * 0.5f);
 
     quaternion Result = {};
 
@@ -1587,35 +2011,167 @@ inline mat4 QuaternionToRotationMatrix(quaternion Quaternion)
 
     // 3x3 Rotation Matrix
     Result.C0 = { 1 - 2.0f * (Y2 + Z2),        2.0f * (XY + WZ),        2.0f * (XZ - WY), 0.0f };
-    Result.C1 = {     2.0f * (XY - WZ), 1.0f - 2.0f * (X2 + Z2),        2.0f * (YZ - WX), 0.0f };
+    Result.C1 = {     2.0f * (XY - WZ), 1.0f - 2.0f * (X2 + Z2),        2.0f * (YZ + WX), 0.0f };
     Result.C2 = {        2.0f * (XZ + WY),     2.0f * (YZ - WX), 1.0f - 2.0f * (X2 + Y2), 0.0f };
     Result.C3 = {                       0,                    0,                       0,    1 };
 
     return Result;
 }
 
+// Extracts the rotation of an orthonormal (unscaled) matrix.
+inline quaternion mat4ToQuaternion(mat4 Matrix)
+{
+    // R(Row, Col) == Matrix.Ptr[Col][Row]
+    const f32 R00 = Matrix.Ptr[0][0], R01 = Matrix.Ptr[1][0], R02 = Matrix.Ptr[2][0];
+    const f32 R10 = Matrix.Ptr[0][1], R11 = Matrix.Ptr[1][1], R12 = Matrix.Ptr[2][1];
+    const f32 R20 = Matrix.Ptr[0][2], R21 = Matrix.Ptr[1][2], R22 = Matrix.Ptr[2][2];
+
+    quaternion Result;
+
+    // Branch on the largest diagonal term to keep the divisor away from zero.
+    const f32 Trace = R00 + R11 + R22;
+    if (Trace > 0.0f)
+    {
+        const f32 S = sqrtf(Trace + 1.0f) * 2.0f;
+        Result = quaternion((R21 - R12) / S, (R02 - R20) / S, (R10 - R01) / S, 0.25f * S);
+    }
+    else if (R00 > R11 && R00 > R22)
+    {
+        const f32 S = sqrtf(1.0f + R00 - R11 - R22) * 2.0f;
+        Result = quaternion(0.25f * S, (R01 + R10) / S, (R02 + R20) / S, (R21 - R12) / S);
+    }
+    else if (R11 > R22)
+    {
+        const f32 S = sqrtf(1.0f + R11 - R00 - R22) * 2.0f;
+        Result = quaternion((R01 + R10) / S, 0.25f * S, (R12 + R21) / S, (R02 - R20) / S);
+    }
+    else
+    {
+        const f32 S = sqrtf(1.0f + R22 - R00 - R11) * 2.0f;
+        Result = quaternion((R02 + R20) / S, (R12 + R21) / S, 0.25f * S, (R10 - R01) / S);
+    }
+
+    return Result;
+}
+
+// Hamilton product, applies Right first and then Left.
+inline quaternion operator*(quaternion Left, quaternion Right)
+{
+    return quaternion(
+        Left.Theta * Right.X + Left.X * Right.Theta + Left.Y * Right.Z - Left.Z * Right.Y,
+        Left.Theta * Right.Y - Left.X * Right.Z + Left.Y * Right.Theta + Left.Z * Right.X,
+        Left.Theta * Right.Z + Left.X * Right.Y - Left.Y * Right.X + Left.Z * Right.Theta,
+        Left.Theta * Right.Theta - Left.X * Right.X - Left.Y * Right.Y - Left.Z * Right.Z);
+}
+
+inline quaternion conjugate(quaternion Quaternion)
+{
+    return quaternion(-Quaternion.X, -Quaternion.Y, -Quaternion.Z, Quaternion.Theta);
+}
+
+inline f32 dot(quaternion Left, quaternion Right)
+{
+    return Left.X * Right.X + Left.Y * Right.Y + Left.Z * Right.Z + Left.Theta * Right.Theta;
+}
+
+// Rotates Vector by a unit quaternion. Cheaper than q * v * conjugate(q).
+inline float3 rotateVector(quaternion Rotation, float3 Vector)
+{
+    const float3 Axis = { Rotation.X, Rotation.Y, Rotation.Z };
+    const float3 T    = cross(Axis, Vector) * 2.0f;
+    return Vector + T * Rotation.Theta + cross(Axis, T);
+}
+
+// Normalised linear interpolation. Not constant speed, but cheap, commutative and close to slerp for the small
+// angles between animation keys.
+inline quaternion nlerp(quaternion From, quaternion To, f32 Factor)
+{
+    // q and -q are the same rotation, go the short way round.
+    const f32 Sign = (dot(From, To) < 0.0f) ? -1.0f : 1.0f;
+    const f32 A    = 1.0f - Factor;
+    const f32 B    = Factor * Sign;
+
+    quaternion Result(A * From.X + B * To.X, A * From.Y + B * To.Y, A * From.Z + B * To.Z, A * From.Theta + B * To.Theta);
+    return Result.Norm();
+}
+
+// Spherical linear interpolation, constant angular speed.
+inline quaternion slerp(quaternion From, quaternion To, f32 Factor)
+{
+    f32 CosTheta = dot(From, To);
+    f32 Sign     = 1.0f;
+    if (CosTheta < 0.0f)
+    {
+        CosTheta = -CosTheta;
+        Sign     = -1.0f;
+    }
+
+    // Nearly parallel, sin(Theta) heads to zero and nlerp is just as accurate.
+    if (CosTheta > 0.9995f)
+    {
+        return nlerp(From, To, Factor);
+    }
+
+    const f32 Theta  = f32Acos(CosTheta);
+    const f32 InvSin = 1.0f / f32Sin(Theta);
+    const f32 A      = f32Sin((1.0f - Factor) * Theta) * InvSin;
+    const f32 B      = f32Sin(Factor * Theta) * InvSin * Sign;
+
+    return quaternion(A * From.X + B * To.X, A * From.Y + B * To.Y, A * From.Z + B * To.Z, A * From.Theta + B * To.Theta);
+}
+
+//
+// dualQuaternion Functions
+//
+
+inline dualQuaternion makeDualQuaternion(quaternion Rotation, float3 Translation)
+{
+    dualQuaternion Result;
+    Result.Real = Rotation;
+    Result.Dual = quaternion(Translation.X, Translation.Y, Translation.Z, 0.0f) * Rotation;
+    Result.Dual = quaternion(Result.Dual.X * 0.5f, Result.Dual.Y * 0.5f, Result.Dual.Z * 0.5f, Result.Dual.Theta * 0.5f);
+    return Result;
+}
+
+// Only valid for rigid matrices, any scale or shear is lost.
+inline dualQuaternion mat4ToDualQuaternion(mat4 Matrix)
+{
+    return makeDualQuaternion(mat4ToQuaternion(Matrix), { Matrix.Ptr[3][0], Matrix.Ptr[3][1], Matrix.Ptr[3][2] });
+}
+
+// Expects a unit dual quaternion (|Real| == 1).
+inline float3 dualQuaternionTransformPoint(dualQuaternion Transform, float3 Point)
+{
+    const float3 RealXyz = { Transform.Real.X, Transform.Real.Y, Transform.Real.Z };
+    const float3 DualXyz = { Transform.Dual.X, Transform.Dual.Y, Transform.Dual.Z };
+
+    // Translation = 2 * Dual * conjugate(Real)
+    const float3 Translation = (DualXyz * Transform.Real.Theta - RealXyz * Transform.Dual.Theta + cross(RealXyz, DualXyz)) * 2.0f;
+    return rotateVector(Transform.Real, Point) + Translation;
+}
+
 //
 // More Misc. / Geometric Functions
 //
 
-inline f32 F32Clamp(f32 Min, f32 Max, f32 Value)
+constexpr f32 F32Clamp(f32 Min, f32 Max, f32 Value)
 {
     return (Value < Min) ? Min : (Value > Max) ? Max : Value;
 }
 
-inline f32 smoothstep(f32 Point0, f32 Point1, f32 Factor)
+constexpr f32 smoothstep(f32 Point0, f32 Point1, f32 Factor)
 {
     Factor = F32Clamp(0.0f, 1.0f, (Factor - Point0) / (Point1, - Point0));
     return Factor * Factor * (3 - 2 * Factor);
 }
 
-inline f32 smootherstep(f32 Point0, f32 Point1, f32 Factor)
+constexpr f32 smootherstep(f32 Point0, f32 Point1, f32 Factor)
 {
     Factor = F32Clamp(0.0f, 1.0f, (Factor - Point0) / (Point1 - Point0));
     return Factor * Factor * Factor * (Factor * (Factor * 6 - 15) + 10);
 }
 
-inline float3 F32x3ComputeNormal(float3 Point0, float3 Point1, float3 Point2)
+constexpr float3 F32x3ComputeNormal(float3 Point0, float3 Point1, float3 Point2)
 {
     float3 Point10      = Point1 - Point0;
     float3 Point20      = Point2 - Point0;
@@ -1690,7 +2246,7 @@ inline float3 F32x3RandomUnitVector()
     f32 A = F32RandomClamped(0, 2 * F32_PI);
     f32 Z = F32RandomClamped(-1, 1);
     f32 R = sqrtf(1 - Z * Z);
-    return { R * cosf(A), R * sinf(A), Z };
+    return { R * f32Cos(A), R * f32Sin(A), Z };
 }
 
 inline float3  F32x3RandomInUnitDisc()
@@ -1729,5 +2285,8 @@ inline f32 SchlickApproximation(f32 Cosine, f32 RefractionIndex)
     f32 R0 = (1 - RefractionIndex) / (1 + RefractionIndex);
     R0     = R0 * R0;
 
-    return R0 + (1 - R0) * powf((1 - Cosine), 5);
+    // powf rounds differently between platforms, an integer power is just multiplies.
+    const f32 X  = 1 - Cosine;
+    const f32 X2 = X * X;
+    return R0 + (1 - R0) * (X2 * X2 * X);
 }
\ No newline at end of file
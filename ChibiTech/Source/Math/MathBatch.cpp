@@ -0,0 +1,365 @@
+#include "MathBatch.h"
+
+#include <Platform/Assert.h>
+
+#include <algorithm>
+#include <limits>
+
+static_assert(sizeof(float3) == 3 * sizeof(f32), "AoS kernels assume float3 arrays are tightly packed");
+
+namespace {
+    using Lane = simd::f32xN;
+    constexpr u64 cLaneWidth = simd::cNativeWidth;
+
+    Lane loadLane(const f32* tPtr)         { return simd::loadN(tPtr); }
+    void storeLane(f32* tPtr, Lane tValue) { simd::storeN(tPtr, tValue); }
+    Lane splatLane(f32 tValue)             { return simd::splatN(tValue); }
+
+    struct Lanes3
+    {
+        Lane X, Y, Z;
+    };
+
+    // 4 packed float3 (3 registers) <-> one register per component.
+    void deinterleave4(const f32* tPtr, simd::f32x4& tX, simd::f32x4& tY, simd::f32x4& tZ)
+    {
+        using namespace simd;
+
+        const f32x4 a = load(tPtr + 0); // x0 y0 z0 x1
+        const f32x4 b = load(tPtr + 4); // y1 z1 x2 y2
+        const f32x4 c = load(tPtr + 8); // z2 x3 y3 z3
+
+        tX = shuffle<0, 3, 0, 2>(a, shuffle<2, 2, 1, 1>(b, c));
+        tY = shuffle<0, 2, 0, 2>(shuffle<1, 1, 0, 0>(a, b), shuffle<3, 3, 2, 2>(b, c));
+        tZ = shuffle<0, 2, 0, 2>(shuffle<2, 2, 1, 1>(a, b), shuffle<0, 0, 3, 3>(c, c));
+    }
+
+    void interleave4(f32* tPtr, simd::f32x4 tX, simd::f32x4 tY, simd::f32x4 tZ)
+    {
+        using namespace simd;
+
+        store(tPtr + 0, shuffle<0, 2, 0, 2>(shuffle<0, 1, 0, 1>(tX, tY), shuffle<0, 0, 1, 1>(tZ, tX)));
+        store(tPtr + 4, shuffle<0, 2, 0, 2>(shuffle<1, 1, 1, 1>(tY, tZ), shuffle<2, 2, 2, 2>(tX, tY)));
+        store(tPtr + 8, shuffle<0, 2, 0, 2>(shuffle<2, 2, 3, 3>(tZ, tX), shuffle<3, 3, 3, 3>(tY, tZ)));
+    }
+
+    // Loads/stores cLaneWidth elements
+    Lanes3 loadAoS(const float3* tPoints)
+    {
+        const f32* ptr = &tPoints[0].X;
+#if CT_MATH_SIMD_AVX
+        simd::f32x4 x0, y0, z0, x1, y1, z1;
+        deinterleave4(ptr,      x0, y0, z0);
+        deinterleave4(ptr + 12, x1, y1, z1);
+        return { simd::combine(x0, x1), simd::combine(y0, y1), simd::combine(z0, z1) };
+#else
+        Lanes3 result;
+        deinterleave4(ptr, result.X, result.Y, result.Z);
+        return result;
+#endif
+    }
+
+    void storeAoS(float3* tPoints, const Lanes3& tValue)
+    {
+        f32* ptr = &tPoints[0].X;
+#if CT_MATH_SIMD_AVX
+        interleave4(ptr,      simd::lowHalf(tValue.X),  simd::lowHalf(tValue.Y),  simd::lowHalf(tValue.Z));
+        interleave4(ptr + 12, simd::highHalf(tValue.X), simd::highHalf(tValue.Y), simd::highHalf(tValue.Z));
+#else
+        interleave4(ptr, tValue.X, tValue.Y, tValue.Z);
+#endif
+    }
+
+    Lanes3 loadSoA(constFloat3SoA tStreams, u64 tIndex)
+    {
+        return { loadLane(tStreams.X + tIndex), loadLane(tStreams.Y + tIndex), loadLane(tStreams.Z + tIndex) };
+    }
+
+    void storeSoA(float3SoA tStreams, u64 tIndex, const Lanes3& tValue)
+    {
+        storeLane(tStreams.X + tIndex, tValue.X);
+        storeLane(tStreams.Y + tIndex, tValue.Y);
+        storeLane(tStreams.Z + tIndex, tValue.Z);
+    }
+
+    // Runs tKernel over full blocks, then over a zero-padded copy of the tail so every element goes through the
+    // exact same instructions.
+    template<typename Kernel>
+    void mapAoS(const float3* tIn, float3* tOut, u64 tCount, Kernel&& tKernel)
+    {
+        u64 i = 0;
+        for (; i + cLaneWidth <= tCount; i += cLaneWidth) {
+            storeAoS(tOut + i, tKernel(loadAoS(tIn + i)));
+        }
+
+        if (i < tCount) {
+            float3 block[cLaneWidth] = {};
+            std::copy(tIn + i, tIn + tCount, block);
+            storeAoS(block, tKernel(loadAoS(block)));
+            std::copy(block, block + (tCount - i), tOut + i);
+        }
+    }
+
+    template<typename Kernel>
+    void mapSoA(constFloat3SoA tIn, float3SoA tOut, Kernel&& tKernel)
+    {
+        u64 i = 0;
+        for (; i + cLaneWidth <= tIn.Count; i += cLaneWidth) {
+            storeSoA(tOut, i, tKernel(loadSoA(tIn, i)));
+        }
+
+        if (i < tIn.Count) {
+            const u64 remaining = tIn.Count - i;
+
+            f32 x[cLaneWidth] = {}, y[cLaneWidth] = {}, z[cLaneWidth] = {};
+            std::copy(tIn.X + i, tIn.X + tIn.Count, x);
+            std::copy(tIn.Y + i, tIn.Y + tIn.Count, y);
+            std::copy(tIn.Z + i, tIn.Z + tIn.Count, z);
+
+            storeSoA({ x, y, z, cLaneWidth }, 0, tKernel(loadSoA({ x, y, z, cLaneWidth }, 0)));
+
+            std::copy(x, x + remaining, tOut.X + i);
+            std::copy(y, y + remaining, tOut.Y + i);
+            std::copy(z, z + remaining, tOut.Z + i);
+        }
+    }
+
+    // Row-wise broadcast of the upper 3x4 of a matrix. Summation order matches mat4TranslatePoint.
+    struct AffineLanes
+    {
+        Lane M[3][4];
+
+        explicit AffineLanes(const mat4& tMatrix, f32 tW)
+        {
+            for (int Row = 0; Row < 3; ++Row) {
+                for (int Col = 0; Col < 3; ++Col) {
+                    M[Row][Col] = splatLane(tMatrix.Ptr[Col][Row]);
+                }
+                M[Row][3] = splatLane(tMatrix.Ptr[3][Row] * tW);
+            }
+        }
+
+        Lanes3 operator()(const Lanes3& tIn) const
+        {
+            using namespace simd;
+
+            Lanes3 result;
+            Lane* out[3] = { &result.X, &result.Y, &result.Z };
+            for (int Row = 0; Row < 3; ++Row) {
+                Lane sum = mul(tIn.X, M[Row][0]);
+                sum = add(sum, mul(tIn.Y, M[Row][1]));
+                sum = add(sum, mul(tIn.Z, M[Row][2]));
+                *out[Row] = add(sum, M[Row][3]);
+            }
+            return result;
+        }
+    };
+
+    Lane dotLanes(const Lanes3& tLeft, const Lanes3& tRight)
+    {
+        using namespace simd;
+        return add(add(mul(tLeft.X, tRight.X), mul(tLeft.Y, tRight.Y)), mul(tLeft.Z, tRight.Z));
+    }
+
+    Lanes3 normalizeLanes(const Lanes3& tIn)
+    {
+        using namespace simd;
+
+        // Dividing by one leaves zero-length vectors untouched, same as float3::norm()
+        const Lane length = replaceZero(sqrt(dotLanes(tIn, tIn)), splatLane(1.0f));
+        return { div(tIn.X, length), div(tIn.Y, length), div(tIn.Z, length) };
+    }
+
+    f32 reduceMin(Lane tValue)
+    {
+        f32 lanes[cLaneWidth];
+        storeLane(lanes, tValue);
+        return *std::min_element(lanes, lanes + cLaneWidth);
+    }
+
+    f32 reduceMax(Lane tValue)
+    {
+        f32 lanes[cLaneWidth];
+        storeLane(lanes, tValue);
+        return *std::max_element(lanes, lanes + cLaneWidth);
+    }
+
+    PointBounds reduceBounds(const Lanes3& tMin, const Lanes3& tMax)
+    {
+        PointBounds result;
+        result.Min = { reduceMin(tMin.X), reduceMin(tMin.Y), reduceMin(tMin.Z) };
+        result.Max = { reduceMax(tMax.X), reduceMax(tMax.Y), reduceMax(tMax.Z) };
+        return result;
+    }
+}
+
+void transformPoints(mat4 Matrix, std::span<const float3> In, std::span<float3> Out)
+{
+    ASSERT(In.size() == Out.size());
+    mapAoS(In.data(), Out.data(), In.size(), AffineLanes(Matrix, 1.0f));
+}
+
+void transformPoints(mat4 Matrix, std::span<float3> InOut)
+{
+    transformPoints(Matrix, InOut, InOut);
+}
+
+void transformPoints(mat4 Matrix, constFloat3SoA In, float3SoA Out)
+{
+    ASSERT(In.Count == Out.Count);
+    mapSoA(In, Out, AffineLanes(Matrix, 1.0f));
+}
+
+void transformDirections(mat4 Matrix, std::span<const float3> In, std::span<float3> Out)
+{
+    ASSERT(In.size() == Out.size());
+    mapAoS(In.data(), Out.data(), In.size(), AffineLanes(Matrix, 0.0f));
+}
+
+void transformDirections(mat4 Matrix, std::span<float3> InOut)
+{
+    transformDirections(Matrix, InOut, InOut);
+}
+
+void transformDirections(mat4 Matrix, constFloat3SoA In, float3SoA Out)
+{
+    ASSERT(In.Count == Out.Count);
+    mapSoA(In, Out, AffineLanes(Matrix, 0.0f));
+}
+
+void normalizeArray(std::span<float3> InOut)
+{
+    mapAoS(InOut.data(), InOut.data(), InOut.size(), normalizeLanes);
+}
+
+void normalizeArray(float3SoA InOut)
+{
+    mapSoA(InOut, InOut, normalizeLanes);
+}
+
+void dotArray(std::span<const float3> Left, std::span<const float3> Right, std::span<f32> Out)
+{
+    ASSERT(Left.size() == Right.size() && Left.size() == Out.size());
+
+    const u64 count = Left.size();
+
+    u64 i = 0;
+    for (; i + cLaneWidth <= count; i += cLaneWidth) {
+        storeLane(Out.data() + i, dotLanes(loadAoS(Left.data() + i), loadAoS(Right.data() + i)));
+    }
+
+    for (; i < count; ++i) {
+        Out[i] = dot(Left[i], Right[i]);
+    }
+}
+
+void dotArray(constFloat3SoA Left, constFloat3SoA Right, std::span<f32> Out)
+{
+    ASSERT(Left.Count == Right.Count && Left.Count == Out.size());
+
+    const u64 count = Left.Count;
+
+    u64 i = 0;
+    for (; i + cLaneWidth <= count; i += cLaneWidth) {
+        storeLane(Out.data() + i, dotLanes(loadSoA(Left, i), loadSoA(Right, i)));
+    }
+
+    for (; i < count; ++i) {
+        Out[i] = Left.X[i] * Right.X[i] + Left.Y[i] * Right.Y[i] + Left.Z[i] * Right.Z[i];
+    }
+}
+
+PointBounds boundsOfPoints(std::span<const float3> Points)
+{
+    constexpr f32 cInf = std::numeric_limits<f32>::infinity();
+
+    Lanes3 minLanes = { splatLane(cInf),  splatLane(cInf),  splatLane(cInf)  };
+    Lanes3 maxLanes = { splatLane(-cInf), splatLane(-cInf), splatLane(-cInf) };
+
+    const auto accumulate = [&](const Lanes3& tIn) {
+        minLanes = { simd::min(minLanes.X, tIn.X), simd::min(minLanes.Y, tIn.Y), simd::min(minLanes.Z, tIn.Z) };
+        maxLanes = { simd::max(maxLanes.X, tIn.X), simd::max(maxLanes.Y, tIn.Y), simd::max(maxLanes.Z, tIn.Z) };
+    };
+
+    const u64 count = Points.size();
+
+    u64 i = 0;
+    for (; i + cLaneWidth <= count; i += cLaneWidth) {
+        accumulate(loadAoS(Points.data() + i));
+    }
+
+    // Padding the tail with a real point keeps the result unchanged.
+    if (i < count) {
+        float3 block[cLaneWidth];
+        std::fill(block, block + cLaneWidth, Points[i]);
+        std::copy(Points.data() + i, Points.data() + count, block);
+        accumulate(loadAoS(block));
+    }
+
+    return reduceBounds(minLanes, maxLanes);
+}
+
+PointBounds boundsOfPoints(constFloat3SoA Points)
+{
+    constexpr f32 cInf = std::numeric_limits<f32>::infinity();
+
+    Lanes3 minLanes = { splatLane(cInf),  splatLane(cInf),  splatLane(cInf)  };
+    Lanes3 maxLanes = { splatLane(-cInf), splatLane(-cInf), splatLane(-cInf) };
+
+    const auto accumulate = [&](const Lanes3& tIn) {
+        minLanes = { simd::min(minLanes.X, tIn.X), simd::min(minLanes.Y, tIn.Y), simd::min(minLanes.Z, tIn.Z) };
+        maxLanes = { simd::max(maxLanes.X, tIn.X), simd::max(maxLanes.Y, tIn.Y), simd::max(maxLanes.Z, tIn.Z) };
+    };
+
+    u64 i = 0;
+    for (; i + cLaneWidth <= Points.Count; i += cLaneWidth) {
+        accumulate(loadSoA(Points, i));
+    }
+
+    // Padding the tail with a real point keeps the result unchanged.
+    if (i < Points.Count) {
+        f32 x[cLaneWidth], y[cLaneWidth], z[cLaneWidth];
+        std::fill(x, x + cLaneWidth, Points.X[i]);
+        std::fill(y, y + cLaneWidth, Points.Y[i]);
+        std::fill(z, z + cLaneWidth, Points.Z[i]);
+        std::copy(Points.X + i, Points.X + Points.Count, x);
+        std::copy(Points.Y + i, Points.Y + Points.Count, y);
+        std::copy(Points.Z + i, Points.Z + Points.Count, z);
+        accumulate(loadSoA({ x, y, z, cLaneWidth }, 0));
+    }
+
+    return reduceBounds(minLanes, maxLanes);
+}
+
+f32 sumArray(std::span<const f32> In)
+{
+    using namespace simd;
+
+    const f32* ptr   = In.data();
+    const u64  count = In.size();
+
+    // Partial sums 0-3 and 4-7. AVX keeps them in one register, the 4-wide backends in two.
+    f32x4 low  = splat(0.0f);
+    f32x4 high = splat(0.0f);
+
+    u64 i = 0;
+#if CT_MATH_SIMD_AVX
+    f32x8 sums = splat8(0.0f);
+    for (; i + 8 <= count; i += 8) {
+        sums = add(sums, load8(ptr + i));
+    }
+    low  = lowHalf(sums);
+    high = highHalf(sums);
+#else
+    for (; i + 8 <= count; i += 8) {
+        low  = add(low,  load(ptr + i));
+        high = add(high, load(ptr + i + 4));
+    }
+#endif
+
+    f32 result = sumInOrder(add(low, high));
+    for (; i < count; ++i) {
+        result += ptr[i];
+    }
+    return result;
+}
@@ -0,0 +1,80 @@
+//
+// Batched math kernels that operate on whole arrays instead of a single vector.
+//
+// Every kernel comes in two flavours:
+//   AoS - std::span<float3>, the layout GeometryVertex and most gameplay code use.
+//   SoA - float3SoA, three separate component streams. This is the faster layout, the AoS overloads have to
+//         transpose each block of elements into registers before doing any math.
+//
+// The kernels run as many lanes as the SIMD backend allows (8 with AVX, 4 with SSE/NEON). Except for sumArray, which
+// finishes with a scalar loop (see below), there is no scalar tail loop: the last partial block is copied into a stack
+// block padded to a full vector (zeros, or a repeat of a real point for the bounds kernels), run through the same
+// vector code, and only the real elements are copied back. Nothing past the end of a caller's span is read or written,
+// but the padding lanes are computed, so a kernel like normalizeArray may produce NaN/Inf in lanes that are then thrown
+// away (visible only with FP exceptions unmasked).
+// Results are bit-identical to the per-element Math.h functions they replace.
+//
+// Output spans may alias their input spans (in-place), but must not partially overlap them.
+//
+
+#pragma once
+
+#include "Math.h"
+
+#include <span>
+
+// Structure-of-arrays view over float3 data. The three streams must each hold Count elements.
+struct float3SoA
+{
+    f32* X;
+    f32* Y;
+    f32* Z;
+    u64  Count;
+};
+
+struct constFloat3SoA
+{
+    const f32* X;
+    const f32* Y;
+    const f32* Z;
+    u64        Count;
+
+    constFloat3SoA() = default;
+    constFloat3SoA(const f32* InX, const f32* InY, const f32* InZ, u64 InCount) : X(InX), Y(InY), Z(InZ), Count(InCount) {}
+    constFloat3SoA(float3SoA Other) : X(Other.X), Y(Other.Y), Z(Other.Z), Count(Other.Count) {}
+};
+
+// Min/Max corners of a set of points. An empty input produces Min = +inf, Max = -inf.
+struct PointBounds
+{
+    float3 Min;
+    float3 Max;
+};
+
+// Out[i] = (Matrix * float4(In[i], 1)).XYZ. The matrix is treated as affine, there is no divide by W.
+void transformPoints(mat4 Matrix, std::span<const float3> In, std::span<float3> Out);
+void transformPoints(mat4 Matrix, std::span<float3> InOut);
+void transformPoints(mat4 Matrix, constFloat3SoA In, float3SoA Out);
+
+// Out[i] = (Matrix * float4(In[i], 0)).XYZ. Ignores translation.
+void transformDirections(mat4 Matrix, std::span<const float3> In, std::span<float3> Out);
+void transformDirections(mat4 Matrix, std::span<float3> InOut);
+void transformDirections(mat4 Matrix, constFloat3SoA In, float3SoA Out);
+
+// Same semantics as float3::norm(): zero-length vectors are left untouched.
+void normalizeArray(std::span<float3> InOut);
+void normalizeArray(float3SoA InOut);
+
+// Out[i] = dot(Left[i], Right[i])
+void dotArray(std::span<const float3> Left, std::span<const float3> Right, std::span<f32> Out);
+void dotArray(constFloat3SoA Left, constFloat3SoA Right, std::span<f32> Out);
+
+PointBounds boundsOfPoints(std::span<const float3> Points);
+PointBounds boundsOfPoints(constFloat3SoA Points);
+
+// Sum of In. The leading multiple of 8 elements are accumulated in 8 partial sums (element i into partial i % 8).
+// Partials k and k + 4 are added, the four results are summed left to right, and the last In.size() % 8 elements
+// are then added one at a time with a scalar loop. Nothing past the end of In is read. The order is fixed, so the
+// result is the same on every backend. It differs from a front to back loop, and is usually a little more accurate.
+// Any fixed split of a larger array into blocks that are multiples of 8 keeps this property, see parallelSum.
+f32 sumArray(std::span<const f32> In);
@@ -0,0 +1,462 @@
+//
+// Compile-time selected SIMD backend for Math.h
+//
+// The backend is picked from the compiler's target flags:
+//   CT_MATH_SIMD_AVX    - x64 with AVX enabled (/arch:AVX, -mavx). Also enables the SSE path.
+//   CT_MATH_SIMD_SSE    - x64 or x86 with SSE2.
+//   CT_MATH_SIMD_NEON   - AArch64 with NEON.
+//   CT_MATH_SIMD_SCALAR - Anything else, or when CT_MATH_FORCE_SCALAR is defined.
+//
+// f32x4 wraps one 128-bit register and exposes only what Math.h needs. Every operation is element-wise and
+// IEEE exact (no FMA contraction, no approximate reciprocals) so that each backend produces the same bits as the
+// scalar code it replaces, provided the caller keeps the same accumulation order.
+//
+// The exceptions are rsqrtEstimate/rcpEstimate, which exist for FastMath.h and differ between backends. With
+// CT_MATH_DETERMINISTIC they are exact divides instead, so every backend agrees again.
+//
+
+#pragma once
+
+#include <Types.h>
+
+#include <bit>
+#include <cmath>
+
+#if !defined(CT_MATH_FORCE_SCALAR) && (defined(__AVX__))
+#  define CT_MATH_SIMD_AVX 1
+#  define CT_MATH_SIMD_SSE 1
+#  include <immintrin.h>
+#elif !defined(CT_MATH_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define CT_MATH_SIMD_SSE 1
+#  include <emmintrin.h>
+#elif !defined(CT_MATH_FORCE_SCALAR) && ((defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64))
+#  define CT_MATH_SIMD_NEON 1
+#  include <arm_neon.h>
+#else
+#  define CT_MATH_SIMD_SCALAR 1
+#endif
+
+namespace simd {
+#if CT_MATH_SIMD_SSE
+    using f32x4Native = __m128;
+#elif CT_MATH_SIMD_NEON
+    using f32x4Native = float32x4_t;
+#else
+    struct f32x4Native { f32 mLanes[4]; };
+#endif
+
+    struct f32x4
+    {
+        f32x4Native mValue;
+    };
+
+    // Loads/stores are unaligned, the vector types in Math.h only guarantee 4-byte alignment.
+    inline f32x4 load(const f32* tPtr)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_loadu_ps(tPtr) };
+#elif CT_MATH_SIMD_NEON
+        return { vld1q_f32(tPtr) };
+#else
+        return { { { tPtr[0], tPtr[1], tPtr[2], tPtr[3] } } };
+#endif
+    }
+
+    inline void store(f32* tPtr, f32x4 tValue)
+    {
+#if CT_MATH_SIMD_SSE
+        _mm_storeu_ps(tPtr, tValue.mValue);
+#elif CT_MATH_SIMD_NEON
+        vst1q_f32(tPtr, tValue.mValue);
+#else
+        tPtr[0] = tValue.mValue.mLanes[0];
+        tPtr[1] = tValue.mValue.mLanes[1];
+        tPtr[2] = tValue.mValue.mLanes[2];
+        tPtr[3] = tValue.mValue.mLanes[3];
+#endif
+    }
+
+    inline f32x4 splat(f32 tValue)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_set1_ps(tValue) };
+#elif CT_MATH_SIMD_NEON
+        return { vdupq_n_f32(tValue) };
+#else
+        return { { { tValue, tValue, tValue, tValue } } };
+#endif
+    }
+
+    inline f32x4 set(f32 tX, f32 tY, f32 tZ, f32 tW)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_setr_ps(tX, tY, tZ, tW) };
+#elif CT_MATH_SIMD_NEON
+        const f32 lanes[4] = { tX, tY, tZ, tW };
+        return { vld1q_f32(lanes) };
+#else
+        return { { { tX, tY, tZ, tW } } };
+#endif
+    }
+
+    template<int Lane>
+    inline f32 getLane(f32x4 tValue)
+    {
+        static_assert(Lane >= 0 && Lane < 4);
+#if CT_MATH_SIMD_SSE
+        if constexpr (Lane == 0) return _mm_cvtss_f32(tValue.mValue);
+        else return _mm_cvtss_f32(_mm_shuffle_ps(tValue.mValue, tValue.mValue, _MM_SHUFFLE(Lane, Lane, Lane, Lane)));
+#elif CT_MATH_SIMD_NEON
+        return vgetq_lane_f32(tValue.mValue, Lane);
+#else
+        return tValue.mValue.mLanes[Lane];
+#endif
+    }
+
+#if CT_MATH_SIMD_SSE
+#  define CT_SIMD_BINARY_OP(Name, SseOp, NeonOp, ScalarOp)                                        \
+    inline f32x4 Name(f32x4 tLeft, f32x4 tRight) { return { SseOp(tLeft.mValue, tRight.mValue) }; }
+#elif CT_MATH_SIMD_NEON
+#  define CT_SIMD_BINARY_OP(Name, SseOp, NeonOp, ScalarOp)                                        \
+    inline f32x4 Name(f32x4 tLeft, f32x4 tRight) { return { NeonOp(tLeft.mValue, tRight.mValue) }; }
+#else
+#  define CT_SIMD_BINARY_OP(Name, SseOp, NeonOp, ScalarOp)                                        \
+    inline f32x4 Name(f32x4 tLeft, f32x4 tRight)                                                   \
+    {                                                                                              \
+        f32x4 result;                                                                              \
+        for (int i = 0; i < 4; ++i)                                                                \
+            result.mValue.mLanes[i] = tLeft.mValue.mLanes[i] ScalarOp tRight.mValue.mLanes[i];     \
+        return result;                                                                             \
+    }
+#endif
+
+    CT_SIMD_BINARY_OP(add, _mm_add_ps, vaddq_f32, +)
+    CT_SIMD_BINARY_OP(sub, _mm_sub_ps, vsubq_f32, -)
+    CT_SIMD_BINARY_OP(mul, _mm_mul_ps, vmulq_f32, *)
+    CT_SIMD_BINARY_OP(div, _mm_div_ps, vdivq_f32, /)
+
+#undef CT_SIMD_BINARY_OP
+
+    inline f32x4 sqrt(f32x4 tValue)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_sqrt_ps(tValue.mValue) };
+#elif CT_MATH_SIMD_NEON
+        return { vsqrtq_f32(tValue.mValue) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = std::sqrt(tValue.mValue.mLanes[i]);
+        return result;
+#endif
+    }
+
+    // min/max return tRight when either lane is NaN, and for -0/+0, matching the SSE instructions. NEON's vminq/vmaxq
+    // propagate NaN instead, so the NEON path compares and selects like the scalar fallback.
+    inline f32x4 min(f32x4 tLeft, f32x4 tRight)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_min_ps(tLeft.mValue, tRight.mValue) };
+#elif CT_MATH_SIMD_NEON
+        return { vbslq_f32(vcltq_f32(tLeft.mValue, tRight.mValue), tLeft.mValue, tRight.mValue) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = tLeft.mValue.mLanes[i] < tRight.mValue.mLanes[i] ? tLeft.mValue.mLanes[i] : tRight.mValue.mLanes[i];
+        return result;
+#endif
+    }
+
+    inline f32x4 max(f32x4 tLeft, f32x4 tRight)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_max_ps(tLeft.mValue, tRight.mValue) };
+#elif CT_MATH_SIMD_NEON
+        return { vbslq_f32(vcgtq_f32(tLeft.mValue, tRight.mValue), tLeft.mValue, tRight.mValue) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = tLeft.mValue.mLanes[i] > tRight.mValue.mLanes[i] ? tLeft.mValue.mLanes[i] : tRight.mValue.mLanes[i];
+        return result;
+#endif
+    }
+
+    // Per-lane tValue == 0 ? tIfZero : tValue
+    inline f32x4 replaceZero(f32x4 tValue, f32x4 tIfZero)
+    {
+#if CT_MATH_SIMD_SSE
+        const __m128 isZero = _mm_cmpeq_ps(tValue.mValue, _mm_setzero_ps());
+        return { _mm_or_ps(_mm_and_ps(isZero, tIfZero.mValue), _mm_andnot_ps(isZero, tValue.mValue)) };
+#elif CT_MATH_SIMD_NEON
+        return { vbslq_f32(vceqq_f32(tValue.mValue, vdupq_n_f32(0.0f)), tIfZero.mValue, tValue.mValue) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = tValue.mValue.mLanes[i] == 0.0f ? tIfZero.mValue.mLanes[i] : tValue.mValue.mLanes[i];
+        return result;
+#endif
+    }
+
+    // Comparisons return a lane mask (all bits set or clear). moveMask packs the top bit of each lane into bit i.
+    inline f32x4 lessThan(f32x4 tLeft, f32x4 tRight)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_cmplt_ps(tLeft.mValue, tRight.mValue) };
+#elif CT_MATH_SIMD_NEON
+        return { vreinterpretq_f32_u32(vcltq_f32(tLeft.mValue, tRight.mValue)) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = std::bit_cast<f32>(tLeft.mValue.mLanes[i] < tRight.mValue.mLanes[i] ? ~0u : 0u);
+        return result;
+#endif
+    }
+
+    inline f32x4 bitOr(f32x4 tLeft, f32x4 tRight)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_or_ps(tLeft.mValue, tRight.mValue) };
+#elif CT_MATH_SIMD_NEON
+        return { vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(tLeft.mValue), vreinterpretq_u32_f32(tRight.mValue))) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = std::bit_cast<f32>(std::bit_cast<u32>(tLeft.mValue.mLanes[i]) | std::bit_cast<u32>(tRight.mValue.mLanes[i]));
+        return result;
+#endif
+    }
+
+    // Per-lane tMask ? tIfTrue : tIfFalse, tMask must come from a comparison.
+    inline f32x4 select(f32x4 tMask, f32x4 tIfTrue, f32x4 tIfFalse)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_or_ps(_mm_and_ps(tMask.mValue, tIfTrue.mValue), _mm_andnot_ps(tMask.mValue, tIfFalse.mValue)) };
+#elif CT_MATH_SIMD_NEON
+        return { vbslq_f32(vreinterpretq_u32_f32(tMask.mValue), tIfTrue.mValue, tIfFalse.mValue) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = std::bit_cast<u32>(tMask.mValue.mLanes[i]) ? tIfTrue.mValue.mLanes[i] : tIfFalse.mValue.mLanes[i];
+        return result;
+#endif
+    }
+
+    inline u32 moveMask(f32x4 tMask)
+    {
+#if CT_MATH_SIMD_SSE
+        return (u32)_mm_movemask_ps(tMask.mValue);
+#elif CT_MATH_SIMD_NEON
+        const int32x4_t shifts = { 0, 1, 2, 3 };
+        return vaddvq_u32(vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(tMask.mValue), 31), shifts));
+#else
+        u32 result = 0;
+        for (int i = 0; i < 4; ++i)
+            result |= (std::bit_cast<u32>(tMask.mValue.mLanes[i]) >> 31) << i;
+        return result;
+#endif
+    }
+
+    // Shuffle with _mm_shuffle_ps semantics: the low two lanes come from tLeft, the high two lanes from tRight.
+    template<int X, int Y, int Z, int W>
+    inline f32x4 shuffle(f32x4 tLeft, f32x4 tRight)
+    {
+        static_assert(X >= 0 && X < 4 && Y >= 0 && Y < 4 && Z >= 0 && Z < 4 && W >= 0 && W < 4);
+#if CT_MATH_SIMD_SSE
+        return { _mm_shuffle_ps(tLeft.mValue, tRight.mValue, _MM_SHUFFLE(W, Z, Y, X)) };
+#else
+        return set(getLane<X>(tLeft), getLane<Y>(tLeft), getLane<Z>(tRight), getLane<W>(tRight));
+#endif
+    }
+
+    // Sums the lanes in index order, ((x + y) + z) + w, so results match a scalar loop bit-for-bit.
+    inline f32 sumInOrder(f32x4 tValue)
+    {
+        return ((getLane<0>(tValue) + getLane<1>(tValue)) + getLane<2>(tValue)) + getLane<3>(tValue);
+    }
+
+    // Hardware reciprocal (square root) estimates, at least 12 bits of precision on every backend. Results are
+    // NOT identical across backends, see FastMath.h for the refined versions.
+    inline f32x4 rsqrtEstimate(f32x4 tValue)
+    {
+#if CT_MATH_DETERMINISTIC
+        return div(splat(1.0f), sqrt(tValue));
+#elif CT_MATH_SIMD_SSE
+        return { _mm_rsqrt_ps(tValue.mValue) };
+#elif CT_MATH_SIMD_NEON
+        // The raw NEON estimate is only ~8 bits, one step brings it in line with SSE.
+        const float32x4_t estimate = vrsqrteq_f32(tValue.mValue);
+        return { vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(tValue.mValue, estimate), estimate)) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i) {
+            const f32 value    = tValue.mValue.mLanes[i];
+            // The integer trick alone is only good to ~5 bits, two steps get it past the SSE estimate.
+            f32 estimate = std::bit_cast<f32>(0x5f375a86u - (std::bit_cast<u32>(value) >> 1));
+            estimate = estimate * (1.5f - 0.5f * value * estimate * estimate);
+            result.mValue.mLanes[i] = estimate * (1.5f - 0.5f * value * estimate * estimate);
+        }
+        return result;
+#endif
+    }
+
+    inline f32x4 rcpEstimate(f32x4 tValue)
+    {
+#if CT_MATH_DETERMINISTIC
+        return div(splat(1.0f), tValue);
+#elif CT_MATH_SIMD_SSE
+        return { _mm_rcp_ps(tValue.mValue) };
+#elif CT_MATH_SIMD_NEON
+        const float32x4_t estimate = vrecpeq_f32(tValue.mValue);
+        return { vmulq_f32(estimate, vrecpsq_f32(tValue.mValue, estimate)) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = 1.0f / tValue.mValue.mLanes[i];
+        return result;
+#endif
+    }
+
+    // Rounds to the nearest integer, ties to even. Only valid for |tValue| < 2^31.
+    inline f32x4 roundNearest(f32x4 tValue)
+    {
+#if CT_MATH_SIMD_SSE
+        return { _mm_cvtepi32_ps(_mm_cvtps_epi32(tValue.mValue)) };
+#elif CT_MATH_SIMD_NEON
+        return { vrndnq_f32(tValue.mValue) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = std::nearbyint(tValue.mValue.mLanes[i]);
+        return result;
+#endif
+    }
+
+    // 2^tExponent for integral tExponent in [-126, 127], built directly in the exponent bits.
+    inline f32x4 exp2Integer(f32x4 tExponent)
+    {
+#if CT_MATH_SIMD_SSE
+        const __m128i biased = _mm_add_epi32(_mm_cvtps_epi32(tExponent.mValue), _mm_set1_epi32(127));
+        return { _mm_castsi128_ps(_mm_slli_epi32(biased, 23)) };
+#elif CT_MATH_SIMD_NEON
+        const int32x4_t biased = vaddq_s32(vcvtnq_s32_f32(tExponent.mValue), vdupq_n_s32(127));
+        return { vreinterpretq_f32_s32(vshlq_n_s32(biased, 23)) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i)
+            result.mValue.mLanes[i] = std::bit_cast<f32>(u32((s32)tExponent.mValue.mLanes[i] + 127) << 23);
+        return result;
+#endif
+    }
+
+    // Splits a positive normal float into Mantissa * 2^Exponent with Mantissa in [1, 2). Returns the mantissa.
+    inline f32x4 splitExponent(f32x4 tValue, f32x4& tExponent)
+    {
+#if CT_MATH_SIMD_SSE
+        const __m128i bits = _mm_castps_si128(tValue.mValue);
+        tExponent = { _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127))) };
+        return { _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000))) };
+#elif CT_MATH_SIMD_NEON
+        const uint32x4_t bits = vreinterpretq_u32_f32(tValue.mValue);
+        tExponent = { vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127))) };
+        return { vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000))) };
+#else
+        f32x4 result;
+        for (int i = 0; i < 4; ++i) {
+            const u32 bits = std::bit_cast<u32>(tValue.mValue.mLanes[i]);
+            tExponent.mValue.mLanes[i] = f32(s32(bits >> 23) - 127);
+            result.mValue.mLanes[i]    = std::bit_cast<f32>((bits & 0x007fffffu) | 0x3f800000u);
+        }
+        return result;
+#endif
+    }
+
+#if CT_MATH_SIMD_AVX
+    // Two 4-wide vectors in one register. Used for processing a pair of mat4 columns at a time.
+    struct f32x8
+    {
+        __m256 mValue;
+    };
+
+    inline f32x8 load8(const f32* tPtr)            { return { _mm256_loadu_ps(tPtr) }; }
+    inline void  store8(f32* tPtr, f32x8 tValue)   { _mm256_storeu_ps(tPtr, tValue.mValue); }
+    inline f32x8 splat8(f32 tValue)                { return { _mm256_set1_ps(tValue) }; }
+    inline f32x8 add(f32x8 tLeft, f32x8 tRight)    { return { _mm256_add_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 sub(f32x8 tLeft, f32x8 tRight)    { return { _mm256_sub_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 mul(f32x8 tLeft, f32x8 tRight)    { return { _mm256_mul_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 div(f32x8 tLeft, f32x8 tRight)    { return { _mm256_div_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 min(f32x8 tLeft, f32x8 tRight)    { return { _mm256_min_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 max(f32x8 tLeft, f32x8 tRight)    { return { _mm256_max_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 sqrt(f32x8 tValue)                { return { _mm256_sqrt_ps(tValue.mValue) }; }
+
+    inline f32x8 replaceZero(f32x8 tValue, f32x8 tIfZero)
+    {
+        const __m256 isZero = _mm256_cmp_ps(tValue.mValue, _mm256_setzero_ps(), _CMP_EQ_OQ);
+        return { _mm256_blendv_ps(tValue.mValue, tIfZero.mValue, isZero) };
+    }
+
+    inline f32x8 lessThan(f32x8 tLeft, f32x8 tRight) { return { _mm256_cmp_ps(tLeft.mValue, tRight.mValue, _CMP_LT_OQ) }; }
+    inline f32x8 bitOr(f32x8 tLeft, f32x8 tRight)    { return { _mm256_or_ps(tLeft.mValue, tRight.mValue) }; }
+    inline f32x8 select(f32x8 tMask, f32x8 tIfTrue, f32x8 tIfFalse) { return { _mm256_blendv_ps(tIfFalse.mValue, tIfTrue.mValue, tMask.mValue) }; }
+    inline u32   moveMask(f32x8 tMask)               { return (u32)_mm256_movemask_ps(tMask.mValue); }
+
+#if CT_MATH_DETERMINISTIC
+    inline f32x8 rsqrtEstimate(f32x8 tValue)       { return { _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(tValue.mValue)) }; }
+    inline f32x8 rcpEstimate(f32x8 tValue)         { return { _mm256_div_ps(_mm256_set1_ps(1.0f), tValue.mValue) }; }
+#else
+    inline f32x8 rsqrtEstimate(f32x8 tValue)       { return { _mm256_rsqrt_ps(tValue.mValue) }; }
+    inline f32x8 rcpEstimate(f32x8 tValue)         { return { _mm256_rcp_ps(tValue.mValue) }; }
+#endif
+    inline f32x8 roundNearest(f32x8 tValue)        { return { _mm256_round_ps(tValue.mValue, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+    // The two 4-wide halves, used to finish horizontal reductions.
+    inline f32x4 lowHalf(f32x8 tValue)             { return { _mm256_castps256_ps128(tValue.mValue) }; }
+    inline f32x4 highHalf(f32x8 tValue)            { return { _mm256_extractf128_ps(tValue.mValue, 1) }; }
+
+    inline f32x8 combine(f32x4 tLow, f32x4 tHigh)
+    {
+        return { _mm256_insertf128_ps(_mm256_castps128_ps256(tLow.mValue), tHigh.mValue, 1) };
+    }
+
+    // AVX1 has no 256-bit integer instructions, so the bit manipulation helpers run on each half.
+    inline f32x8 exp2Integer(f32x8 tExponent)
+    {
+        return combine(exp2Integer(lowHalf(tExponent)), exp2Integer(highHalf(tExponent)));
+    }
+
+    inline f32x8 splitExponent(f32x8 tValue, f32x8& tExponent)
+    {
+        f32x4 exponentLow, exponentHigh;
+        const f32x4 mantissaLow  = splitExponent(lowHalf(tValue), exponentLow);
+        const f32x4 mantissaHigh = splitExponent(highHalf(tValue), exponentHigh);
+        tExponent = combine(exponentLow, exponentHigh);
+        return combine(mantissaLow, mantissaHigh);
+    }
+
+    // Repeats a 4-wide vector into both halves.
+    inline f32x8 broadcast4(f32x4 tValue)          { return { _mm256_broadcast_ps(&tValue.mValue) }; }
+
+    // Splats lane Lane of each 4-wide half across that half.
+    template<int Lane>
+    inline f32x8 splatLanePerHalf(f32x8 tValue)
+    {
+        return { _mm256_permute_ps(tValue.mValue, _MM_SHUFFLE(Lane, Lane, Lane, Lane)) };
+    }
+#endif
+
+    // The widest vector the backend supports, for array kernels that don't care about the exact width.
+#if CT_MATH_SIMD_AVX
+    using f32xN = f32x8;
+    constexpr u32 cNativeWidth = 8;
+
+    inline f32xN loadN(const f32* tPtr)          { return load8(tPtr); }
+    inline void  storeN(f32* tPtr, f32xN tValue) { store8(tPtr, tValue); }
+    inline f32xN splatN(f32 tValue)              { return splat8(tValue); }
+#else
+    using f32xN = f32x4;
+    constexpr u32 cNativeWidth = 4;
+
+    inline f32xN loadN(const f32* tPtr)          { return load(tPtr); }
+    inline void  storeN(f32* tPtr, f32xN tValue) { store(tPtr, tValue); }
+    inline f32xN splatN(f32 tValue)              { return splat(tValue); }
+#endif
+} // simd
@@ -0,0 +1,521 @@
+#include "Packing.h"
+
+#include <Platform/Assert.h>
+
+#include <type_traits>
+
+#if !defined(CT_MATH_FORCE_SCALAR) && (defined(__F16C__) || defined(CT_MATH_HAS_F16C))
+#  define CT_MATH_F16C 1
+#  include <immintrin.h>
+#endif
+
+namespace ct {
+    namespace {
+        using Lane = simd::f32xN;
+        constexpr u32 cLaneWidth = simd::cNativeWidth;
+
+        // Same operand order as simd::min/max, so NaN clamps to tHigh in both the scalar and the batch code.
+        f32 clampValue(f32 tValue, f32 tLow, f32 tHigh)
+        {
+            const f32 upper = tValue < tHigh ? tValue : tHigh;
+            return upper > tLow ? upper : tLow;
+        }
+
+        template<typename Int>
+        Int quantize(f32 tValue, f32 tLow, f32 tScale)
+        {
+            return (Int)std::nearbyint(clampValue(tValue, tLow, 1.0f) * tScale);
+        }
+
+        template<typename Int>
+        f32 dequantize(Int tValue, f32 tLow, f32 tScale)
+        {
+            const f32 value = f32(tValue) / tScale;
+            return value > tLow ? value : tLow;
+        }
+
+        template<typename Int>
+        void quantizeArray(std::span<const f32> tIn, std::span<Int> tOut, f32 tLow, f32 tScale)
+        {
+            ASSERT(tIn.size() == tOut.size());
+
+            using namespace simd;
+
+            const Lane low   = splatN(tLow);
+            const Lane high  = splatN(1.0f);
+            const Lane scale = splatN(tScale);
+
+            u64 i = 0;
+            for (; i + cLaneWidth <= tIn.size(); i += cLaneWidth) {
+                f32 block[cLaneWidth];
+                storeN(block, roundNearest(mul(max(min(loadN(&tIn[i]), high), low), scale)));
+
+                // Already integral, the conversion is exact
+                for (u32 lane = 0; lane < cLaneWidth; ++lane) {
+                    tOut[i + lane] = (Int)block[lane];
+                }
+            }
+
+            for (; i < tIn.size(); ++i) {
+                tOut[i] = quantize<Int>(tIn[i], tLow, tScale);
+            }
+        }
+
+        template<typename Int>
+        void dequantizeArray(std::span<const Int> tIn, std::span<f32> tOut, f32 tLow, f32 tScale)
+        {
+            ASSERT(tIn.size() == tOut.size());
+
+            using namespace simd;
+
+            const Lane low   = splatN(tLow);
+            const Lane scale = splatN(tScale);
+
+            u64 i = 0;
+            for (; i + cLaneWidth <= tIn.size(); i += cLaneWidth) {
+                f32 block[cLaneWidth];
+                for (u32 lane = 0; lane < cLaneWidth; ++lane) {
+                    block[lane] = f32(tIn[i + lane]);
+                }
+
+                // max(Value, Low) with Value first, matching dequantize()
+                storeN(&tOut[i], max(div(loadN(block), scale), low));
+            }
+
+            for (; i < tIn.size(); ++i) {
+                tOut[i] = dequantize(tIn[i], tLow, tScale);
+            }
+        }
+
+        constexpr f32 cUnorm8  = 255.0f;
+        constexpr f32 cUnorm16 = 65535.0f;
+        constexpr f32 cSnorm8  = 127.0f;
+        constexpr f32 cSnorm16 = 32767.0f;
+        constexpr f32 cUnorm10 = 1023.0f;
+        constexpr f32 cUnorm2  = 3.0f;
+
+#if !CT_MATH_F16C
+        // Branch-free binary16 conversions, after Fabian Giesen's "half_to_float_fast5" and
+        // "float_to_half_fast3_rtne". Used when the target has no F16C.
+        u16 floatToHalfSoftware(f32 tValue)
+        {
+            constexpr u32 cInfinity    = 255u << 23;
+            constexpr u32 cHalfMax     = (127u + 16u) << 23;                 // First float that rounds to inf
+            constexpr u32 cMinNormal   = (127u - 14u) << 23;
+            constexpr u32 cDenormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+            u32       bits = std::bit_cast<u32>(tValue);
+            const u32 sign = bits & 0x80000000u;
+            bits ^= sign;
+
+            u32 result;
+            if (bits >= cHalfMax) {
+                result = bits > cInfinity ? 0x7e00u : 0x7c00u;
+            } else if (bits < cMinNormal) {
+                // Adding the magic number lets the FPU do the denormal rounding
+                const f32 shifted = std::bit_cast<f32>(bits) + std::bit_cast<f32>(cDenormMagic);
+                result = std::bit_cast<u32>(shifted) - cDenormMagic;
+            } else {
+                const u32 mantissaOdd = (bits >> 13) & 1u;
+                bits += ((15u - 127u) << 23) + 0xfffu;
+                bits += mantissaOdd;
+                result = bits >> 13;
+            }
+
+            return u16(result | (sign >> 16));
+        }
+
+        f32 halfToFloatSoftware(u16 tValue)
+        {
+            constexpr u32 cShiftedExponent = 0x7c00u << 13;
+            constexpr f32 cMagic           = std::bit_cast<f32>(113u << 23);
+
+            u32 bits = (tValue & 0x7fffu) << 13;
+            const u32 exponent = bits & cShiftedExponent;
+            bits += (127u - 15u) << 23;
+
+            if (exponent == cShiftedExponent) {
+                bits += (128u - 16u) << 23;   // Inf/NaN
+            } else if (exponent == 0) {
+                bits = std::bit_cast<u32>(std::bit_cast<f32>(bits + (1u << 23)) - cMagic);  // Denormal
+            }
+
+            return std::bit_cast<f32>(bits | (u32(tValue & 0x8000u) << 16));
+        }
+#endif
+
+#if !CT_MATH_F16C && CT_MATH_SIMD_SSE
+        // 4-wide SSE2 versions of the functions above. The result is sign-extended to 32 bits so that
+        // _mm_packs_epi32 keeps the low 16 bits of every lane.
+        __m128i floatToHalf4(__m128 tValue)
+        {
+            const __m128i cHalfMax     = _mm_set1_epi32((127 + 16) << 23);
+            const __m128i cNanBit      = _mm_set1_epi32(0x200);
+            const __m128i cInfinity    = _mm_set1_epi32(0x7c00);
+            const __m128i cMinNormal   = _mm_set1_epi32((127 - 14) << 23);
+            const __m128i cDenormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+            const __m128i cNormalBias  = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+            const __m128  sign     = _mm_and_ps(tValue, _mm_castsi128_ps(_mm_set1_epi32((s32)0x80000000u)));
+            const __m128  absValue = _mm_xor_ps(tValue, sign);
+            const __m128i absBits  = _mm_castps_si128(absValue);
+
+            const __m128i isNan     = _mm_castps_si128(_mm_cmpunord_ps(absValue, absValue));
+            const __m128i isRegular = _mm_cmpgt_epi32(cHalfMax, absBits);
+            const __m128i infOrNan  = _mm_or_si128(_mm_and_si128(isNan, cNanBit), cInfinity);
+            const __m128i isDenorm  = _mm_cmpgt_epi32(cMinNormal, absBits);
+
+            const __m128  denorm0 = _mm_add_ps(absValue, _mm_castsi128_ps(cDenormMagic));
+            const __m128i denorm  = _mm_sub_epi32(_mm_castps_si128(denorm0), cDenormMagic);
+
+            const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absBits, 31 - 13), 31);
+            const __m128i normal      = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absBits, cNormalBias), mantissaOdd), 13);
+
+            const __m128i finite = _mm_or_si128(_mm_and_si128(denorm, isDenorm), _mm_andnot_si128(isDenorm, normal));
+            const __m128i joined = _mm_or_si128(_mm_and_si128(finite, isRegular), _mm_andnot_si128(isRegular, infOrNan));
+            return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+        }
+
+        __m128 halfToFloat4(__m128i tValue)
+        {
+            const __m128i cNoSign     = _mm_set1_epi32(0x7fff);
+            const __m128  cMagic      = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+            const __m128i cWasInfNan  = _mm_set1_epi32(0x7bff);
+            const __m128  cInfNanBits = _mm_castsi128_ps(_mm_set1_epi32(255 << 23));
+
+            const __m128i exponentMantissa = _mm_and_si128(cNoSign, tValue);
+            const __m128i sign             = _mm_slli_epi32(_mm_xor_si128(tValue, exponentMantissa), 16);
+
+            // Multiplying by 2^(127 - 15) rebiases the exponent and normalizes denormals in one go
+            const __m128  scaled    = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentMantissa, 13)), cMagic);
+            const __m128i wasInfNan = _mm_cmpgt_epi32(exponentMantissa, cWasInfNan);
+            const __m128  infNan    = _mm_and_ps(_mm_castsi128_ps(wasInfNan), cInfNanBits);
+
+            return _mm_or_ps(scaled, _mm_or_ps(_mm_castsi128_ps(sign), infNan));
+        }
+#endif
+
+        // Written as a less-than so the lane version below agrees on NaN.
+        f32 signNotZero(f32 tValue)
+        {
+            return tValue < 0.0f ? -1.0f : 1.0f;
+        }
+
+        // Lane versions of f32Abs and signNotZero. Negating by multiplying with -1 keeps the sign of zero like -x.
+        Lane absLanes(Lane tValue)
+        {
+            using namespace simd;
+            return select(lessThan(tValue, splatN(0.0f)), mul(tValue, splatN(-1.0f)), tValue);
+        }
+
+        Lane signNotZeroLanes(Lane tValue)
+        {
+            using namespace simd;
+            return select(lessThan(tValue, splatN(0.0f)), splatN(-1.0f), splatN(1.0f));
+        }
+
+        // Two snorms in one integer, X in the low half.
+        template<typename Packed, typename Int>
+        Packed combineOct(Int tX, Int tY)
+        {
+            using Half = std::make_unsigned_t<Int>;
+            return Packed(Packed(Half(tX)) | (Packed(Half(tY)) << (sizeof(Int) * 8)));
+        }
+
+        template<typename Int, typename Packed>
+        void splitOct(Packed tPacked, Int& tX, Int& tY)
+        {
+            using Half = std::make_unsigned_t<Int>;
+            tX = Int(Half(tPacked));
+            tY = Int(Half(tPacked >> (sizeof(Int) * 8)));
+        }
+
+        // octahedralEncode + snorm quantization, cLaneWidth normals at a time. Same operations in the same order as
+        // the scalar path, so the bits match packNormalOct16/8.
+        template<typename Int, typename Packed>
+        void packNormalsOctArray(std::span<const float3> tIn, std::span<Packed> tOut, f32 tScale)
+        {
+            ASSERT(tIn.size() == tOut.size());
+
+            using namespace simd;
+
+            const Lane zero   = splatN(0.0f);
+            const Lane one    = splatN(1.0f);
+            const Lane negOne = splatN(-1.0f);
+            const Lane scale  = splatN(tScale);
+
+            u64 i = 0;
+            for (; i + cLaneWidth <= tIn.size(); i += cLaneWidth) {
+                f32 blockX[cLaneWidth], blockY[cLaneWidth], blockZ[cLaneWidth];
+                for (u32 lane = 0; lane < cLaneWidth; ++lane) {
+                    blockX[lane] = tIn[i + lane].X;
+                    blockY[lane] = tIn[i + lane].Y;
+                    blockZ[lane] = tIn[i + lane].Z;
+                }
+
+                const Lane normalX = loadN(blockX);
+                const Lane normalY = loadN(blockY);
+                const Lane normalZ = loadN(blockZ);
+
+                // A zero normal divides by one and keeps its +-0, which quantizes to the same 0 as the scalar early-out
+                const Lane l1Norm = replaceZero(add(add(absLanes(normalX), absLanes(normalY)), absLanes(normalZ)), one);
+                const Lane x      = div(normalX, l1Norm);
+                const Lane y      = div(normalY, l1Norm);
+
+                const Lane lower    = lessThan(normalZ, zero);
+                const Lane encodedX = select(lower, mul(sub(one, absLanes(y)), signNotZeroLanes(x)), x);
+                const Lane encodedY = select(lower, mul(sub(one, absLanes(x)), signNotZeroLanes(y)), y);
+
+                storeN(blockX, roundNearest(mul(max(min(encodedX, one), negOne), scale)));
+                storeN(blockY, roundNearest(mul(max(min(encodedY, one), negOne), scale)));
+
+                // Already integral, the conversion is exact
+                for (u32 lane = 0; lane < cLaneWidth; ++lane) {
+                    tOut[i + lane] = combineOct<Packed>((Int)blockX[lane], (Int)blockY[lane]);
+                }
+            }
+
+            for (; i < tIn.size(); ++i) {
+                const float2 encoded = octahedralEncode(tIn[i]);
+                tOut[i] = combineOct<Packed>(quantize<Int>(encoded.X, -1.0f, tScale), quantize<Int>(encoded.Y, -1.0f, tScale));
+            }
+        }
+
+        // Snorm dequantization + octahedralDecode, cLaneWidth normals at a time, matching unpackNormalOct16/8.
+        template<typename Int, typename Packed>
+        void unpackNormalsOctArray(std::span<const Packed> tIn, std::span<float3> tOut, f32 tScale)
+        {
+            ASSERT(tIn.size() == tOut.size());
+
+            using namespace simd;
+
+            const Lane zero   = splatN(0.0f);
+            const Lane one    = splatN(1.0f);
+            const Lane negOne = splatN(-1.0f);
+            const Lane scale  = splatN(tScale);
+
+            u64 i = 0;
+            for (; i + cLaneWidth <= tIn.size(); i += cLaneWidth) {
+                f32 blockX[cLaneWidth], blockY[cLaneWidth], blockZ[cLaneWidth];
+                for (u32 lane = 0; lane < cLaneWidth; ++lane) {
+                    Int x, y;
+                    splitOct(tIn[i + lane], x, y);
+                    blockX[lane] = f32(x);
+                    blockY[lane] = f32(y);
+                }
+
+                const Lane encodedX = max(div(loadN(blockX), scale), negOne);
+                const Lane encodedY = max(div(loadN(blockY), scale), negOne);
+
+                // Dequantized values are never NaN or -0, so x < 0 is the negation of the scalar x >= 0
+                const Lane z    = sub(sub(one, absLanes(encodedX)), absLanes(encodedY));
+                const Lane fold = select(lessThan(z, zero), mul(z, negOne), zero);
+                const Lane x    = add(encodedX, select(lessThan(encodedX, zero), fold, mul(fold, negOne)));
+                const Lane y    = add(encodedY, select(lessThan(encodedY, zero), fold, mul(fold, negOne)));
+
+                // float3::norm leaves a zero vector alone, dividing by one does the same
+                const Lane length = replaceZero(sqrt(add(add(mul(x, x), mul(y, y)), mul(z, z))), one);
+                storeN(blockX, div(x, length));
+                storeN(blockY, div(y, length));
+                storeN(blockZ, div(z, length));
+
+                for (u32 lane = 0; lane < cLaneWidth; ++lane) {
+                    tOut[i + lane] = { blockX[lane], blockY[lane], blockZ[lane] };
+                }
+            }
+
+            for (; i < tIn.size(); ++i) {
+                Int x, y;
+                splitOct(tIn[i], x, y);
+                tOut[i] = octahedralDecode({ dequantize(x, -1.0f, tScale), dequantize(y, -1.0f, tScale) });
+            }
+        }
+    }
+
+    u16 floatToHalf(f32 tValue)
+    {
+#if CT_MATH_F16C
+        return (u16)_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(tValue), _MM_FROUND_TO_NEAREST_INT), 0);
+#else
+        return floatToHalfSoftware(tValue);
+#endif
+    }
+
+    f32 halfToFloat(u16 tValue)
+    {
+#if CT_MATH_F16C
+        return _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(tValue)));
+#else
+        return halfToFloatSoftware(tValue);
+#endif
+    }
+
+    void floatToHalf(std::span<const f32> tIn, std::span<u16> tOut)
+    {
+        ASSERT(tIn.size() == tOut.size());
+
+        u64 i = 0;
+#if CT_MATH_F16C
+        for (; i + 8 <= tIn.size(); i += 8) {
+            const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(&tIn[i]), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128((__m128i*)&tOut[i], halves);
+        }
+#elif CT_MATH_SIMD_SSE
+        for (; i + 8 <= tIn.size(); i += 8) {
+            const __m128i low  = floatToHalf4(_mm_loadu_ps(&tIn[i]));
+            const __m128i high = floatToHalf4(_mm_loadu_ps(&tIn[i + 4]));
+            _mm_storeu_si128((__m128i*)&tOut[i], _mm_packs_epi32(low, high));
+        }
+#endif
+
+        for (; i < tIn.size(); ++i) {
+            tOut[i] = floatToHalf(tIn[i]);
+        }
+    }
+
+    void halfToFloat(std::span<const u16> tIn, std::span<f32> tOut)
+    {
+        ASSERT(tIn.size() == tOut.size());
+
+        u64 i = 0;
+#if CT_MATH_F16C
+        for (; i + 8 <= tIn.size(); i += 8) {
+            _mm256_storeu_ps(&tOut[i], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)&tIn[i])));
+        }
+#elif CT_MATH_SIMD_SSE
+        for (; i + 8 <= tIn.size(); i += 8) {
+            const __m128i halves = _mm_loadu_si128((const __m128i*)&tIn[i]);
+            const __m128i zero   = _mm_setzero_si128();
+            _mm_storeu_ps(&tOut[i],     halfToFloat4(_mm_unpacklo_epi16(halves, zero)));
+            _mm_storeu_ps(&tOut[i + 4], halfToFloat4(_mm_unpackhi_epi16(halves, zero)));
+        }
+#endif
+
+        for (; i < tIn.size(); ++i) {
+            tOut[i] = halfToFloat(tIn[i]);
+        }
+    }
+
+    u8  packUnorm8(f32 tValue)  { return quantize<u8>(tValue, 0.0f, cUnorm8); }
+    u16 packUnorm16(f32 tValue) { return quantize<u16>(tValue, 0.0f, cUnorm16); }
+    s8  packSnorm8(f32 tValue)  { return quantize<s8>(tValue, -1.0f, cSnorm8); }
+    s16 packSnorm16(f32 tValue) { return quantize<s16>(tValue, -1.0f, cSnorm16); }
+
+    f32 unpackUnorm8(u8 tValue)   { return dequantize(tValue, 0.0f, cUnorm8); }
+    f32 unpackUnorm16(u16 tValue) { return dequantize(tValue, 0.0f, cUnorm16); }
+    f32 unpackSnorm8(s8 tValue)   { return dequantize(tValue, -1.0f, cSnorm8); }
+    f32 unpackSnorm16(s16 tValue) { return dequantize(tValue, -1.0f, cSnorm16); }
+
+    void packUnorm8(std::span<const f32> tIn, std::span<u8> tOut)   { quantizeArray(tIn, tOut, 0.0f, cUnorm8); }
+    void packUnorm16(std::span<const f32> tIn, std::span<u16> tOut) { quantizeArray(tIn, tOut, 0.0f, cUnorm16); }
+    void packSnorm8(std::span<const f32> tIn, std::span<s8> tOut)   { quantizeArray(tIn, tOut, -1.0f, cSnorm8); }
+    void packSnorm16(std::span<const f32> tIn, std::span<s16> tOut) { quantizeArray(tIn, tOut, -1.0f, cSnorm16); }
+
+    void unpackUnorm8(std::span<const u8> tIn, std::span<f32> tOut)   { dequantizeArray(tIn, tOut, 0.0f, cUnorm8); }
+    void unpackUnorm16(std::span<const u16> tIn, std::span<f32> tOut) { dequantizeArray(tIn, tOut, 0.0f, cUnorm16); }
+    void unpackSnorm8(std::span<const s8> tIn, std::span<f32> tOut)   { dequantizeArray(tIn, tOut, -1.0f, cSnorm8); }
+    void unpackSnorm16(std::span<const s16> tIn, std::span<f32> tOut) { dequantizeArray(tIn, tOut, -1.0f, cSnorm16); }
+
+    float2 octahedralEncode(float3 tNormal)
+    {
+        const f32 l1Norm = f32Abs(tNormal.X) + f32Abs(tNormal.Y) + f32Abs(tNormal.Z);
+        if (l1Norm == 0.0f) return { 0.0f, 0.0f };
+
+        const f32 x = tNormal.X / l1Norm;
+        const f32 y = tNormal.Y / l1Norm;
+
+        // Fold the lower hemisphere over the diagonals
+        if (tNormal.Z < 0.0f) {
+            return { (1.0f - f32Abs(y)) * signNotZero(x), (1.0f - f32Abs(x)) * signNotZero(y) };
+        }
+
+        return { x, y };
+    }
+
+    float3 octahedralDecode(float2 tEncoded)
+    {
+        float3 normal = { tEncoded.X, tEncoded.Y, 1.0f - f32Abs(tEncoded.X) - f32Abs(tEncoded.Y) };
+
+        const f32 fold = normal.Z < 0.0f ? -normal.Z : 0.0f;
+        normal.X += normal.X >= 0.0f ? -fold : fold;
+        normal.Y += normal.Y >= 0.0f ? -fold : fold;
+
+        return normal.norm();
+    }
+
+    u32 packNormalOct16(float3 tNormal)
+    {
+        const float2 encoded = octahedralEncode(tNormal);
+        return combineOct<u32>(packSnorm16(encoded.X), packSnorm16(encoded.Y));
+    }
+
+    u16 packNormalOct8(float3 tNormal)
+    {
+        const float2 encoded = octahedralEncode(tNormal);
+        return combineOct<u16>(packSnorm8(encoded.X), packSnorm8(encoded.Y));
+    }
+
+    float3 unpackNormalOct16(u32 tPacked)
+    {
+        s16 x, y;
+        splitOct(tPacked, x, y);
+        return octahedralDecode({ unpackSnorm16(x), unpackSnorm16(y) });
+    }
+
+    float3 unpackNormalOct8(u16 tPacked)
+    {
+        s8 x, y;
+        splitOct(tPacked, x, y);
+        return octahedralDecode({ unpackSnorm8(x), unpackSnorm8(y) });
+    }
+
+    void packNormalsOct16(std::span<const float3> tIn, std::span<u32> tOut)   { packNormalsOctArray<s16>(tIn, tOut, cSnorm16); }
+    void packNormalsOct8(std::span<const float3> tIn, std::span<u16> tOut)    { packNormalsOctArray<s8>(tIn, tOut, cSnorm8); }
+    void unpackNormalsOct16(std::span<const u32> tIn, std::span<float3> tOut) { unpackNormalsOctArray<s16>(tIn, tOut, cSnorm16); }
+    void unpackNormalsOct8(std::span<const u16> tIn, std::span<float3> tOut)  { unpackNormalsOctArray<s8>(tIn, tOut, cSnorm8); }
+
+    u32 packRgb10A2(float4 tColor)
+    {
+        return  u32(quantize<u16>(tColor.X, 0.0f, cUnorm10))
+             | (u32(quantize<u16>(tColor.Y, 0.0f, cUnorm10)) << 10)
+             | (u32(quantize<u16>(tColor.Z, 0.0f, cUnorm10)) << 20)
+             | (u32(quantize<u16>(tColor.W, 0.0f, cUnorm2))  << 30);
+    }
+
+    float4 unpackRgb10A2(u32 tPacked)
+    {
+        return {
+            dequantize<u32>(tPacked & 0x3ff,         0.0f, cUnorm10),
+            dequantize<u32>((tPacked >> 10) & 0x3ff, 0.0f, cUnorm10),
+            dequantize<u32>((tPacked >> 20) & 0x3ff, 0.0f, cUnorm10),
+            dequantize<u32>(tPacked >> 30,           0.0f, cUnorm2),
+        };
+    }
+
+    void packRgb10A2(std::span<const float4> tIn, std::span<u32> tOut)
+    {
+        ASSERT(tIn.size() == tOut.size());
+
+        using namespace simd;
+
+        // One color per 4 lanes, so the RGB and alpha scales are just another vector.
+        const f32x4 low   = splat(0.0f);
+        const f32x4 high  = splat(1.0f);
+        const f32x4 scale = set(cUnorm10, cUnorm10, cUnorm10, cUnorm2);
+
+        for (u64 i = 0; i < tIn.size(); ++i) {
+            f32 channels[4];
+            store(channels, roundNearest(mul(max(min(load(tIn[i].Ptr), high), low), scale)));
+
+            tOut[i] = u32(channels[0]) | (u32(channels[1]) << 10) | (u32(channels[2]) << 20) | (u32(channels[3]) << 30);
+        }
+    }
+
+    void unpackRgb10A2(std::span<const u32> tIn, std::span<float4> tOut)
+    {
+        ASSERT(tIn.size() == tOut.size());
+        for (u64 i = 0; i < tIn.size(); ++i) {
+            tOut[i] = unpackRgb10A2(tIn[i]);
+        }
+    }
+} // ct
@@ -0,0 +1,71 @@
+//
+// Conversions between f32 and the compact formats used for vertex and texture data.
+//
+//   Half      - IEEE binary16. Round to nearest even, denormals, infinities and NaNs are kept.
+//   Unorm     - [0, 1] mapped to [0, 2^n - 1].
+//   Snorm     - [-1, 1] mapped to [-(2^(n-1) - 1), 2^(n-1) - 1]. Both -MAX and -MAX - 1 decode to -1.
+//   Oct       - unit normals projected onto an octahedron and unfolded into a square, stored as two snorms.
+//               16 bits per component is visually lossless, 8 bits is good enough for most meshes.
+//   Rgb10A2   - unorm color, 10 bits for RGB and 2 for alpha, R in the low bits (DXGI_FORMAT_R10G10B10A2_UNORM).
+//
+// Quantizing clamps to the format's range, rounds to nearest even and maps NaN to the top of the range. The batch
+// versions produce the same bits as the single value functions. Half conversions use F16C when the target has it
+// (see CT_MATH_ENABLE_F16C), SSE2 otherwise.
+//
+// Batch input and output spans must have the same size.
+//
+
+#pragma once
+
+#include "Math.h"
+
+#include <span>
+
+namespace ct {
+    u16 floatToHalf(f32 tValue);
+    f32 halfToFloat(u16 tValue);
+
+    void floatToHalf(std::span<const f32> tIn, std::span<u16> tOut);
+    void halfToFloat(std::span<const u16> tIn, std::span<f32> tOut);
+
+    u8  packUnorm8(f32 tValue);
+    u16 packUnorm16(f32 tValue);
+    s8  packSnorm8(f32 tValue);
+    s16 packSnorm16(f32 tValue);
+
+    f32 unpackUnorm8(u8 tValue);
+    f32 unpackUnorm16(u16 tValue);
+    f32 unpackSnorm8(s8 tValue);
+    f32 unpackSnorm16(s16 tValue);
+
+    void packUnorm8(std::span<const f32> tIn, std::span<u8> tOut);
+    void packUnorm16(std::span<const f32> tIn, std::span<u16> tOut);
+    void packSnorm8(std::span<const f32> tIn, std::span<s8> tOut);
+    void packSnorm16(std::span<const f32> tIn, std::span<s16> tOut);
+
+    void unpackUnorm8(std::span<const u8> tIn, std::span<f32> tOut);
+    void unpackUnorm16(std::span<const u16> tIn, std::span<f32> tOut);
+    void unpackSnorm8(std::span<const s8> tIn, std::span<f32> tOut);
+    void unpackSnorm16(std::span<const s16> tIn, std::span<f32> tOut);
+
+    // Octahedral mapping of a unit vector into [-1, 1]^2 and back. Decoding always returns a unit vector.
+    float2 octahedralEncode(float3 tNormal);
+    float3 octahedralDecode(float2 tEncoded);
+
+    // X in the low half, Y in the high half.
+    u32    packNormalOct16(float3 tNormal);
+    u16    packNormalOct8(float3 tNormal);
+    float3 unpackNormalOct16(u32 tPacked);
+    float3 unpackNormalOct8(u16 tPacked);
+
+    void packNormalsOct16(std::span<const float3> tIn, std::span<u32> tOut);
+    void packNormalsOct8(std::span<const float3> tIn, std::span<u16> tOut);
+    void unpackNormalsOct16(std::span<const u32> tIn, std::span<float3> tOut);
+    void unpackNormalsOct8(std::span<const u16> tIn, std::span<float3> tOut);
+
+    u32    packRgb10A2(float4 tColor);
+    float4 unpackRgb10A2(u32 tPacked);
+
+    void packRgb10A2(std::span<const float4> tIn, std::span<u32> tOut);
+    void unpackRgb10A2(std::span<const u32> tIn, std::span<float4> tOut);
+} // ct
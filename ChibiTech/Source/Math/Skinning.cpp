@@ -0,0 +1,272 @@
+#include "Skinning.h"
+
+#include <Platform/Assert.h>
+
+#include <algorithm>
+
+namespace ct {
+    namespace {
+        using Lane = simd::f32xN;
+        constexpr u32 cLaneWidth = simd::cNativeWidth;
+
+        // One block of vertices transposed to SoA. Lanes past tCount are zero and have no influences, so they
+        // run through the same instructions without producing NaNs.
+        struct VertexBlock
+        {
+            f32 mPos[3][cLaneWidth]  = {};
+            f32 mNorm[3][cLaneWidth] = {};
+        };
+
+        void gatherBlock(const GeometryVertex* tVertices, u32 tCount, VertexBlock& tBlock)
+        {
+            for (u32 lane = 0; lane < tCount; ++lane) {
+                const GeometryVertex& vertex = tVertices[lane];
+                tBlock.mPos[0][lane]  = vertex.mPos.X;
+                tBlock.mPos[1][lane]  = vertex.mPos.Y;
+                tBlock.mPos[2][lane]  = vertex.mPos.Z;
+                tBlock.mNorm[0][lane] = vertex.mNorm.X;
+                tBlock.mNorm[1][lane] = vertex.mNorm.Y;
+                tBlock.mNorm[2][lane] = vertex.mNorm.Z;
+            }
+        }
+
+        void scatterBlock(const VertexBlock& tBlock, const GeometryVertex* tBindPose, u32 tCount, GeometryVertex* tOut)
+        {
+            for (u32 lane = 0; lane < tCount; ++lane) {
+                GeometryVertex& vertex = tOut[lane];
+                vertex.mPos  = { tBlock.mPos[0][lane],  tBlock.mPos[1][lane],  tBlock.mPos[2][lane] };
+                vertex.mNorm = { tBlock.mNorm[0][lane], tBlock.mNorm[1][lane], tBlock.mNorm[2][lane] };
+                vertex.mTex  = tBindPose[lane].mTex;
+            }
+        }
+
+        void normalize3(Lane& tX, Lane& tY, Lane& tZ)
+        {
+            using namespace simd;
+
+            // Dividing by one leaves zero-length normals untouched, same as float3::norm()
+            const Lane length = replaceZero(sqrt(add(add(mul(tX, tX), mul(tY, tY)), mul(tZ, tZ))), splatN(1.0f));
+            tX = div(tX, length);
+            tY = div(tY, length);
+            tZ = div(tZ, length);
+        }
+
+        void cross3(Lane tAX, Lane tAY, Lane tAZ, Lane tBX, Lane tBY, Lane tBZ, Lane& tX, Lane& tY, Lane& tZ)
+        {
+            using namespace simd;
+            tX = sub(mul(tAY, tBZ), mul(tAZ, tBY));
+            tY = sub(mul(tAZ, tBX), mul(tAX, tBZ));
+            tZ = sub(mul(tAX, tBY), mul(tAY, tBX));
+        }
+
+        // Calls tBlockFn(First, Count) for every block of cLaneWidth vertices, the last block may be partial.
+        template<typename BlockFn>
+        void forEachBlock(u64 tVertexCount, BlockFn&& tBlockFn)
+        {
+            for (u64 first = 0; first < tVertexCount; first += cLaneWidth) {
+                tBlockFn(first, (u32)std::min<u64>(cLaneWidth, tVertexCount - first));
+            }
+        }
+
+        void skinBlockLinear(const GeometryVertex* tBindPose, const SkinInfluence* tInfluences, u32 tCount,
+                             std::span<const mat4> tBones, GeometryVertex* tOut)
+        {
+            using namespace simd;
+
+            VertexBlock block;
+            gatherBlock(tBindPose, tCount, block);
+
+            // Blended upper 3x4 of the skinning matrix, row-major: M[Row * 4 + Col]
+            Lane matrix[12];
+            for (Lane& element : matrix) {
+                element = splatN(0.0f);
+            }
+
+            for (u32 influence = 0; influence < cMaxBoneInfluences; ++influence) {
+                f32  weights[cLaneWidth]  = {};
+                f32  rows[12][cLaneWidth] = {};
+                bool isUsed               = false;
+
+                for (u32 lane = 0; lane < tCount; ++lane) {
+                    const f32 weight = tInfluences[lane].mWeights[influence];
+                    if (weight == 0.0f) continue;
+
+                    const u16 bone = tInfluences[lane].mBones[influence];
+                    ASSERT(bone < tBones.size());
+
+                    const mat4& boneMatrix = tBones[bone];
+                    for (u32 row = 0; row < 3; ++row) {
+                        for (u32 col = 0; col < 4; ++col) {
+                            rows[row * 4 + col][lane] = boneMatrix.Ptr[col][row];
+                        }
+                    }
+
+                    weights[lane] = weight;
+                    isUsed        = true;
+                }
+
+                // Most vertices only use one or two bones
+                if (!isUsed) continue;
+
+                const Lane weight = loadN(weights);
+                for (u32 element = 0; element < 12; ++element) {
+                    matrix[element] = add(matrix[element], mul(weight, loadN(rows[element])));
+                }
+            }
+
+            const Lane px = loadN(block.mPos[0]),  py = loadN(block.mPos[1]),  pz = loadN(block.mPos[2]);
+            const Lane nx = loadN(block.mNorm[0]), ny = loadN(block.mNorm[1]), nz = loadN(block.mNorm[2]);
+
+            Lane normal[3];
+            for (u32 row = 0; row < 3; ++row) {
+                const Lane* m = &matrix[row * 4];
+
+                Lane pos = add(add(add(mul(px, m[0]), mul(py, m[1])), mul(pz, m[2])), m[3]);
+                storeN(block.mPos[row], pos);
+
+                normal[row] = add(add(mul(nx, m[0]), mul(ny, m[1])), mul(nz, m[2]));
+            }
+
+            normalize3(normal[0], normal[1], normal[2]);
+            for (u32 row = 0; row < 3; ++row) {
+                storeN(block.mNorm[row], normal[row]);
+            }
+
+            scatterBlock(block, tBindPose, tCount, tOut);
+        }
+
+        void skinBlockDualQuaternion(const GeometryVertex* tBindPose, const SkinInfluence* tInfluences, u32 tCount,
+                                     std::span<const dualQuaternion> tBones, GeometryVertex* tOut)
+        {
+            using namespace simd;
+
+            VertexBlock block;
+            gatherBlock(tBindPose, tCount, block);
+
+            // Blended Real (x, y, z, w) followed by Dual (x, y, z, w)
+            Lane blended[8];
+            for (Lane& element : blended) {
+                element = splatN(0.0f);
+            }
+
+            for (u32 influence = 0; influence < cMaxBoneInfluences; ++influence) {
+                f32  weights[cLaneWidth]       = {};
+                f32  components[8][cLaneWidth] = {};
+                bool isUsed                    = false;
+
+                for (u32 lane = 0; lane < tCount; ++lane) {
+                    const SkinInfluence& influences = tInfluences[lane];
+
+                    f32 weight = influences.mWeights[influence];
+                    if (weight == 0.0f) continue;
+
+                    const u16 bone = influences.mBones[influence];
+                    ASSERT(bone < tBones.size() && influences.mBones[0] < tBones.size());
+
+                    // q and -q are the same rotation. Keep every influence in the hemisphere of the first one,
+                    // otherwise blending two nearly identical rotations can cancel out.
+                    const dualQuaternion& transform = tBones[bone];
+                    if (dot(transform.Real, tBones[influences.mBones[0]].Real) < 0.0f) {
+                        weight = -weight;
+                    }
+
+                    components[0][lane] = transform.Real.X;
+                    components[1][lane] = transform.Real.Y;
+                    components[2][lane] = transform.Real.Z;
+                    components[3][lane] = transform.Real.Theta;
+                    components[4][lane] = transform.Dual.X;
+                    components[5][lane] = transform.Dual.Y;
+                    components[6][lane] = transform.Dual.Z;
+                    components[7][lane] = transform.Dual.Theta;
+
+                    weights[lane] = weight;
+                    isUsed        = true;
+                }
+
+                if (!isUsed) continue;
+
+                const Lane weight = loadN(weights);
+                for (u32 element = 0; element < 8; ++element) {
+                    blended[element] = add(blended[element], mul(weight, loadN(components[element])));
+                }
+            }
+
+            // Normalize by the length of the real part, which keeps the dual quaternion a rigid transform.
+            const Lane length = replaceZero(sqrt(add(add(mul(blended[0], blended[0]), mul(blended[1], blended[1])),
+                                                     add(mul(blended[2], blended[2]), mul(blended[3], blended[3])))),
+                                            splatN(1.0f));
+            for (Lane& element : blended) {
+                element = div(element, length);
+            }
+
+            const Lane rx = blended[0], ry = blended[1], rz = blended[2], rw = blended[3];
+            const Lane dx = blended[4], dy = blended[5], dz = blended[6], dw = blended[7];
+            const Lane two = splatN(2.0f);
+
+            // Translation = 2 * (rw * d.xyz - dw * r.xyz + cross(r.xyz, d.xyz))
+            Lane tx, ty, tz;
+            cross3(rx, ry, rz, dx, dy, dz, tx, ty, tz);
+            tx = mul(add(sub(mul(rw, dx), mul(dw, rx)), tx), two);
+            ty = mul(add(sub(mul(rw, dy), mul(dw, ry)), ty), two);
+            tz = mul(add(sub(mul(rw, dz), mul(dw, rz)), tz), two);
+
+            // Same as rotateVector(): v + w * T + cross(r.xyz, T) with T = 2 * cross(r.xyz, v)
+            auto rotate = [&](Lane& tX, Lane& tY, Lane& tZ) {
+                Lane cx, cy, cz;
+                cross3(rx, ry, rz, tX, tY, tZ, cx, cy, cz);
+                cx = mul(cx, two);
+                cy = mul(cy, two);
+                cz = mul(cz, two);
+
+                Lane ux, uy, uz;
+                cross3(rx, ry, rz, cx, cy, cz, ux, uy, uz);
+                tX = add(add(tX, mul(cx, rw)), ux);
+                tY = add(add(tY, mul(cy, rw)), uy);
+                tZ = add(add(tZ, mul(cz, rw)), uz);
+            };
+
+            Lane px = loadN(block.mPos[0]), py = loadN(block.mPos[1]), pz = loadN(block.mPos[2]);
+            rotate(px, py, pz);
+            storeN(block.mPos[0], add(px, tx));
+            storeN(block.mPos[1], add(py, ty));
+            storeN(block.mPos[2], add(pz, tz));
+
+            Lane nx = loadN(block.mNorm[0]), ny = loadN(block.mNorm[1]), nz = loadN(block.mNorm[2]);
+            rotate(nx, ny, nz);
+            storeN(block.mNorm[0], nx);
+            storeN(block.mNorm[1], ny);
+            storeN(block.mNorm[2], nz);
+
+            scatterBlock(block, tBindPose, tCount, tOut);
+        }
+    }
+
+    void skinVertices(std::span<const GeometryVertex> tBindPose, std::span<const SkinInfluence> tInfluences,
+                      std::span<const mat4> tBoneMatrices, std::span<GeometryVertex> tOut)
+    {
+        ASSERT(tBindPose.size() == tInfluences.size() && tBindPose.size() == tOut.size());
+
+        forEachBlock(tBindPose.size(), [&](u64 tFirst, u32 tCount) {
+            skinBlockLinear(tBindPose.data() + tFirst, tInfluences.data() + tFirst, tCount, tBoneMatrices, tOut.data() + tFirst);
+        });
+    }
+
+    void skinVertices(std::span<const GeometryVertex> tBindPose, std::span<const SkinInfluence> tInfluences,
+                      std::span<const dualQuaternion> tBones, std::span<GeometryVertex> tOut)
+    {
+        ASSERT(tBindPose.size() == tInfluences.size() && tBindPose.size() == tOut.size());
+
+        forEachBlock(tBindPose.size(), [&](u64 tFirst, u32 tCount) {
+            skinBlockDualQuaternion(tBindPose.data() + tFirst, tInfluences.data() + tFirst, tCount, tBones, tOut.data() + tFirst);
+        });
+    }
+
+    void buildDualQuaternionPalette(std::span<const mat4> tBoneMatrices, std::span<dualQuaternion> tOut)
+    {
+        ASSERT(tBoneMatrices.size() == tOut.size());
+
+        for (size_t i = 0; i < tBoneMatrices.size(); ++i) {
+            tOut[i] = mat4ToDualQuaternion(tBoneMatrices[i]);
+        }
+    }
+} // ct
@@ -0,0 +1,44 @@
+//
+// CPU skinning for GeometryVertex streams.
+//
+// Two blending modes are supported:
+//   Linear blend - blends the bone matrices per vertex. Cheap, handles scale, but volumes collapse around
+//                  twisting joints ("candy wrapper").
+//   Dual quaternion - blends rigid transforms as dual quaternions. Preserves volume, but bones must be rigid
+//                  (rotation + translation only).
+//
+// Both kernels skin one vertex per SIMD lane (8 with AVX, 4 with SSE/NEON). Bone data is gathered per lane, so
+// the influence streams can reference any bone in any order.
+//
+
+#pragma once
+
+#include "Geometry.h"
+
+#include <span>
+
+namespace ct {
+    constexpr u32 cMaxBoneInfluences = 4;
+
+    // Unused slots must have a weight of zero. Weights of a vertex are expected to sum to one.
+    struct SkinInfluence
+    {
+        u16 mBones[cMaxBoneInfluences];
+        f32 mWeights[cMaxBoneInfluences];
+    };
+
+    // Linear blend skinning. tBoneMatrices are the final skinning matrices (bone pose * inverse bind pose).
+    // Normals are transformed by the blended upper 3x3 and renormalized, which is exact for rotations and
+    // uniform scale.
+    //
+    // tBindPose, tInfluences and tOut must have the same size. tOut may alias tBindPose.
+    void skinVertices(std::span<const GeometryVertex> tBindPose, std::span<const SkinInfluence> tInfluences,
+                      std::span<const mat4> tBoneMatrices, std::span<GeometryVertex> tOut);
+
+    // Dual quaternion skinning, see buildDualQuaternionPalette to convert a matrix palette.
+    void skinVertices(std::span<const GeometryVertex> tBindPose, std::span<const SkinInfluence> tInfluences,
+                      std::span<const dualQuaternion> tBones, std::span<GeometryVertex> tOut);
+
+    // Converts rigid skinning matrices to unit dual quaternions. Any scale in the matrices is dropped.
+    void buildDualQuaternionPalette(std::span<const mat4> tBoneMatrices, std::span<dualQuaternion> tOut);
+} // ct
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include <Types.h>
+
+namespace ct::os {
+    struct CpuLogicalCore
+    {
+        u32  mLogicalId{0};      // OS processor index, used for pinning
+        u32  mPhysicalCoreId{0}; // Dense index of the physical core this logical core belongs to
+        u32  mPackageId{0};      // Socket
+        u32  mCacheDomainId{0};  // Dense index of the last-level (L3) cache this core shares
+        u32  mNumaNode{0};
+        bool mIsSmtSibling{false}; // True for every hardware thread of a core except the first
+    };
+
+    struct CpuTopology
+    {
+        std::vector<CpuLogicalCore> mLogicalCores{};
+        u32                         mPhysicalCoreCount{0};
+        u32                         mCacheDomainCount{0};
+        u32                         mNumaNodeCount{0};
+        u32                         mCpuQuota{0}; // Cores worth of CPU time the OS grants the process, 0 if unlimited
+
+        [[nodiscard]] u32 getLogicalCoreCount() const { return (u32)mLogicalCores.size(); }
+    };
+
+    // Queries the processor layout from the OS. Only the logical cores the process is allowed to run on are reported
+    // (affinity mask, cpuset). If the OS does not expose the layout, every logical core is reported as its own
+    // physical core in a single cache domain and NUMA node.
+    [[nodiscard]] CpuTopology queryCpuTopology();
+
+    // Pins the calling thread to a single logical core. Returns false if the OS rejected the request.
+    bool setCurrentThreadAffinity(u32 tLogicalCoreId);
+}
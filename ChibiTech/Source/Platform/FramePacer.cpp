@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "FramePacer.h"
+
+#include <thread>
+#include <algorithm>
+
+namespace ct::os {
+    // A 50 ms hiccup at 60 Hz must not leave a spin window longer than the frame, and the window must still follow
+    // ordinary oversleep and decay back down.
+    static_assert(FramePacer::getAdaptedSpinSeconds(0.0003, 0.050, 1.0 / 60.0) <= 0.002);
+    static_assert(FramePacer::getAdaptedSpinSeconds(0.0003, 0.050, 1.0 / 500.0) <= 0.25 / 500.0);
+    static_assert(FramePacer::getAdaptedSpinSeconds(0.0003, 0.001, 1.0 / 60.0) == 0.001 * 1.25);
+    static_assert(FramePacer::getAdaptedSpinSeconds(0.001, 0.0, 1.0 / 60.0) < 0.001);
+    static_assert(FramePacer::getAdaptedSpinSeconds(0.0003, 0.0, 0.0) == 0.0003);
+
+    void FramePacer::setTargetFrameRate(f64 tTargetFrameRateHz)
+    {
+        mTargetFrameRateHz = tTargetFrameRateHz;
+        mPeriod            = Duration(tTargetFrameRateHz > 0.0 ? 1.0 / tTargetFrameRateHz : 0.0);
+
+        // Restart the timeline so a rate change doesn't inherit the old schedule.
+        mHasStarted = false;
+    }
+
+    void FramePacer::waitForNextFrame()
+    {
+        TimePoint now = Clock::now();
+
+        if (!mHasStarted) {
+            mHasStarted     = true;
+            mLastFrameStart = now;
+            mNextDeadline   = now;
+        }
+
+        if (!isUncapped()) {
+            mNextDeadline += std::chrono::duration_cast<Clock::duration>(mPeriod);
+
+            // Far behind schedule (a hitch, a breakpoint, a window drag), start a fresh timeline.
+            if (now - mNextDeadline > mPeriod * cResyncPeriods) {
+                mNextDeadline = now;
+            }
+
+            // Coarse sleep, leaving a spin window to absorb the scheduler's wakeup latency.
+            const Duration remaining = mNextDeadline - now;
+            const Duration sleepFor  = remaining - Duration(mSpinSeconds);
+            if (sleepFor.count() > 0.0) {
+                const TimePoint expectedWake = now + std::chrono::duration_cast<Clock::duration>(sleepFor);
+                std::this_thread::sleep_for(sleepFor);
+
+                const f64 oversleep = Duration(Clock::now() - expectedWake).count();
+                mSpinSeconds = getAdaptedSpinSeconds(mSpinSeconds, oversleep, mPeriod.count());
+            }
+
+            // Fine wait
+            while (Clock::now() < mNextDeadline) {
+                std::this_thread::yield();
+            }
+
+            now = Clock::now();
+            mLastDriftSeconds = Duration(now - mNextDeadline).count();
+        }
+
+        recordFrame(now);
+    }
+
+    void FramePacer::recordFrame(TimePoint tFrameStart)
+    {
+        const f64 frameMS = Duration(tFrameStart - mLastFrameStart).count() * 1000.0;
+        mLastFrameStart = tFrameStart;
+
+        // The very first call has nothing to measure against.
+        if (frameMS <= 0.0) {
+            return;
+        }
+
+        mFrameTimesMS[mNextSample] = (f32)frameMS;
+        mNextSample = (mNextSample + 1) % cSampleCount;
+        mNumSamples = std::min(mNumSamples + 1, cSampleCount);
+    }
+
+    FrameTimeStats FramePacer::getFrameTimeStats() const
+    {
+        FrameTimeStats stats{};
+        if (mNumSamples == 0) {
+            return stats;
+        }
+
+        std::array<f32, cSampleCount> sorted = mFrameTimesMS;
+        std::sort(sorted.begin(), sorted.begin() + mNumSamples);
+
+        // Nearest-rank percentile
+        const auto percentile = [&](f64 tPercent) -> f64 {
+            const u32 rank = (u32)std::ceil(tPercent * mNumSamples);
+            return sorted[std::clamp(rank, 1u, mNumSamples) - 1];
+        };
+
+        f64 total = 0.0;
+        for (u32 i = 0; i < mNumSamples; ++i) {
+            total += sorted[i];
+        }
+
+        stats.mAverageMS   = total / mNumSamples;
+        stats.mP50MS       = percentile(0.50);
+        stats.mP95MS       = percentile(0.95);
+        stats.mP99MS       = percentile(0.99);
+        stats.mMaxMS       = sorted[mNumSamples - 1];
+        stats.mSampleCount = mNumSamples;
+        return stats;
+    }
+}
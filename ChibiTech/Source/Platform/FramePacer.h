@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../Types.h"
+
+#include <chrono>
+#include <array>
+#include <algorithm>
+
+namespace ct::os {
+    struct FrameTimeStats
+    {
+        f64 mAverageMS{0.0};
+        f64 mP50MS{0.0};
+        f64 mP95MS{0.0};
+        f64 mP99MS{0.0};
+        f64 mMaxMS{0.0};
+        u32 mSampleCount{0};
+    };
+
+    // Paces the main loop to a target frame rate.
+    //
+    // Frames are scheduled against an absolute timeline (start + N * period) rather than "sleep for whatever is
+    // left", so rounding error and oversleep in one frame are paid back in the next instead of accumulating.
+    // The wait sleeps coarsely until shortly before the deadline and spins for the remainder. The spin window
+    // grows to cover the worst oversleep the OS has shown recently, up to a small part of the period.
+    class FramePacer
+    {
+    public:
+        using Clock     = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+        using Duration  = std::chrono::duration<f64, std::ratio<1>>;
+
+        static constexpr u32 cSampleCount = 256;
+
+        explicit FramePacer(f64 tTargetFrameRateHz = 60.0) { setTargetFrameRate(tTargetFrameRateHz); }
+
+        // A rate <= 0 disables pacing, waitForNextFrame() then only records frame times.
+        void setTargetFrameRate(f64 tTargetFrameRateHz);
+        [[nodiscard]] f64 getTargetFrameRate() const { return mTargetFrameRateHz; }
+        [[nodiscard]] bool isUncapped() const { return mTargetFrameRateHz <= 0.0; }
+
+        // Call once at the end of each frame. Blocks until the next frame should start.
+        void waitForNextFrame();
+
+        // Percentiles over the last cSampleCount frames, measured start-to-start (including the wait).
+        [[nodiscard]] FrameTimeStats getFrameTimeStats() const;
+
+        // How far the last frame started from its scheduled time. Positive means late.
+        [[nodiscard]] f64 getLastDriftMS() const { return mLastDriftSeconds * 1000.0; }
+
+    private:
+        // Never spin for less than this. Sleeps shorter than this aren't worth the wakeup jitter.
+        static constexpr f64 cMinSpinSeconds = 0.0003;
+        // Never spin for more than this, or for more than cMaxSpinFraction of the period. A single large oversleep
+        // (a hitch, the OS paging) would otherwise leave the pacer burning a core for hundreds of frames.
+        static constexpr f64 cMaxSpinSeconds  = 0.002;
+        static constexpr f64 cMaxSpinFraction = 0.25;
+        // A frame that misses its deadline by more than this many periods resyncs the timeline instead of trying to
+        // catch up with a burst of unpaced frames.
+        static constexpr f64 cResyncPeriods  = 2.0;
+
+        void recordFrame(TimePoint tFrameStart);
+
+    public:
+        // Spin window for the next frame: grows immediately when the OS overshoots, decays slowly back toward the
+        // minimum, and stays within the caps above.
+        static constexpr f64 getAdaptedSpinSeconds(f64 tSpinSeconds, f64 tOversleepSeconds, f64 tPeriodSeconds)
+        {
+            const f64 maxSpin = std::max(cMinSpinSeconds, std::min(cMaxSpinSeconds, tPeriodSeconds * cMaxSpinFraction));
+            const f64 wanted  = std::max(tOversleepSeconds * 1.25, tSpinSeconds * 0.99);
+            return std::clamp(wanted, cMinSpinSeconds, maxSpin);
+        }
+
+    private:
+
+        f64       mTargetFrameRateHz{60.0};
+        Duration  mPeriod{0.0};
+        TimePoint mNextDeadline{};
+        TimePoint mLastFrameStart{};
+        bool      mHasStarted{false};
+
+        f64       mSpinSeconds{cMinSpinSeconds};
+        f64       mLastDriftSeconds{0.0};
+
+        std::array<f32, cSampleCount> mFrameTimesMS{};
+        u32                           mNextSample{0};
+        u32                           mNumSamples{0};
+    };
+}
@@ -2,6 +2,12 @@
 
 #include <chrono>
 #include <thread>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "../Platform.h"
 #include "../Assert.h"
@@ -42,6 +48,92 @@ namespace ct::os {
     void debugBreak [[noreturn]]() {
         exitProgram();
     }
+
+    bool writeBufferToFile(const std::filesystem::path& tFilepath, void* tBuffer, size_t tBufferSize, bool tAppend) {
+        FILE* file = fopen(tFilepath.c_str(), tAppend ? "ab" : "wb");
+        if (!file) {
+            ct::console::error("Unable to open file: %s", tFilepath.c_str());
+            return false;
+        }
+
+        const bool result = fwrite(tBuffer, 1, tBufferSize, file) == tBufferSize;
+        fclose(file);
+        return result;
+    }
+
+    bool readEntireFileToBuffer(const std::filesystem::path& tFilepath, void** tOutBuffer, size_t* tOutBufferSize) {
+        FILE* file = fopen(tFilepath.c_str(), "rb");
+        if (!file) {
+            ct::console::error("Unable to open file: %s", tFilepath.c_str());
+            return false;
+        }
+
+        *tOutBuffer     = nullptr;
+        *tOutBufferSize = 0;
+
+        // fopen also opens directories, which have no meaningful size. Only read regular files.
+        struct stat fileInfo = {};
+        if (fstat(fileno(file), &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode)) {
+            ct::console::error("Not a readable file: %s", tFilepath.c_str());
+            fclose(file);
+            return false;
+        }
+        const long fileSize = long(fileInfo.st_size);
+
+        // malloc(0) may return nullptr, an empty file still gets a buffer the caller can free.
+        void* buffer = malloc(fileSize > 0 ? size_t(fileSize) : 1);
+        if (!buffer) {
+            ct::console::error("Unable to allocate %ld bytes for file: %s", fileSize, tFilepath.c_str());
+            fclose(file);
+            return false;
+        }
+
+        // The file can shrink between fstat and fread, a short read is an error rather than a partial buffer.
+        if (fread(buffer, 1, size_t(fileSize), file) != size_t(fileSize)) {
+            ct::console::error("Unable to read file: %s", tFilepath.c_str());
+            free(buffer);
+            fclose(file);
+            return false;
+        }
+
+        fclose(file);
+        *tOutBuffer     = buffer;
+        *tOutBufferSize = size_t(fileSize);
+        return true;
+    }
+
+    bool mapFileReadOnly(const std::filesystem::path& tFilepath, MappedFile* tOutFile) {
+        const int fd = open(tFilepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            ct::console::error("Unable to open file: %s", tFilepath.c_str());
+            return false;
+        }
+
+        struct stat fileInfo = {};
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size == 0) {
+            close(fd);
+            return false;
+        }
+
+        // The mapping keeps its own reference to the file, so the descriptor can be closed right away.
+        void* view = mmap(nullptr, size_t(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+
+        tOutFile->mData   = view;
+        tOutFile->mSize   = size_t(fileInfo.st_size);
+        tOutFile->mHandle = nullptr;
+        return true;
+    }
+
+    void unmapFile(MappedFile* tFile) {
+        if (tFile->mData) {
+            munmap(const_cast<void*>(tFile->mData), tFile->mSize);
+        }
+        *tFile = {};
+    }
 }
 
 namespace ct::console {
@@ -0,0 +1,293 @@
+#include "stdafx.h"
+
+#include <cmath>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <map>
+#include <set>
+#include <string>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "../CpuTopology.h"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    const fs::path cSysCpuPath  = "/sys/devices/system/cpu";
+    const fs::path cSysNodePath = "/sys/devices/system/node";
+
+    bool readFirstLine(const fs::path& tPath, std::string& tOutLine) {
+        std::ifstream file(tPath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        return (bool)std::getline(file, tOutLine);
+    }
+
+    bool readU32(const fs::path& tPath, u32& tOutValue) {
+        std::string line{};
+        if (!readFirstLine(tPath, line) || line.empty()) {
+            return false;
+        }
+
+        tOutValue = (u32)std::strtoul(line.c_str(), nullptr, 10);
+        return true;
+    }
+
+    // Parses the kernel's cpu list format, e.g. "0-3,8,10-11".
+    std::vector<u32> parseCpuList(std::string_view tList) {
+        std::vector<u32> result{};
+
+        size_t start = 0;
+        while (start < tList.size()) {
+            size_t end = tList.find(',', start);
+            if (end == std::string_view::npos) {
+                end = tList.size();
+            }
+
+            const std::string range(tList.substr(start, end - start));
+            if (!range.empty()) {
+                char* dash = nullptr;
+                const u32 first = (u32)std::strtoul(range.c_str(), &dash, 10);
+                const u32 last  = (dash && *dash == '-') ? (u32)std::strtoul(dash + 1, nullptr, 10) : first;
+
+                for (u32 cpu = first; cpu <= last; ++cpu) {
+                    result.push_back(cpu);
+                }
+            }
+
+            start = end + 1;
+        }
+
+        return result;
+    }
+
+    std::vector<u32> readCpuList(const fs::path& tPath) {
+        std::string line{};
+        if (!readFirstLine(tPath, line)) {
+            return {};
+        }
+        return parseCpuList(line);
+    }
+
+    // Returns the lowest cpu sharing the last level cache with tCpu, which is a stable key for the cache domain.
+    u32 findLastLevelCacheKey(u32 tCpu) {
+        const fs::path cachePath = cSysCpuPath / ("cpu" + std::to_string(tCpu)) / "cache";
+
+        u32 bestLevel = 0;
+        u32 bestKey   = tCpu;
+
+        std::error_code ec{};
+        for (const auto& entry : fs::directory_iterator(cachePath, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind("index", 0) != 0) {
+                continue;
+            }
+
+            u32 level = 0;
+            if (!readU32(entry.path() / "level", level) || level < bestLevel) {
+                continue;
+            }
+
+            std::string type{};
+            if (readFirstLine(entry.path() / "type", type) && type == "Instruction") {
+                continue;
+            }
+
+            const std::vector<u32> shared = readCpuList(entry.path() / "shared_cpu_list");
+            if (!shared.empty()) {
+                bestLevel = level;
+                bestKey   = *std::min_element(shared.begin(), shared.end());
+            }
+        }
+
+        return bestKey;
+    }
+
+    // Cpus this process may run on: sched_getaffinity reflects taskset, numactl and cgroup cpusets alike. Empty if
+    // the mask can't be read, in which case every online cpu counts.
+    std::set<u32> readAllowedCpus() {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+            return {};
+        }
+
+        std::set<u32> result{};
+        for (u32 cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet)) {
+                result.insert(cpu);
+            }
+        }
+        return result;
+    }
+
+    // Reads a cgroup quota/period pair as a number of cores, 0 if unlimited or unreadable.
+    f64 parseCpuQuota(const std::string& tQuota, const std::string& tPeriod) {
+        if (tQuota.empty() || tQuota == "max" || tQuota[0] == '-') {
+            return 0.0;
+        }
+
+        const f64 quota  = std::strtod(tQuota.c_str(), nullptr);
+        const f64 period = std::strtod(tPeriod.c_str(), nullptr);
+        return (quota > 0.0 && period > 0.0) ? quota / period : 0.0;
+    }
+
+    // CPU time limit of the process' cgroup in whole cores (rounded up), 0 if there is none. Unlike a cpuset, a
+    // quota doesn't show up in the affinity mask: a container limited to 2 cpus still sees and may run on all of them.
+    u32 readCgroupCpuQuota() {
+        f64 limit = 0.0;
+        const auto applyLimit = [&](f64 tCores) {
+            if (tCores > 0.0 && (limit == 0.0 || tCores < limit)) {
+                limit = tCores;
+            }
+        };
+
+        std::ifstream cgroups("/proc/self/cgroup");
+        std::string line{};
+        while (std::getline(cgroups, line)) {
+            // cgroup v2 is the single "0::<path>" entry. A quota anywhere up the hierarchy applies, take the lowest.
+            if (line.rfind("0::", 0) == 0) {
+                const fs::path cgroupRoot   = "/sys/fs/cgroup";
+                const fs::path relativePath = fs::path(line.substr(3)).relative_path();
+
+                fs::path cgroup = relativePath.empty() ? cgroupRoot : cgroupRoot / relativePath;
+                while (true) {
+                    std::string cpuMax{};
+                    if (readFirstLine(cgroup / "cpu.max", cpuMax)) {
+                        const size_t space = cpuMax.find(' ');
+                        if (space != std::string::npos) {
+                            applyLimit(parseCpuQuota(cpuMax.substr(0, space), cpuMax.substr(space + 1)));
+                        }
+                    }
+
+                    if (cgroup == cgroupRoot || !cgroup.has_parent_path() || cgroup.parent_path() == cgroup) {
+                        break;
+                    }
+                    cgroup = cgroup.parent_path();
+                }
+            }
+        }
+
+        // cgroup v1, as mounted inside most containers.
+        std::string quota{};
+        std::string period{};
+        if (readFirstLine("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", quota) && readFirstLine("/sys/fs/cgroup/cpu/cpu.cfs_period_us", period)) {
+            applyLimit(parseCpuQuota(quota, period));
+        }
+
+        return limit > 0.0 ? (u32)std::ceil(limit) : 0;
+    }
+
+    // Remaps sparse keys (package/core ids, lowest-cpu keys) to dense indices in order of first appearance.
+    struct DenseIdMap {
+        u32 get(u64 tKey) {
+            auto [iter, inserted] = mIds.try_emplace(tKey, (u32)mIds.size());
+            return iter->second;
+        }
+
+        [[nodiscard]] u32 count() const { return (u32)mIds.size(); }
+
+        std::map<u64, u32> mIds{};
+    };
+}
+
+namespace ct::os {
+    CpuTopology queryCpuTopology() {
+        CpuTopology result{};
+        result.mCpuQuota = readCgroupCpuQuota();
+
+        const std::set<u32> allowedCpus = readAllowedCpus();
+        const auto isAllowed = [&](u32 tCpu) { return allowedCpus.empty() || allowedCpus.contains(tCpu); };
+
+        std::vector<u32> onlineCpus = readCpuList(cSysCpuPath / "online");
+        std::erase_if(onlineCpus, [&](u32 tCpu) { return !isAllowed(tCpu); });
+
+        if (onlineCpus.empty()) {
+            // No sysfs (containers, exotic kernels): report a flat topology of the cpus we may run on.
+            std::vector<u32> cpus(allowedCpus.begin(), allowedCpus.end());
+            if (cpus.empty()) {
+                for (u32 cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            for (u32 index = 0; index < (u32)cpus.size(); ++index) {
+                result.mLogicalCores.push_back({ .mLogicalId = cpus[index], .mPhysicalCoreId = index });
+            }
+
+            result.mPhysicalCoreCount = (u32)cpus.size();
+            result.mCacheDomainCount  = 1;
+            result.mNumaNodeCount     = 1;
+            return result;
+        }
+
+        // Map each cpu to its NUMA node. Kernels without NUMA support do not expose the node directory.
+        std::map<u32, u32> cpuToNode{};
+        {
+            std::error_code ec{};
+            for (const auto& entry : fs::directory_iterator(cSysNodePath, ec)) {
+                const std::string name = entry.path().filename().string();
+                if (name.rfind("node", 0) != 0 || name.size() <= 4 || !std::isdigit((unsigned char)name[4])) {
+                    continue;
+                }
+
+                const u32 node = (u32)std::strtoul(name.c_str() + 4, nullptr, 10);
+                for (const u32 cpu : readCpuList(entry.path() / "cpulist")) {
+                    cpuToNode[cpu] = node;
+                }
+            }
+        }
+
+        DenseIdMap physicalCores{};
+        DenseIdMap cacheDomains{};
+        DenseIdMap numaNodes{};
+
+        for (const u32 cpu : onlineCpus) {
+            const fs::path topologyPath = cSysCpuPath / ("cpu" + std::to_string(cpu)) / "topology";
+
+            u32 packageId = 0;
+            u32 coreId    = cpu;
+            readU32(topologyPath / "physical_package_id", packageId);
+            readU32(topologyPath / "core_id", coreId);
+
+            // The first allowed cpu in the sibling list is treated as the "real" core, the rest are SMT siblings.
+            std::vector<u32> siblings = readCpuList(topologyPath / "thread_siblings_list");
+            std::erase_if(siblings, [&](u32 tSibling) { return !isAllowed(tSibling); });
+            const bool isSmtSibling = !siblings.empty() && *std::min_element(siblings.begin(), siblings.end()) != cpu;
+
+            const auto nodeIter = cpuToNode.find(cpu);
+            const u32  node     = (nodeIter != cpuToNode.end()) ? nodeIter->second : 0;
+
+            result.mLogicalCores.push_back({
+                .mLogicalId      = cpu,
+                .mPhysicalCoreId = physicalCores.get((u64(packageId) << 32) | coreId),
+                .mPackageId      = packageId,
+                .mCacheDomainId  = cacheDomains.get(findLastLevelCacheKey(cpu)),
+                .mNumaNode       = numaNodes.get(node),
+                .mIsSmtSibling   = isSmtSibling,
+            });
+        }
+
+        result.mPhysicalCoreCount = physicalCores.count();
+        result.mCacheDomainCount  = cacheDomains.count();
+        result.mNumaNodeCount     = numaNodes.count();
+        return result;
+    }
+
+    bool setCurrentThreadAffinity(u32 tLogicalCoreId) {
+        if (tLogicalCoreId >= CPU_SETSIZE) {
+            return false;
+        }
+
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(tLogicalCoreId, &cpuSet);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+    }
+}
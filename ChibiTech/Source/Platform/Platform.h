@@ -25,5 +25,17 @@ namespace ct {
         bool writeBufferToFile(const std::filesystem::path& tFilepath, void* tBuffer, size_t tBufferSize, bool tAppend = false);
         // Buffer allocated with "malloc" and must be freed with a corresponding "free"
         bool readEntireFileToBuffer(const std::filesystem::path& tFilepath, void** tOutBuffer, size_t* tOutBufferSize);
+
+        // Read-only view of an entire file, paged in by the OS on first touch. Valid until unmapFile is called.
+        struct MappedFile
+        {
+            const void* mData{nullptr};
+            size_t      mSize{0};
+            void*       mHandle{nullptr}; // Platform mapping handle, if the platform needs one
+        };
+
+        // Fails for missing or empty files.
+        bool mapFileReadOnly(const std::filesystem::path& tFilepath, MappedFile* tOutFile);
+        void unmapFile(MappedFile* tFile);
     }
 }
\ No newline at end of file
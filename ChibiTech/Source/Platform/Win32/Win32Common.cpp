@@ -155,7 +155,7 @@ namespace ct {
             if (fileHandle == INVALID_HANDLE_VALUE)
             {
                 DWORD error = GetLastError();
-                ct::console::error("Unable to open file: %s, with error: %d", tFilepath.c_str(), error);
+                ct::console::error("Unable to open file: %ls, with error: %d", tFilepath.c_str(), error);
                 CloseHandle(fileHandle);
                 return false;
             }
@@ -181,5 +181,53 @@ namespace ct {
             CloseHandle(fileHandle);
             return true;
         }
+
+        bool mapFileReadOnly(const std::filesystem::path& tFilepath, MappedFile* tOutFile) {
+            std::wstring pathAsWide = tFilepath.wstring();
+
+            HANDLE fileHandle = CreateFileW(pathAsWide.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (fileHandle == INVALID_HANDLE_VALUE)
+            {
+                DWORD error = GetLastError();
+                ct::console::error("Unable to open file: %ls, with error: %d", tFilepath.c_str(), error);
+                return false;
+            }
+
+            LARGE_INTEGER fileSize = {};
+            if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+            {
+                CloseHandle(fileHandle);
+                return false;
+            }
+
+            // The mapping keeps the file open, so the file handle can be closed right away.
+            HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(fileHandle);
+            if (mappingHandle == nullptr)
+            {
+                return false;
+            }
+
+            const void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (view == nullptr)
+            {
+                CloseHandle(mappingHandle);
+                return false;
+            }
+
+            tOutFile->mData   = view;
+            tOutFile->mSize   = size_t(fileSize.QuadPart);
+            tOutFile->mHandle = mappingHandle;
+            return true;
+        }
+
+        void unmapFile(MappedFile* tFile) {
+            if (tFile->mData)
+            {
+                UnmapViewOfFile(tFile->mData);
+                CloseHandle((HANDLE)tFile->mHandle);
+            }
+            *tFile = {};
+        }
     }
 }
\ No newline at end of file
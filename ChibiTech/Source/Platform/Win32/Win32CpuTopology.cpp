@@ -0,0 +1,229 @@
+#include "stdafx.h"
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "../CpuTopology.h"
+#include "../Assert.h"
+
+namespace {
+    // Windows numbers logical processors per processor group of up to 64. The topology flattens (group, number)
+    // into one logical id, setCurrentThreadAffinity splits it back up.
+    constexpr u32 cGroupWidth = sizeof(KAFFINITY) * 8;
+
+    u32 makeLogicalId(WORD tGroup, u32 tNumber) { return u32(tGroup) * cGroupWidth + tNumber; }
+
+    std::vector<u8> queryProcessorInformation(LOGICAL_PROCESSOR_RELATIONSHIP tRelationship) {
+        DWORD bufferSize = 0;
+        GetLogicalProcessorInformationEx(tRelationship, nullptr, &bufferSize);
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || bufferSize == 0) {
+            return {};
+        }
+
+        std::vector<u8> buffer(bufferSize);
+        auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+        if (!GetLogicalProcessorInformationEx(tRelationship, info, &bufferSize)) {
+            return {};
+        }
+
+        return buffer;
+    }
+
+    template<typename Fn>
+    void forEachProcessorInformation(const std::vector<u8>& tBuffer, Fn&& tFn) {
+        size_t offset = 0;
+        while (offset < tBuffer.size()) {
+            const auto* info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(tBuffer.data() + offset);
+            tFn(*info);
+            offset += info->Size;
+        }
+    }
+
+    // Calls tFn with the logical id of every processor in the group mask.
+    template<typename Fn>
+    void forEachProcessor(const GROUP_AFFINITY& tGroupMask, Fn&& tFn) {
+        for (u32 bit = 0; bit < cGroupWidth; ++bit) {
+            if (tGroupMask.Mask & (KAFFINITY(1) << bit)) {
+                tFn(makeLogicalId(tGroupMask.Group, bit));
+            }
+        }
+    }
+
+    // Older SDKs declare a single GroupMask for caches and NUMA nodes, newer ones add GroupCount/GroupMasks for
+    // nodes spanning several groups. The first mask is always valid.
+    template<typename Fn>
+    void forEachProcessor(const CACHE_RELATIONSHIP& tCache, Fn&& tFn) { forEachProcessor(tCache.GroupMask, tFn); }
+
+    template<typename Fn>
+    void forEachProcessor(const NUMA_NODE_RELATIONSHIP& tNode, Fn&& tFn) { forEachProcessor(tNode.GroupMask, tFn); }
+
+    template<typename Fn>
+    void forEachProcessor(const PROCESSOR_RELATIONSHIP& tProcessor, Fn&& tFn) {
+        for (WORD group = 0; group < tProcessor.GroupCount; ++group) {
+            forEachProcessor(tProcessor.GroupMask[group], tFn);
+        }
+    }
+
+    // Whether the process may run on a logical processor. A process in a single group (the common case, and any
+    // process restricted with an affinity mask) reports its mask for that group. Multi-group processes have no
+    // per-group mask to query, so every processor of their groups counts.
+    struct ProcessAffinity {
+        ProcessAffinity() {
+            USHORT groupCount = 0;
+            GetProcessGroupAffinity(GetCurrentProcess(), &groupCount, nullptr);
+            mGroups.resize(groupCount);
+            if (groupCount == 0 || !GetProcessGroupAffinity(GetCurrentProcess(), &groupCount, mGroups.data())) {
+                mGroups.clear();
+                return;
+            }
+
+            DWORD_PTR processMask = 0;
+            DWORD_PTR systemMask  = 0;
+            if (mGroups.size() == 1 && GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+                mSingleGroupMask = processMask;
+            }
+        }
+
+        [[nodiscard]] bool isAllowed(u32 tLogicalId) const {
+            if (mGroups.empty()) {
+                return true;
+            }
+
+            const USHORT group = USHORT(tLogicalId / cGroupWidth);
+            if (std::find(mGroups.begin(), mGroups.end(), group) == mGroups.end()) {
+                return false;
+            }
+            return mSingleGroupMask == 0 || (mSingleGroupMask & (DWORD_PTR(1) << (tLogicalId % cGroupWidth))) != 0;
+        }
+
+        std::vector<USHORT> mGroups{};
+        DWORD_PTR           mSingleGroupMask{0};
+    };
+
+    // CPU rate hard cap of the job object the process runs in, in whole cores. 0 if there is none.
+    u32 queryJobCpuQuota(u32 tSystemLogicalCount) {
+        JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rateControl = {};
+        if (!QueryInformationJobObject(nullptr, JobObjectCpuRateControlInformation, &rateControl, sizeof(rateControl), nullptr)) {
+            return 0;
+        }
+
+        const DWORD cHardCap = JOB_OBJECT_CPU_RATE_CONTROL_ENABLE | JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP;
+        if ((rateControl.ControlFlags & cHardCap) != cHardCap || rateControl.CpuRate == 0) {
+            return 0;
+        }
+
+        // CpuRate is the share of the whole machine in 1/100 of a percent.
+        const u64 scaled = u64(rateControl.CpuRate) * tSystemLogicalCount;
+        return u32((scaled + 9999) / 10000);
+    }
+
+    // Remaps sparse ids to dense indices in order of first appearance.
+    struct DenseIdMap {
+        u32 get(u64 tKey) {
+            auto [iter, inserted] = mIds.try_emplace(tKey, (u32)mIds.size());
+            return iter->second;
+        }
+
+        [[nodiscard]] u32 count() const { return (u32)mIds.size(); }
+
+        std::map<u64, u32> mIds{};
+    };
+}
+
+namespace ct::os {
+    CpuTopology queryCpuTopology() {
+        CpuTopology result{};
+
+        const std::vector<u8> coreInfo = queryProcessorInformation(RelationProcessorCore);
+        if (coreInfo.empty()) {
+            const u32 count = std::max(1u, std::thread::hardware_concurrency());
+            for (u32 cpu = 0; cpu < count; ++cpu) {
+                result.mLogicalCores.push_back({ .mLogicalId = cpu, .mPhysicalCoreId = cpu });
+            }
+
+            result.mPhysicalCoreCount = count;
+            result.mCacheDomainCount  = 1;
+            result.mNumaNodeCount     = 1;
+            return result;
+        }
+
+        const ProcessAffinity affinity{};
+
+        // Every field is the raw enumeration index for now, made dense once the cores we can't use are gone.
+        std::map<u32, CpuLogicalCore> cores{};
+        u32 systemLogicalCount = 0;
+
+        u32 coreIndex = 0;
+        forEachProcessorInformation(coreInfo, [&](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& tInfo) {
+            bool isFirst = true;
+            forEachProcessor(tInfo.Processor, [&](u32 tCpu) {
+                systemLogicalCount += 1;
+                if (!affinity.isAllowed(tCpu)) {
+                    return;
+                }
+
+                CpuLogicalCore& core = cores[tCpu];
+                core.mLogicalId      = tCpu;
+                core.mPhysicalCoreId = coreIndex;
+                core.mIsSmtSibling   = !isFirst;
+                isFirst = false;
+            });
+            coreIndex += 1;
+        });
+
+        const auto forEachAllowedCore = [&](auto&& tProcessors, auto&& tFn) {
+            forEachProcessor(tProcessors, [&](u32 tCpu) {
+                if (auto found = cores.find(tCpu); found != cores.end()) {
+                    tFn(found->second);
+                }
+            });
+        };
+
+        u32 packageIndex = 0;
+        forEachProcessorInformation(queryProcessorInformation(RelationProcessorPackage), [&](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& tInfo) {
+            forEachAllowedCore(tInfo.Processor, [&](CpuLogicalCore& tCore) { tCore.mPackageId = packageIndex; });
+            packageIndex += 1;
+        });
+
+        u32 cacheIndex = 0;
+        forEachProcessorInformation(queryProcessorInformation(RelationCache), [&](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& tInfo) {
+            if (tInfo.Cache.Level != 3) return;
+            forEachAllowedCore(tInfo.Cache, [&](CpuLogicalCore& tCore) { tCore.mCacheDomainId = cacheIndex; });
+            cacheIndex += 1;
+        });
+
+        u32 numaIndex = 0;
+        forEachProcessorInformation(queryProcessorInformation(RelationNumaNode), [&](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& tInfo) {
+            forEachAllowedCore(tInfo.NumaNode, [&](CpuLogicalCore& tCore) { tCore.mNumaNode = numaIndex; });
+            numaIndex += 1;
+        });
+
+        // Processors without an L3 report every core in one domain.
+        DenseIdMap physicalCores{};
+        DenseIdMap cacheDomains{};
+        DenseIdMap numaNodes{};
+        for (auto& [cpu, core] : cores) {
+            core.mPhysicalCoreId = physicalCores.get(core.mPhysicalCoreId);
+            core.mCacheDomainId  = cacheDomains.get(core.mCacheDomainId);
+            core.mNumaNode       = numaNodes.get(core.mNumaNode);
+            result.mLogicalCores.push_back(core);
+        }
+
+        result.mPhysicalCoreCount = physicalCores.count();
+        result.mCacheDomainCount  = std::max(1u, cacheDomains.count());
+        result.mNumaNodeCount     = std::max(1u, numaNodes.count());
+        result.mCpuQuota          = queryJobCpuQuota(systemLogicalCount);
+        return result;
+    }
+
+    bool setCurrentThreadAffinity(u32 tLogicalCoreId) {
+        GROUP_AFFINITY affinity = {};
+        affinity.Group = WORD(tLogicalCoreId / cGroupWidth);
+        affinity.Mask  = KAFFINITY(1) << (tLogicalCoreId % cGroupWidth);
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+    }
+}
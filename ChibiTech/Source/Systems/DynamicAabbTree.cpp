@@ -0,0 +1,438 @@
+#include "DynamicAabbTree.h"
+#include "FrustumCulling.h"
+
+#include <Platform/Assert.h>
+
+#include <algorithm>
+
+namespace ct {
+    namespace {
+        // A balanced tree of 2^32 leaves is less than 48 levels deep, and a depth-first walk keeps at most one
+        // pending sibling per level.
+        constexpr u32 cMaxStackDepth = 256;
+
+        enum class FrustumTest { Outside, Intersecting, Inside };
+
+        FrustumTest testFrustum(const FrustumPlanes& tFrustum, const aabb& tBounds)
+        {
+            FrustumTest result = FrustumTest::Inside;
+            for (u32 i = 0; i < FrustumPlanes::Count; ++i) {
+                const float4& plane = tFrustum.mPlanes[i];
+
+                // Corner furthest along the plane normal (p-vertex) and the one opposite to it (n-vertex)
+                const float3 positive = {
+                    plane.X >= 0.0f ? tBounds.Max.X : tBounds.Min.X,
+                    plane.Y >= 0.0f ? tBounds.Max.Y : tBounds.Min.Y,
+                    plane.Z >= 0.0f ? tBounds.Max.Z : tBounds.Min.Z,
+                };
+                const float3 negative = {
+                    plane.X >= 0.0f ? tBounds.Min.X : tBounds.Max.X,
+                    plane.Y >= 0.0f ? tBounds.Min.Y : tBounds.Max.Y,
+                    plane.Z >= 0.0f ? tBounds.Min.Z : tBounds.Max.Z,
+                };
+
+                if (dot(plane.XYZ, positive) + plane.W < 0.0f) return FrustumTest::Outside;
+                if (dot(plane.XYZ, negative) + plane.W < 0.0f) result = FrustumTest::Intersecting;
+            }
+            return result;
+        }
+    }
+
+    DynamicAabbTree::DynamicAabbTree(f32 tMargin, f32 tDisplacementScale)
+        : mMargin(tMargin)
+        , mDisplacementScale(tDisplacementScale)
+    {
+    }
+
+    u32 DynamicAabbTree::allocateNode()
+    {
+        if (mFreeList == cNullNode) {
+            mNodes.emplace_back();
+            mNodes.back().mHeight   = -1;
+            mNodes.back().mNextFree = cNullNode;
+            mFreeList = (u32)mNodes.size() - 1;
+        }
+
+        const u32 index = mFreeList;
+        Node& node = mNodes[index];
+        mFreeList = node.mNextFree;
+
+        node.mParent   = cNullNode;
+        node.mChild1   = cNullNode;
+        node.mChild2   = cNullNode;
+        node.mHeight   = 0;
+        node.mUserData = 0;
+        return index;
+    }
+
+    void DynamicAabbTree::freeNode(u32 tNode)
+    {
+        ASSERT(tNode < mNodes.size() && mNodes[tNode].mHeight >= 0);
+
+        mNodes[tNode].mNextFree = mFreeList;
+        mNodes[tNode].mHeight   = -1;
+        mFreeList = tNode;
+    }
+
+    u32 DynamicAabbTree::createProxy(const aabb& tBounds, u64 tUserData)
+    {
+        const u32 proxy = allocateNode();
+        mNodes[proxy].mBounds   = expand(tBounds, mMargin);
+        mNodes[proxy].mUserData = tUserData;
+
+        insertLeaf(proxy);
+        mProxyCount += 1;
+        return proxy;
+    }
+
+    void DynamicAabbTree::destroyProxy(u32 tProxy)
+    {
+        ASSERT(tProxy < mNodes.size() && mNodes[tProxy].isLeaf() && mNodes[tProxy].mHeight == 0);
+
+        removeLeaf(tProxy);
+        freeNode(tProxy);
+        mProxyCount -= 1;
+    }
+
+    bool DynamicAabbTree::moveProxy(u32 tProxy, const aabb& tBounds, float3 tDisplacement)
+    {
+        ASSERT(tProxy < mNodes.size() && mNodes[tProxy].isLeaf() && mNodes[tProxy].mHeight == 0);
+
+        if (contains(mNodes[tProxy].mBounds, tBounds)) {
+            return false;
+        }
+
+        // Stretch the fat bounds in the direction of travel, the object is likely to keep moving that way.
+        aabb fatBounds = expand(tBounds, mMargin);
+        const float3 stretch = tDisplacement * mDisplacementScale;
+        for (u32 axis = 0; axis < 3; ++axis) {
+            if (stretch.Ptr[axis] < 0.0f) fatBounds.Min.Ptr[axis] += stretch.Ptr[axis];
+            else                          fatBounds.Max.Ptr[axis] += stretch.Ptr[axis];
+        }
+
+        removeLeaf(tProxy);
+        mNodes[tProxy].mBounds = fatBounds;
+        insertLeaf(tProxy);
+        return true;
+    }
+
+    const aabb& DynamicAabbTree::getFatBounds(u32 tProxy) const
+    {
+        ASSERT(tProxy < mNodes.size() && mNodes[tProxy].mHeight == 0);
+        return mNodes[tProxy].mBounds;
+    }
+
+    u64 DynamicAabbTree::getUserData(u32 tProxy) const
+    {
+        ASSERT(tProxy < mNodes.size() && mNodes[tProxy].mHeight == 0);
+        return mNodes[tProxy].mUserData;
+    }
+
+    u32 DynamicAabbTree::findBestSibling(const aabb& tBounds) const
+    {
+        // Greedy descent on the surface area heuristic. Placing the leaf next to a node costs the area of the new
+        // parent, plus the area every ancestor grows by ("inherited" cost). Stop once going deeper can't be
+        // cheaper than pairing with the current node.
+        u32 index = mRoot;
+        while (!mNodes[index].isLeaf()) {
+            const Node& node = mNodes[index];
+
+            const f32 area          = surfaceArea(node.mBounds);
+            const f32 combinedArea  = surfaceArea(merge(node.mBounds, tBounds));
+            const f32 cost          = 2.0f * combinedArea;
+            const f32 inheritedCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](u32 tChild) {
+                const Node& child  = mNodes[tChild];
+                const f32   merged = surfaceArea(merge(child.mBounds, tBounds));
+                return (child.isLeaf() ? merged : merged - surfaceArea(child.mBounds)) + inheritedCost;
+            };
+
+            const f32 cost1 = descendCost(node.mChild1);
+            const f32 cost2 = descendCost(node.mChild2);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.mChild1 : node.mChild2;
+        }
+        return index;
+    }
+
+    void DynamicAabbTree::insertLeaf(u32 tLeaf)
+    {
+        if (mRoot == cNullNode) {
+            mRoot = tLeaf;
+            mNodes[tLeaf].mParent = cNullNode;
+            return;
+        }
+
+        const u32 sibling   = findBestSibling(mNodes[tLeaf].mBounds);
+        const u32 oldParent = mNodes[sibling].mParent;
+
+        // May grow mNodes, so no references are held across it
+        const u32 newParent = allocateNode();
+
+        Node& parent    = mNodes[newParent];
+        parent.mParent  = oldParent;
+        parent.mBounds  = merge(mNodes[sibling].mBounds, mNodes[tLeaf].mBounds);
+        parent.mHeight  = mNodes[sibling].mHeight + 1;
+        parent.mChild1  = sibling;
+        parent.mChild2  = tLeaf;
+
+        if (oldParent != cNullNode) {
+            Node& grandParent = mNodes[oldParent];
+            if (grandParent.mChild1 == sibling) grandParent.mChild1 = newParent;
+            else                                grandParent.mChild2 = newParent;
+        } else {
+            mRoot = newParent;
+        }
+
+        mNodes[sibling].mParent = newParent;
+        mNodes[tLeaf].mParent   = newParent;
+
+        // Start at the new parent, a leaf next to a tall sibling already needs a rotation there
+        refitUpwards(newParent);
+    }
+
+    void DynamicAabbTree::removeLeaf(u32 tLeaf)
+    {
+        if (tLeaf == mRoot) {
+            mRoot = cNullNode;
+            return;
+        }
+
+        const u32 parent      = mNodes[tLeaf].mParent;
+        const u32 grandParent = mNodes[parent].mParent;
+        const u32 sibling     = mNodes[parent].mChild1 == tLeaf ? mNodes[parent].mChild2 : mNodes[parent].mChild1;
+
+        // The sibling takes the parent's place
+        if (grandParent != cNullNode) {
+            Node& node = mNodes[grandParent];
+            if (node.mChild1 == parent) node.mChild1 = sibling;
+            else                        node.mChild2 = sibling;
+
+            mNodes[sibling].mParent = grandParent;
+            freeNode(parent);
+            refitUpwards(grandParent);
+        } else {
+            mRoot = sibling;
+            mNodes[sibling].mParent = cNullNode;
+            freeNode(parent);
+        }
+    }
+
+    void DynamicAabbTree::refitUpwards(u32 tNode)
+    {
+        u32 index = tNode;
+        while (index != cNullNode) {
+            index = balance(index);
+
+            Node& node = mNodes[index];
+            const Node& child1 = mNodes[node.mChild1];
+            const Node& child2 = mNodes[node.mChild2];
+
+            node.mHeight = 1 + std::max(child1.mHeight, child2.mHeight);
+            node.mBounds = merge(child1.mBounds, child2.mBounds);
+
+            index = node.mParent;
+        }
+    }
+
+    // If one child of tNode is more than one level taller than the other, rotates the taller child up into
+    // tNode's place. The taller grandchild stays under the rotated node, the shorter one moves to tNode.
+    // Returns the index of the node now at tNode's position.
+    u32 DynamicAabbTree::balance(u32 tNode)
+    {
+        Node& a = mNodes[tNode];
+        if (a.isLeaf() || a.mHeight < 2) {
+            return tNode;
+        }
+
+        const s32 heightDelta = mNodes[a.mChild2].mHeight - mNodes[a.mChild1].mHeight;
+        if (heightDelta >= -1 && heightDelta <= 1) {
+            return tNode;
+        }
+
+        // Rotate the taller child ("up") above tNode, the other child ("stay") remains under tNode.
+        const bool rotateChild2 = heightDelta > 1;
+        const u32  up           = rotateChild2 ? a.mChild2 : a.mChild1;
+        const u32  stay         = rotateChild2 ? a.mChild1 : a.mChild2;
+
+        Node& b = mNodes[up];
+        const u32 grandChild1 = b.mChild1;
+        const u32 grandChild2 = b.mChild2;
+
+        // Swap tNode and up
+        b.mChild1 = tNode;
+        b.mParent = a.mParent;
+        a.mParent = up;
+
+        if (b.mParent != cNullNode) {
+            Node& parent = mNodes[b.mParent];
+            if (parent.mChild1 == tNode) parent.mChild1 = up;
+            else                         parent.mChild2 = up;
+        } else {
+            mRoot = up;
+        }
+
+        const bool keepChild1 = mNodes[grandChild1].mHeight > mNodes[grandChild2].mHeight;
+        const u32  keep       = keepChild1 ? grandChild1 : grandChild2;
+        const u32  move       = keepChild1 ? grandChild2 : grandChild1;
+
+        b.mChild2 = keep;
+        if (rotateChild2) a.mChild2 = move;
+        else              a.mChild1 = move;
+        mNodes[move].mParent = tNode;
+
+        a.mBounds = merge(mNodes[stay].mBounds, mNodes[move].mBounds);
+        a.mHeight = 1 + std::max(mNodes[stay].mHeight, mNodes[move].mHeight);
+        b.mBounds = merge(a.mBounds, mNodes[keep].mBounds);
+        b.mHeight = 1 + std::max(a.mHeight, mNodes[keep].mHeight);
+
+        return up;
+    }
+
+    void DynamicAabbTree::queryBox(const aabb& tBounds, const QueryFunc& tCallback) const
+    {
+        if (mRoot == cNullNode) return;
+
+        u32 stack[cMaxStackDepth];
+        u32 count = 0;
+        stack[count++] = mRoot;
+
+        while (count > 0) {
+            const u32   index = stack[--count];
+            const Node& node  = mNodes[index];
+            if (!overlaps(node.mBounds, tBounds)) continue;
+
+            if (node.isLeaf()) {
+                if (!tCallback(index)) return;
+            } else {
+                ASSERT(count + 2 <= cMaxStackDepth);
+                stack[count++] = node.mChild1;
+                stack[count++] = node.mChild2;
+            }
+        }
+    }
+
+    void DynamicAabbTree::queryFrustum(const FrustumPlanes& tFrustum, const QueryFunc& tCallback) const
+    {
+        if (mRoot == cNullNode) return;
+
+        // The second entry flags subtrees that are already known to be fully inside, those skip the plane tests.
+        struct Entry
+        {
+            u32  mNode;
+            bool mIsInside;
+        };
+
+        Entry stack[cMaxStackDepth];
+        u32   count = 0;
+        stack[count++] = { mRoot, false };
+
+        while (count > 0) {
+            const Entry entry = stack[--count];
+            const Node& node  = mNodes[entry.mNode];
+
+            bool isInside = entry.mIsInside;
+            if (!isInside) {
+                const FrustumTest test = testFrustum(tFrustum, node.mBounds);
+                if (test == FrustumTest::Outside) continue;
+                isInside = test == FrustumTest::Inside;
+            }
+
+            if (node.isLeaf()) {
+                if (!tCallback(entry.mNode)) return;
+            } else {
+                ASSERT(count + 2 <= cMaxStackDepth);
+                stack[count++] = { node.mChild1, isInside };
+                stack[count++] = { node.mChild2, isInside };
+            }
+        }
+    }
+
+    void DynamicAabbTree::rayCast(float3 tOrigin, float3 tDirection, f32 tMaxDistance, const RayCastFunc& tCallback) const
+    {
+        if (mRoot == cNullNode) return;
+
+        const float3 inverseDirection = { 1.0f / tDirection.X, 1.0f / tDirection.Y, 1.0f / tDirection.Z };
+        f32 maxDistance = tMaxDistance;
+
+        u32 stack[cMaxStackDepth];
+        u32 count = 0;
+        stack[count++] = mRoot;
+
+        while (count > 0) {
+            const u32   index = stack[--count];
+            const Node& node  = mNodes[index];
+
+            f32 hitDistance;
+            if (!intersectRay(node.mBounds, tOrigin, inverseDirection, maxDistance, hitDistance)) continue;
+
+            if (node.isLeaf()) {
+                const f32 value = tCallback(index, maxDistance);
+                if (value <= 0.0f) return;
+                maxDistance = std::min(maxDistance, value);
+            } else {
+                ASSERT(count + 2 <= cMaxStackDepth);
+                stack[count++] = node.mChild1;
+                stack[count++] = node.mChild2;
+            }
+        }
+    }
+
+    u32 DynamicAabbTree::getHeight() const
+    {
+        return mRoot == cNullNode ? 0 : (u32)mNodes[mRoot].mHeight;
+    }
+
+    f32 DynamicAabbTree::getAreaRatio() const
+    {
+        if (mRoot == cNullNode) return 0.0f;
+
+        f32 totalArea = 0.0f;
+        for (const Node& node : mNodes) {
+            if (node.mHeight > 0) totalArea += surfaceArea(node.mBounds);
+        }
+
+        const f32 rootArea = surfaceArea(mNodes[mRoot].mBounds);
+        return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+    }
+
+    void DynamicAabbTree::validate() const
+    {
+        if (mRoot != cNullNode) {
+            ASSERT(mNodes[mRoot].mParent == cNullNode);
+            validateNode(mRoot);
+        }
+
+        // Only read by ASSERT, unused when CT_DEBUG is off.
+        [[maybe_unused]] u32 freeCount = 0;
+        for (u32 index = mFreeList; index != cNullNode; index = mNodes[index].mNextFree) {
+            ASSERT(mNodes[index].mHeight == -1);
+            freeCount += 1;
+        }
+
+        // Every proxy is a leaf, and a tree with n leaves has n - 1 internal nodes.
+        [[maybe_unused]] const u32 usedCount = mProxyCount == 0 ? 0 : 2 * mProxyCount - 1;
+        ASSERT(usedCount + freeCount == mNodes.size());
+    }
+
+    void DynamicAabbTree::validateNode(u32 tNode) const
+    {
+        const Node& node = mNodes[tNode];
+        if (node.isLeaf()) {
+            ASSERT(node.mChild2 == cNullNode && node.mHeight == 0);
+            return;
+        }
+
+        [[maybe_unused]] const Node& child1 = mNodes[node.mChild1];
+        [[maybe_unused]] const Node& child2 = mNodes[node.mChild2];
+
+        ASSERT(child1.mParent == tNode && child2.mParent == tNode);
+        ASSERT(node.mHeight == 1 + std::max(child1.mHeight, child2.mHeight));
+        ASSERT(contains(node.mBounds, child1.mBounds) && contains(node.mBounds, child2.mBounds));
+
+        validateNode(node.mChild1);
+        validateNode(node.mChild2);
+    }
+} // ct
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Math/Bounds.h>
+
+#include <functional>
+#include <vector>
+
+namespace ct {
+    struct FrustumPlanes;
+
+    // Bounding volume hierarchy over moving objects, for picking, culling and broad-phase queries.
+    //
+    // Every object (proxy) is stored with "fat" bounds: its real bounds grown by a margin and stretched along its
+    // last displacement. As long as an object stays inside its fat bounds, moving it doesn't touch the tree. Leaves
+    // are inserted next to the sibling that grows the total surface area the least, and the tree is kept balanced
+    // with AVL-style rotations on the way back up.
+    //
+    // Proxy ids are stable until the proxy is destroyed. The tree is not thread-safe, but queries are const and
+    // may run concurrently with each other.
+    class DynamicAabbTree
+    {
+    public:
+        static constexpr u32 cInvalidProxy = ~0u;
+
+        // Return false to stop the query early.
+        using QueryFunc = std::function<bool(u32 tProxy)>;
+        // Return the new max distance: the hit distance to only look for closer hits, 0 to stop the query, or
+        // tMaxDistance unchanged to keep looking everywhere.
+        using RayCastFunc = std::function<f32(u32 tProxy, f32 tMaxDistance)>;
+
+        // tMargin is added to every side of the bounds, tDisplacementScale stretches the fat bounds along the
+        // displacement passed to moveProxy so that objects moving at a steady speed reinsert less often.
+        explicit DynamicAabbTree(f32 tMargin = 0.1f, f32 tDisplacementScale = 4.0f);
+
+        u32  createProxy(const aabb& tBounds, u64 tUserData);
+        void destroyProxy(u32 tProxy);
+
+        // Returns true if the proxy left its fat bounds and was reinserted.
+        bool moveProxy(u32 tProxy, const aabb& tBounds, float3 tDisplacement);
+
+        const aabb& getFatBounds(u32 tProxy) const;
+        u64         getUserData(u32 tProxy) const;
+
+        // Reports every proxy whose fat bounds overlap the query. Callers that need exact results test the
+        // object's real bounds in the callback.
+        void queryBox(const aabb& tBounds, const QueryFunc& tCallback) const;
+        void queryFrustum(const FrustumPlanes& tFrustum, const QueryFunc& tCallback) const;
+        void rayCast(float3 tOrigin, float3 tDirection, f32 tMaxDistance, const RayCastFunc& tCallback) const;
+
+        u32 getProxyCount() const { return mProxyCount; }
+        // 0 for an empty tree or a single leaf.
+        u32 getHeight() const;
+        // Sum of internal node areas over the root area, a measure of tree quality.
+        f32 getAreaRatio() const;
+
+        // Checks the structure and the bounds of every node, debug only.
+        void validate() const;
+
+    private:
+        static constexpr u32 cNullNode = ~0u;
+
+        struct Node
+        {
+            aabb mBounds;
+            u64  mUserData;
+            union
+            {
+                u32 mParent;
+                u32 mNextFree;
+            };
+            u32  mChild1;
+            u32  mChild2;
+            s32  mHeight; // 0 for leaves, -1 for free nodes
+
+            bool isLeaf() const { return mChild1 == cNullNode; }
+        };
+
+        u32  allocateNode();
+        void freeNode(u32 tNode);
+
+        void insertLeaf(u32 tLeaf);
+        void removeLeaf(u32 tLeaf);
+        u32  findBestSibling(const aabb& tBounds) const;
+        // Refits and rebalances every node from tNode up to the root.
+        void refitUpwards(u32 tNode);
+        u32  balance(u32 tNode);
+
+        void validateNode(u32 tNode) const;
+
+        std::vector<Node> mNodes{};
+        u32               mRoot{cNullNode};
+        u32               mFreeList{cNullNode};
+        u32               mProxyCount{0};
+        f32               mMargin;
+        f32               mDisplacementScale;
+    };
+} // ct
@@ -0,0 +1,502 @@
+#include "EntityWorld.h"
+
+#include <Platform/Console.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace ct {
+    namespace {
+        struct ComponentRegistry
+        {
+            std::array<ComponentInfo, cMaxComponents> mInfos{};
+            std::atomic<u32>                          mCount{0};
+            std::mutex                                mLock{};
+        };
+
+        ComponentRegistry& getRegistry()
+        {
+            var_persist ComponentRegistry registry{};
+            return registry;
+        }
+
+        u8* allocateChunk()
+        {
+            return static_cast<u8*>(::operator new(cEntityChunkSize, std::align_val_t(cMaxComponentAlignment)));
+        }
+
+        void freeChunk(u8* tChunk)
+        {
+            ::operator delete(tChunk, std::align_val_t(cMaxComponentAlignment));
+        }
+    }
+
+    namespace internal {
+        ComponentId registerComponent(const ComponentInfo& tInfo)
+        {
+            ComponentRegistry& registry = getRegistry();
+            std::lock_guard lock(registry.mLock);
+
+            // Not an ASSERT: registration runs from a static initializer in every build, and an id past the mask
+            // would write past mInfos and shift by 64.
+            const u32 id = registry.mCount.load(std::memory_order_relaxed);
+            if (id >= cMaxComponents) {
+                ct::console::fatal("Too many component types, ComponentMask only has %u bits.", cMaxComponents);
+            }
+
+            registry.mInfos[id] = tInfo;
+            registry.mCount.store(id + 1, std::memory_order_release);
+            return id;
+        }
+    }
+
+    const ComponentInfo& getComponentInfo(ComponentId tComponent)
+    {
+        ASSERT(tComponent < getRegistry().mCount.load(std::memory_order_acquire));
+        return getRegistry().mInfos[tComponent];
+    }
+
+    //
+    // EntityCommandBuffer
+    //
+
+    void EntityCommandBuffer::writeHeader(CommandType tType, u32 tArgument, Entity tEntity)
+    {
+        const CommandHeader header = { .mType = tType, .mArgument = tArgument, .mEntity = tEntity };
+
+        const size_t offset = mBuffer.size();
+        mBuffer.resize(offset + sizeof(header));
+        memcpy(mBuffer.data() + offset, &header, sizeof(header));
+    }
+
+    void EntityCommandBuffer::writeComponent(ComponentId tComponent, const void* tData)
+    {
+        const ComponentRecord record = { .mComponent = tComponent, .mSize = getComponentInfo(tComponent).mSize };
+
+        const size_t offset = mBuffer.size();
+        mBuffer.resize(offset + sizeof(record) + record.mSize);
+        memcpy(mBuffer.data() + offset, &record, sizeof(record));
+        if (record.mSize > 0) {
+            memcpy(mBuffer.data() + offset + sizeof(record), tData, record.mSize);
+        }
+    }
+
+    //
+    // EntityWorld
+    //
+
+    EntityWorld::EntityWorld()
+    {
+        // Archetype 0 is the empty component set, so entities always have an archetype.
+        getOrCreateArchetype(0);
+    }
+
+    EntityWorld::~EntityWorld()
+    {
+        for (Archetype& archetype : mArchetypes) {
+            for (u8* chunk : archetype.mChunks) {
+                freeChunk(chunk);
+            }
+        }
+    }
+
+    Entity EntityWorld::createEntityWithMask(ComponentMask tMask)
+    {
+        ASSERT_CUSTOM(mIterationDepth == 0, "Structural change while iterating, use an EntityCommandBuffer.");
+
+        const Entity entity = allocateEntity();
+        const u32 archetype = getOrCreateArchetype(tMask);
+
+        EntityRecord& record = mRecords[EntityHandleLayout::getIndex(entity.get())];
+        record.mArchetype = archetype;
+        record.mRow       = allocateRow(archetype, entity);
+        return entity;
+    }
+
+    void EntityWorld::destroyEntity(Entity tEntity)
+    {
+        ASSERT_CUSTOM(mIterationDepth == 0, "Structural change while iterating, use an EntityCommandBuffer.");
+
+        EntityRecord* record = getRecord(tEntity);
+        if (!record)
+            return;
+
+        removeRow(record->mArchetype, record->mRow);
+
+        record->mArchetype  = cNullIndex;
+        record->mGeneration = EntityHandleLayout::markGenerationAsFree(record->mGeneration);
+        record->mNextFree   = cNullIndex;
+
+        // Append to the back of the free list, the oldest slot is reused first.
+        const u32 index = EntityHandleLayout::getIndex(tEntity.get());
+        if (mFreeTail != cNullIndex)
+            mRecords[mFreeTail].mNextFree = index;
+        else
+            mFreeHead = index;
+        mFreeTail = index;
+
+        mEntityCount -= 1;
+    }
+
+    bool EntityWorld::isAlive(Entity tEntity) const
+    {
+        return getRecord(tEntity) != nullptr;
+    }
+
+    ComponentMask EntityWorld::getComponentMask(Entity tEntity) const
+    {
+        const EntityRecord* record = getRecord(tEntity);
+        return record ? mArchetypes[record->mArchetype].mMask : 0;
+    }
+
+    void EntityWorld::addComponent(Entity tEntity, ComponentId tComponent, const void* tData)
+    {
+        EntityRecord* record = getRecord(tEntity);
+        if (!record)
+            return;
+
+        const ComponentMask bit = ComponentMask(1) << tComponent;
+        if ((mArchetypes[record->mArchetype].mMask & bit) == 0)
+        {
+            ASSERT_CUSTOM(mIterationDepth == 0, "Structural change while iterating, use an EntityCommandBuffer.");
+
+            u32 destination = mArchetypes[record->mArchetype].mAddEdges[tComponent];
+            if (destination == cNullIndex)
+            {
+                // getOrCreateArchetype can grow mArchetypes, look the source up again afterwards.
+                destination = getOrCreateArchetype(mArchetypes[record->mArchetype].mMask | bit);
+                mArchetypes[record->mArchetype].mAddEdges[tComponent] = destination;
+                mArchetypes[destination].mRemoveEdges[tComponent]    = record->mArchetype;
+            }
+            moveEntity(*record, destination);
+        }
+
+        writeComponent(tEntity, tComponent, tData);
+    }
+
+    void EntityWorld::removeComponent(Entity tEntity, ComponentId tComponent)
+    {
+        EntityRecord* record = getRecord(tEntity);
+        if (!record)
+            return;
+
+        const ComponentMask bit = ComponentMask(1) << tComponent;
+        if ((mArchetypes[record->mArchetype].mMask & bit) == 0)
+            return;
+
+        ASSERT_CUSTOM(mIterationDepth == 0, "Structural change while iterating, use an EntityCommandBuffer.");
+
+        u32 destination = mArchetypes[record->mArchetype].mRemoveEdges[tComponent];
+        if (destination == cNullIndex)
+        {
+            destination = getOrCreateArchetype(mArchetypes[record->mArchetype].mMask & ~bit);
+            mArchetypes[record->mArchetype].mRemoveEdges[tComponent] = destination;
+            mArchetypes[destination].mAddEdges[tComponent]          = record->mArchetype;
+        }
+        moveEntity(*record, destination);
+    }
+
+    void* EntityWorld::getComponent(Entity tEntity, ComponentId tComponent)
+    {
+        const EntityRecord* record = getRecord(tEntity);
+        if (!record)
+            return nullptr;
+
+        const Archetype& archetype = mArchetypes[record->mArchetype];
+        if ((archetype.mMask & (ComponentMask(1) << tComponent)) == 0)
+            return nullptr;
+
+        const u32 column = archetype.getColumn(tComponent);
+        return archetype.mColumnSizes[column] > 0 ? getColumnData(archetype, column, record->mRow) : nullptr;
+    }
+
+    void EntityWorld::writeComponent(Entity tEntity, ComponentId tComponent, const void* tData)
+    {
+        const u32 size = getComponentInfo(tComponent).mSize;
+        if (size == 0)
+            return;
+
+        void* destination = getComponent(tEntity, tComponent);
+        ASSERT(destination);
+        memcpy(destination, tData, size);
+    }
+
+    void EntityWorld::playback(EntityCommandBuffer& tCommands)
+    {
+        using CommandType     = EntityCommandBuffer::CommandType;
+        using CommandHeader   = EntityCommandBuffer::CommandHeader;
+        using ComponentRecord = EntityCommandBuffer::ComponentRecord;
+
+        const u8*       cursor = tCommands.mBuffer.data();
+        const u8* const end    = cursor + tCommands.mBuffer.size();
+
+        // Component records that follow a Create or Add header.
+        struct Payload { ComponentId mComponent; const u8* mData; };
+        std::array<Payload, cMaxComponents> payloads{};
+
+        auto readPayloads = [&](u32 tCount) {
+            ASSERT(tCount <= cMaxComponents);
+            for (u32 i = 0; i < tCount; ++i) {
+                ComponentRecord record;
+                memcpy(&record, cursor, sizeof(record));
+                payloads[i] = { .mComponent = record.mComponent, .mData = cursor + sizeof(record) };
+                cursor += sizeof(record) + record.mSize;
+            }
+        };
+
+        while (cursor < end)
+        {
+            CommandHeader header;
+            memcpy(&header, cursor, sizeof(header));
+            cursor += sizeof(header);
+
+            switch (header.mType)
+            {
+                case CommandType::Create:
+                {
+                    readPayloads(header.mArgument);
+
+                    ComponentMask mask = 0;
+                    for (u32 i = 0; i < header.mArgument; ++i) {
+                        mask |= ComponentMask(1) << payloads[i].mComponent;
+                    }
+
+                    const Entity entity = createEntityWithMask(mask);
+                    for (u32 i = 0; i < header.mArgument; ++i) {
+                        writeComponent(entity, payloads[i].mComponent, payloads[i].mData);
+                    }
+                } break;
+
+                case CommandType::Destroy:
+                {
+                    destroyEntity(header.mEntity);
+                } break;
+
+                case CommandType::Add:
+                {
+                    readPayloads(header.mArgument);
+                    addComponent(header.mEntity, payloads[0].mComponent, payloads[0].mData);
+                } break;
+
+                case CommandType::Remove:
+                {
+                    removeComponent(header.mEntity, header.mArgument);
+                } break;
+            }
+        }
+
+        tCommands.clear();
+    }
+
+    QueryId EntityWorld::createQuery(ComponentMask tAll, ComponentMask tNone)
+    {
+        ASSERT_CUSTOM((tAll & tNone) == 0, "A query can't both require and exclude a component.");
+
+        for (QueryId query = 0; query < mQueries.size(); ++query) {
+            if (mQueries[query].mAll == tAll && mQueries[query].mNone == tNone)
+                return query;
+        }
+
+        CachedQuery query = { .mAll = tAll, .mNone = tNone };
+        for (u32 archetype = 0; archetype < mArchetypes.size(); ++archetype) {
+            const ComponentMask mask = mArchetypes[archetype].mMask;
+            if ((mask & tAll) == tAll && (mask & tNone) == 0)
+                query.mArchetypes.push_back(archetype);
+        }
+
+        mQueries.push_back(std::move(query));
+        return QueryId(mQueries.size() - 1);
+    }
+
+    u32 EntityWorld::getQueryEntityCount(QueryId tQuery) const
+    {
+        ASSERT(tQuery < mQueries.size());
+
+        u32 count = 0;
+        for (const u32 archetype : mQueries[tQuery].mArchetypes) {
+            count += mArchetypes[archetype].mEntityCount;
+        }
+        return count;
+    }
+
+    Entity EntityWorld::allocateEntity()
+    {
+        u32 index = mFreeHead;
+        if (index != cNullIndex)
+        {
+            mFreeHead = mRecords[index].mNextFree;
+            if (mFreeHead == cNullIndex)
+                mFreeTail = cNullIndex;
+        }
+        else
+        {
+            index = (u32)mRecords.size();
+            ASSERT_CUSTOM(index < EntityHandleLayout::cNullIndex, "Out of entity handles.");
+            mRecords.push_back({});
+        }
+
+        EntityRecord& record = mRecords[index];
+        record.mGeneration = EntityHandleLayout::markGenerationAsAlive(record.mGeneration);
+        record.mNextFree   = cNullIndex;
+
+        mEntityCount += 1;
+        return Entity(EntityHandleLayout::makeMask(index, record.mGeneration));
+    }
+
+    EntityWorld::EntityRecord* EntityWorld::getRecord(Entity tEntity)
+    {
+        return const_cast<EntityRecord*>(static_cast<const EntityWorld*>(this)->getRecord(tEntity));
+    }
+
+    const EntityWorld::EntityRecord* EntityWorld::getRecord(Entity tEntity) const
+    {
+        const auto mask = tEntity.get();
+        if (mask.mMask == EntityHandleLayout::cInvalidIdMask)
+            return nullptr;
+
+        const u32 index = EntityHandleLayout::getIndex(mask);
+        if (index >= mRecords.size())
+            return nullptr;
+
+        const EntityRecord& record = mRecords[index];
+        const bool isLive = EntityHandleLayout::isLiveGeneration(record.mGeneration) && record.mGeneration == EntityHandleLayout::getGeneration(mask);
+        return isLive ? &record : nullptr;
+    }
+
+    u32 EntityWorld::getOrCreateArchetype(ComponentMask tMask)
+    {
+        if (auto found = mArchetypeLookup.find(tMask); found != mArchetypeLookup.end())
+            return found->second;
+
+        Archetype archetype{};
+        archetype.mMask = tMask;
+        archetype.mAddEdges.fill(cNullIndex);
+        archetype.mRemoveEdges.fill(cNullIndex);
+
+        u32 rowSize = sizeof(Entity);
+        for (ComponentMask bits = tMask; bits != 0; bits &= bits - 1) {
+            const ComponentId component = (ComponentId)std::countr_zero(bits);
+            archetype.mComponents.push_back(component);
+            archetype.mColumnSizes.push_back(getComponentInfo(component).mSize);
+            rowSize += getComponentInfo(component).mSize;
+        }
+
+        // Every column starts on a cache line, so leave room for the padding in front of each of them.
+        const u32 paddedColumns = (u32)std::count_if(archetype.mColumnSizes.begin(), archetype.mColumnSizes.end(), [](u32 tSize) { return tSize > 0; });
+        const u32 usableBytes   = cEntityChunkSize - paddedColumns * cColumnAlignment;
+        archetype.mRowsPerChunk = usableBytes / rowSize;
+        ASSERT_CUSTOM(archetype.mRowsPerChunk > 0, "Components are too large to fit a single entity in a chunk.");
+
+        u32 offset = archetype.mRowsPerChunk * sizeof(Entity);
+        for (const u32 size : archetype.mColumnSizes) {
+            if (size > 0) {
+                offset = MEMORY_ALIGN(offset, cColumnAlignment);
+            }
+            archetype.mColumnOffsets.push_back(offset);
+            offset += archetype.mRowsPerChunk * size;
+        }
+        ASSERT(offset <= cEntityChunkSize);
+
+        const u32 index = (u32)mArchetypes.size();
+        mArchetypes.push_back(std::move(archetype));
+        mArchetypeLookup.emplace(tMask, index);
+
+        // Keep the cached queries up to date, so iterating never has to search.
+        for (CachedQuery& query : mQueries) {
+            if ((tMask & query.mAll) == query.mAll && (tMask & query.mNone) == 0)
+                query.mArchetypes.push_back(index);
+        }
+
+        return index;
+    }
+
+    u32 EntityWorld::allocateRow(u32 tArchetype, Entity tEntity)
+    {
+        Archetype& archetype = mArchetypes[tArchetype];
+
+        const u32 row = archetype.mEntityCount;
+        if (row / archetype.mRowsPerChunk >= archetype.mChunks.size()) {
+            archetype.mChunks.push_back(allocateChunk());
+        }
+
+        u8* chunk = archetype.mChunks[row / archetype.mRowsPerChunk];
+        memcpy(chunk + (row % archetype.mRowsPerChunk) * sizeof(Entity), &tEntity, sizeof(Entity));
+
+        archetype.mEntityCount += 1;
+        return row;
+    }
+
+    void EntityWorld::removeRow(u32 tArchetype, u32 tRow)
+    {
+        Archetype& archetype = mArchetypes[tArchetype];
+        ASSERT(tRow < archetype.mEntityCount);
+
+        // Move the last row into the hole, so the archetype stays dense.
+        const u32 last = archetype.mEntityCount - 1;
+        if (tRow != last)
+        {
+            u8* dstChunk = archetype.mChunks[tRow / archetype.mRowsPerChunk];
+            u8* srcChunk = archetype.mChunks[last / archetype.mRowsPerChunk];
+            const u32 dstRow = tRow % archetype.mRowsPerChunk;
+            const u32 srcRow = last % archetype.mRowsPerChunk;
+
+            Entity moved;
+            memcpy(&moved, srcChunk + srcRow * sizeof(Entity), sizeof(Entity));
+            memcpy(dstChunk + dstRow * sizeof(Entity), &moved, sizeof(Entity));
+
+            for (u32 column = 0; column < archetype.mColumnSizes.size(); ++column) {
+                const u32 size = archetype.mColumnSizes[column];
+                const u32 offset = archetype.mColumnOffsets[column];
+                memcpy(dstChunk + offset + dstRow * size, srcChunk + offset + srcRow * size, size);
+            }
+
+            mRecords[EntityHandleLayout::getIndex(moved.get())].mRow = tRow;
+        }
+
+        archetype.mEntityCount -= 1;
+
+        // Keep one spare chunk around so an entity moving back and forth across a chunk boundary doesn't thrash.
+        while (archetype.mChunks.size() > archetype.getUsedChunkCount() + 1) {
+            freeChunk(archetype.mChunks.back());
+            archetype.mChunks.pop_back();
+        }
+    }
+
+    void EntityWorld::moveEntity(EntityRecord& tRecord, u32 tDestination)
+    {
+        const u32 sourceIndex = tRecord.mArchetype;
+        const u32 sourceRow   = tRecord.mRow;
+
+        Entity entity;
+        {
+            const Archetype& source = mArchetypes[sourceIndex];
+            memcpy(&entity, source.mChunks[sourceRow / source.mRowsPerChunk] + (sourceRow % source.mRowsPerChunk) * sizeof(Entity), sizeof(Entity));
+        }
+
+        const u32 destinationRow = allocateRow(tDestination, entity);
+
+        // Copy the components both archetypes share, the new component is written by the caller.
+        const Archetype& source      = mArchetypes[sourceIndex];
+        const Archetype& destination = mArchetypes[tDestination];
+        for (u32 column = 0; column < destination.mComponents.size(); ++column) {
+            const ComponentId component = destination.mComponents[column];
+            const u32 size = destination.mColumnSizes[column];
+            if (size == 0 || (source.mMask & (ComponentMask(1) << component)) == 0)
+                continue;
+
+            memcpy(getColumnData(destination, column, destinationRow), getColumnData(source, source.getColumn(component), sourceRow), size);
+        }
+
+        removeRow(sourceIndex, sourceRow);
+
+        tRecord.mArchetype = tDestination;
+        tRecord.mRow       = destinationRow;
+    }
+
+    u8* EntityWorld::getColumnData(const Archetype& tArchetype, u32 tColumn, u32 tRow) const
+    {
+        u8* chunk = tArchetype.mChunks[tRow / tArchetype.mRowsPerChunk];
+        return chunk + tArchetype.mColumnOffsets[tColumn] + (tRow % tArchetype.mRowsPerChunk) * tArchetype.mColumnSizes[tColumn];
+    }
+}
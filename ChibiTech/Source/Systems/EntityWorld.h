@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Types.h>
+#include <Platform/Assert.h>
+#include <Util/SmallVector.h>
+#include <Util/StorageHandle.h>
+
+#include "ParallelFor.h"
+
+namespace ct {
+    // Archetype-based entity storage.
+    //
+    // Unlike util::SparseStorage, whose column set is fixed at compile time, every entity here has its own set of
+    // components. Entities with the same set share an archetype, and an archetype stores its entities in 16 KB chunks:
+    // the entity handles first, then one tightly packed array per component, each starting on a cache line. Adding or
+    // removing a component moves the entity to the neighbouring archetype (the transitions are cached per archetype),
+    // and removal keeps each archetype dense by moving its last entity into the hole.
+    //
+    // Components are plain data (trivially copyable) and are moved around with memcpy. Empty structs are tags: they
+    // take part in archetype matching but have no column.
+    //
+    // Queries match archetypes by component bitmask and cache the matching list, new archetypes are added to existing
+    // queries when they are created, so iterating neither searches nor allocates. Structural changes (create, destroy,
+    // add, remove) are not allowed while iterating. Record them in an EntityCommandBuffer instead and play it back
+    // afterwards.
+    //
+    // struct Position { float3 mValue; };
+    // struct Velocity { float3 mValue; };
+    // struct Frozen {};
+    //
+    // EntityWorld world;
+    // Entity entity = world.createEntity(Position{}, Velocity{});
+    //
+    // QueryId moving = world.createQuery<Position, Velocity>(getComponentMask<Frozen>());
+    // world.forEach<Position, const Velocity>(moving, [&](Entity tEntity, Position& tPosition, const Velocity& tVelocity) {
+    //     tPosition.mValue += tVelocity.mValue * dt;
+    //     if (outOfBounds(tPosition)) commands.destroyEntity(tEntity);
+    // });
+    // world.playback(commands);
+
+    using ComponentId   = u32;
+    using ComponentMask = u64;
+    using QueryId       = u32;
+
+    constexpr u32 cMaxComponents         = 64; // One bit per component in a ComponentMask
+    constexpr u32 cMaxComponentAlignment = 64; // Chunks and columns start on a cache line
+    constexpr u32 cEntityChunkSize       = 16 * 1024;
+
+    using EntityHandleLayout = util::internal::HandleLayout<24, 8>;
+    using Entity             = util::StorageId<EntityHandleLayout, struct EntityTag>;
+
+    struct ComponentInfo
+    {
+        u32 mSize{0}; // 0 for tags
+    };
+
+    namespace internal {
+        // Component ids are handed out per process in the order components are first used, so they are not stable
+        // between runs and must not be saved.
+        ComponentId registerComponent(const ComponentInfo& tInfo);
+    }
+
+    const ComponentInfo& getComponentInfo(ComponentId tComponent);
+
+    namespace internal {
+        template<class T>
+        ComponentId getComponentIdImpl()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Components are plain data, they are moved with memcpy.");
+            // Columns are packed arrays starting on a cache line, so every element is aligned up to that.
+            static_assert(alignof(T) <= cMaxComponentAlignment, "Component is over-aligned for a chunk column.");
+
+            static const ComponentId cId = registerComponent(ComponentInfo{
+                .mSize = std::is_empty_v<T> ? 0u : (u32)sizeof(T),
+            });
+            return cId;
+        }
+    }
+
+    // T and const T are the same component.
+    template<class T>
+    ComponentId getComponentId()
+    {
+        return internal::getComponentIdImpl<std::remove_cv_t<T>>();
+    }
+
+    template<class... Ts>
+    ComponentMask getComponentMask()
+    {
+        return (ComponentMask(0) | ... | (ComponentMask(1) << getComponentId<Ts>()));
+    }
+
+    // Records structural changes to apply later with EntityWorld::playback, in recording order. Not thread-safe, give
+    // every job its own buffer. Commands on entities that are dead by the time they play back are skipped.
+    class EntityCommandBuffer
+    {
+    public:
+        template<class... Ts>
+        void createEntity(const Ts&... tComponents)
+        {
+            writeHeader(CommandType::Create, (u32)sizeof...(Ts), Entity());
+            (writeComponent(getComponentId<Ts>(), &tComponents), ...);
+        }
+
+        void destroyEntity(Entity tEntity)
+        {
+            writeHeader(CommandType::Destroy, 0, tEntity);
+        }
+
+        // Adds the component, or overwrites it if the entity already has one.
+        template<class T>
+        void addComponent(Entity tEntity, const T& tComponent)
+        {
+            writeHeader(CommandType::Add, 1, tEntity);
+            writeComponent(getComponentId<T>(), &tComponent);
+        }
+
+        template<class T>
+        void removeComponent(Entity tEntity)
+        {
+            writeHeader(CommandType::Remove, getComponentId<T>(), tEntity);
+        }
+
+        [[nodiscard]] bool empty() const { return mBuffer.empty(); }
+        void clear() { mBuffer.clear(); }
+
+    private:
+        friend class EntityWorld;
+
+        enum class CommandType : u32 { Create, Destroy, Add, Remove };
+
+        // Create and Add are followed by mArgument component records, Remove stores the component in mArgument.
+        struct CommandHeader
+        {
+            CommandType mType;
+            u32         mArgument;
+            Entity      mEntity;
+        };
+
+        struct ComponentRecord
+        {
+            ComponentId mComponent;
+            u32         mSize;
+        };
+
+        void writeHeader(CommandType tType, u32 tArgument, Entity tEntity);
+        void writeComponent(ComponentId tComponent, const void* tData);
+
+        // Commands are packed back to back, and always read back with memcpy so nothing needs to be aligned.
+        std::vector<u8> mBuffer{};
+    };
+
+    class EntityWorld
+    {
+    public:
+        EntityWorld();
+        ~EntityWorld();
+
+        // Copies are disallowed
+        EntityWorld(const EntityWorld&) = delete;
+        EntityWorld& operator=(const EntityWorld&) = delete;
+
+        template<class... Ts>
+        Entity createEntity(const Ts&... tComponents)
+        {
+            const ComponentMask mask = ct::getComponentMask<Ts...>();
+            ASSERT_CUSTOM(std::popcount(mask) == (int)sizeof...(Ts), "An entity can only have one of each component.");
+
+            const Entity entity = createEntityWithMask(mask);
+            (writeComponent(entity, getComponentId<Ts>(), &tComponents), ...);
+            return entity;
+        }
+
+        // Does nothing for dead entities.
+        void destroyEntity(Entity tEntity);
+        [[nodiscard]] bool isAlive(Entity tEntity) const;
+
+        // Adds the component, or overwrites it if the entity already has one.
+        template<class T>
+        void addComponent(Entity tEntity, const T& tComponent)
+        {
+            addComponent(tEntity, getComponentId<T>(), &tComponent);
+        }
+
+        template<class T>
+        void removeComponent(Entity tEntity)
+        {
+            removeComponent(tEntity, getComponentId<T>());
+        }
+
+        template<class T>
+        [[nodiscard]] bool hasComponent(Entity tEntity) const
+        {
+            return (getComponentMask(tEntity) & ct::getComponentMask<T>()) != 0;
+        }
+
+        // nullptr if the entity is dead or doesn't have the component. Tags have no data and always return nullptr.
+        // The pointer is valid until the next structural change.
+        template<class T>
+        [[nodiscard]] T* getComponent(Entity tEntity)
+        {
+            return static_cast<T*>(getComponent(tEntity, getComponentId<T>()));
+        }
+
+        template<class T>
+        [[nodiscard]] const T* getComponent(Entity tEntity) const
+        {
+            return static_cast<const T*>(const_cast<EntityWorld*>(this)->getComponent(tEntity, getComponentId<T>()));
+        }
+
+        // 0 for dead entities.
+        [[nodiscard]] ComponentMask getComponentMask(Entity tEntity) const;
+
+        [[nodiscard]] u32 getEntityCount() const    { return mEntityCount; }
+        [[nodiscard]] u32 getArchetypeCount() const { return (u32)mArchetypes.size(); }
+
+        // Type-erased versions of the templates above, also used for command buffer playback.
+        Entity createEntityWithMask(ComponentMask tMask); // Component data is left uninitialized
+        void   addComponent(Entity tEntity, ComponentId tComponent, const void* tData);
+        void   removeComponent(Entity tEntity, ComponentId tComponent);
+        void*  getComponent(Entity tEntity, ComponentId tComponent);
+
+        // Applies the recorded commands in order, then clears the buffer.
+        void playback(EntityCommandBuffer& tCommands);
+
+    public: // Queries
+        // Matches every archetype that has all of tAll and none of tNone. Creating the same query twice returns the
+        // same id. Queries live as long as the world.
+        QueryId createQuery(ComponentMask tAll, ComponentMask tNone = 0);
+
+        template<class... Ts>
+        QueryId createQuery(ComponentMask tNone = 0)
+        {
+            return createQuery(ct::getComponentMask<Ts...>(), tNone);
+        }
+
+        // Number of entities the query currently matches.
+        [[nodiscard]] u32 getQueryEntityCount(QueryId tQuery) const;
+
+        // Calls tFunc(std::span<const Entity>, std::span<Ts>...) once per non-empty chunk of each matching archetype.
+        // Every T must be part of the query's tAll mask. Declare a T const to only read it.
+        template<class... Ts, class Func>
+        void forEachChunk(QueryId tQuery, Func&& tFunc)
+        {
+            IterationScope scope(this);
+            for (const u32 archetypeIndex : getIteratedQuery<Ts...>(tQuery).mArchetypes) {
+                const Archetype& archetype = mArchetypes[archetypeIndex];
+                for (u32 chunk = 0; chunk < archetype.getUsedChunkCount(); ++chunk) {
+                    invokeChunk<Ts...>(getChunkRef<Ts...>(archetype, chunk), tFunc, std::index_sequence_for<Ts...>{});
+                }
+            }
+        }
+
+        // Calls tFunc(Ts&...), or tFunc(Entity, Ts&...) if it accepts an entity, for every matching entity.
+        template<class... Ts, class Func>
+        void forEach(QueryId tQuery, Func&& tFunc)
+        {
+            forEachChunk<Ts...>(tQuery, [&](std::span<const Entity> tEntities, std::span<Ts>... tColumns) {
+                forEachRow<Ts...>(tEntities, tFunc, tColumns...);
+            });
+        }
+
+        // forEach with whole chunks spread over the work queue. tFunc must be safe to call concurrently, and structural
+        // changes go through one EntityCommandBuffer per job.
+        template<class... Ts, class Func>
+        void forEachParallel(WorkQueue* tWorkQueue, QueryId tQuery, Func&& tFunc)
+        {
+            IterationScope scope(this);
+            const CachedQuery& query = getIteratedQuery<Ts...>(tQuery);
+
+            // Index of the first chunk of each matched archetype, so a job can find its chunk without a flat list.
+            util::SmallVector<u32, 32> firstChunks;
+            u32 chunkCount = 0;
+            for (const u32 archetypeIndex : query.mArchetypes) {
+                firstChunks.push_back(chunkCount);
+                chunkCount += mArchetypes[archetypeIndex].getUsedChunkCount();
+            }
+
+            parallelFor(tWorkQueue, chunkCount, 1, [&](u64 tBegin, u64 tEnd, u64) {
+                for (u64 chunk = tBegin; chunk < tEnd; ++chunk) {
+                    // Last archetype starting at or before the chunk, empty archetypes share their start with the next.
+                    const size_t match = std::upper_bound(firstChunks.begin(), firstChunks.end(), (u32)chunk) - firstChunks.begin() - 1;
+                    const Archetype& archetype = mArchetypes[query.mArchetypes[match]];
+
+                    invokeChunk<Ts...>(getChunkRef<Ts...>(archetype, (u32)chunk - firstChunks[match]), [&](std::span<const Entity> tEntities, std::span<Ts>... tColumns) {
+                        forEachRow<Ts...>(tEntities, tFunc, tColumns...);
+                    }, std::index_sequence_for<Ts...>{});
+                }
+            });
+        }
+
+    private:
+        static constexpr u32 cNullIndex       = ~0u;
+        static constexpr u32 cColumnAlignment = cMaxComponentAlignment;
+
+        using GenerationType = EntityHandleLayout::GenerationType;
+
+        struct Archetype
+        {
+            ComponentMask            mMask{0};
+            std::vector<ComponentId> mComponents{};    // Sorted by id, one column each
+            std::vector<u32>         mColumnOffsets{}; // Byte offset of each column inside a chunk, entities are at 0
+            std::vector<u32>         mColumnSizes{};   // 0 for tags
+            u32                      mRowsPerChunk{0};
+            u32                      mEntityCount{0};
+            std::vector<u8*>         mChunks{};
+
+            // Archetype reached by adding or removing a component, filled in on first use.
+            std::array<u32, cMaxComponents> mAddEdges{};
+            std::array<u32, cMaxComponents> mRemoveEdges{};
+
+            // Columns are sorted by component id, so a component's column is the number of set bits below it.
+            u32 getColumn(ComponentId tComponent) const
+            {
+                return (u32)std::popcount(mMask & ((ComponentMask(1) << tComponent) - 1));
+            }
+
+            // Chunks holding at least one entity, the spare chunk kept by removeRow is not counted.
+            u32 getUsedChunkCount() const
+            {
+                return (mEntityCount + mRowsPerChunk - 1) / mRowsPerChunk;
+            }
+        };
+
+        struct EntityRecord
+        {
+            u32            mArchetype{cNullIndex};
+            u32            mRow{0};                // Row across the archetype's chunks
+            GenerationType mGeneration{0};
+            u32            mNextFree{cNullIndex};
+        };
+
+        struct CachedQuery
+        {
+            ComponentMask    mAll{0};
+            ComponentMask    mNone{0};
+            std::vector<u32> mArchetypes{};
+        };
+
+        // One chunk of a query's result, with the byte offsets of the iterated columns.
+        template<size_t N>
+        struct ChunkRef
+        {
+            u8*                mData;
+            u32                mRowCount;
+            std::array<u32, N> mOffsets;
+        };
+
+        // Catches structural changes made while a query is iterating.
+        struct IterationScope
+        {
+            explicit IterationScope(EntityWorld* tWorld) : mWorld(tWorld) { mWorld->mIterationDepth += 1; }
+            ~IterationScope() { mWorld->mIterationDepth -= 1; }
+            EntityWorld* mWorld;
+        };
+
+        template<class... Ts>
+        const CachedQuery& getIteratedQuery(QueryId tQuery) const
+        {
+            ASSERT(tQuery < mQueries.size());
+            const CachedQuery& query = mQueries[tQuery];
+
+            const ComponentMask iterated = ct::getComponentMask<Ts...>();
+            ASSERT_CUSTOM((query.mAll & iterated) == iterated, "Every iterated component must be required by the query.");
+            ASSERT_CUSTOM(((getComponentInfo(getComponentId<Ts>()).mSize > 0) && ...), "Tags have no data to iterate, filter on them in the query instead.");
+            return query;
+        }
+
+        template<class... Ts>
+        ChunkRef<sizeof...(Ts)> getChunkRef(const Archetype& tArchetype, u32 tChunk) const
+        {
+            const u32 firstRow = tChunk * tArchetype.mRowsPerChunk;
+            return {
+                .mData     = tArchetype.mChunks[tChunk],
+                .mRowCount = std::min(tArchetype.mRowsPerChunk, tArchetype.mEntityCount - firstRow),
+                .mOffsets  = { tArchetype.mColumnOffsets[tArchetype.getColumn(getComponentId<Ts>())]... },
+            };
+        }
+
+        template<class... Ts, class Func, size_t... I>
+        static void invokeChunk(const ChunkRef<sizeof...(Ts)>& tChunk, Func&& tFunc, std::index_sequence<I...>)
+        {
+            tFunc(std::span<const Entity>(reinterpret_cast<const Entity*>(tChunk.mData), tChunk.mRowCount),
+                  std::span<Ts>(reinterpret_cast<Ts*>(tChunk.mData + tChunk.mOffsets[I]), tChunk.mRowCount)...);
+        }
+
+        template<class... Ts, class Func>
+        static void forEachRow(std::span<const Entity> tEntities, Func& tFunc, std::span<Ts>... tColumns)
+        {
+            constexpr bool cWithEntity = std::is_invocable_v<Func&, Entity, Ts&...>;
+            for (size_t row = 0; row < tEntities.size(); ++row) {
+                if constexpr (cWithEntity) {
+                    tFunc(tEntities[row], tColumns[row]...);
+                } else {
+                    tFunc(tColumns[row]...);
+                }
+            }
+        }
+
+        void writeComponent(Entity tEntity, ComponentId tComponent, const void* tData);
+
+        Entity        allocateEntity();
+        EntityRecord* getRecord(Entity tEntity);
+        const EntityRecord* getRecord(Entity tEntity) const;
+
+        u32   getOrCreateArchetype(ComponentMask tMask);
+        u32   allocateRow(u32 tArchetype, Entity tEntity);
+        void  removeRow(u32 tArchetype, u32 tRow);
+        void  moveEntity(EntityRecord& tRecord, u32 tDestination);
+        u8*   getColumnData(const Archetype& tArchetype, u32 tColumn, u32 tRow) const;
+
+        std::vector<Archetype>                      mArchetypes{};
+        std::unordered_map<ComponentMask, u32>      mArchetypeLookup{};
+        std::vector<EntityRecord>                   mRecords{};
+        std::vector<CachedQuery>                    mQueries{};
+
+        u32 mFreeHead{cNullIndex}; // Oldest destroyed entity slot, reused first
+        u32 mFreeTail{cNullIndex};
+        u32 mEntityCount{0};
+        u32 mIterationDepth{0};
+    };
+}
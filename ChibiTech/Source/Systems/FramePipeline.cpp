@@ -0,0 +1,36 @@
+#include "FramePipeline.h"
+#include "WorkQueue.h"
+
+#include <Platform/Assert.h>
+
+namespace ct {
+    bool FramePipeline::prime(const UpdateFunc& tUpdate) {
+        ASSERT(mUpdate->mIsDone.load());
+
+        mPublishedSnapshot = 0;
+        return tUpdate(mPublishedSnapshot);
+    }
+
+    bool FramePipeline::runFrame(const UpdateFunc& tUpdate, const RenderFunc& tRender) {
+        ASSERT(mUpdate->mIsDone.load());
+
+        const u32 readSnapshot  = mPublishedSnapshot;
+        const u32 writeSnapshot = (mPublishedSnapshot + 1) % cSnapshotCount;
+
+        // The update is what the next frame is waiting on, so it goes in the frame-critical lane.
+        mUpdate->mIsDone.store(false);
+        mWorkQueue->addTask([update = mUpdate, &tUpdate, writeSnapshot] {
+            update->mResult = tUpdate(writeSnapshot);
+            update->mIsDone.store(true, std::memory_order_release);
+            update->mIsDone.notify_one();
+        }, TaskPriority::FrameCritical, true);
+
+        const bool renderResult = tRender(readSnapshot);
+
+        // Always join the update, even when render failed, so it never outlives the callbacks it references.
+        mUpdate->mIsDone.wait(false, std::memory_order_acquire);
+
+        mPublishedSnapshot = writeSnapshot;
+        return renderResult && mUpdate->mResult;
+    }
+} // ct
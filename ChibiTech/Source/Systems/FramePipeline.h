@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <Types.h>
+
+namespace ct {
+    class WorkQueue;
+
+    // Overlaps the simulation of frame N+1 with render recording of frame N.
+    //
+    // Update writes everything render needs into one of two snapshot slots, while render reads the slot that was
+    // published by the previous update. The slot indices handed to the callbacks are never equal within a frame,
+    // so as long as update only writes its slot and render only reads its slot no further locking is required.
+    //
+    // The pipeline does not depend on a window or GPU, so it can be driven headless with stub callbacks:
+    //
+    // ct::WorkQueue pool(2);
+    // ct::FramePipeline pipeline(pool);
+    // std::array<Snapshot, ct::FramePipeline::cSnapshotCount> snapshots{};
+    //
+    // pipeline.prime([&](u32 tWrite) { snapshots[tWrite] = simulate(); return true; });
+    // while (pipeline.runFrame(
+    //     [&](u32 tWrite) { snapshots[tWrite] = simulate(); return true; },
+    //     [&](u32 tRead)  { draw(snapshots[tRead]); return true; })) {}
+    //
+    class FramePipeline {
+    public:
+        using UpdateFunc = std::function<bool(u32 tWriteSnapshot)>;
+        using RenderFunc = std::function<bool(u32 tReadSnapshot)>;
+
+        static constexpr u32 cSnapshotCount = 2;
+
+        explicit FramePipeline(WorkQueue& tWorkQueue) : mWorkQueue(&tWorkQueue) {}
+
+        // Copies are disallowed
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        // Runs the first update on the calling thread so the first rendered frame has a snapshot to read.
+        bool prime(const UpdateFunc& tUpdate);
+
+        // Kicks the next update on a worker, renders the published snapshot on the calling thread, then waits for
+        // the update to finish and publishes its snapshot. Returns false if either callback asked to stop.
+        bool runFrame(const UpdateFunc& tUpdate, const RenderFunc& tRender);
+
+        [[nodiscard]] u32 getPublishedSnapshot() const { return mPublishedSnapshot; }
+
+    private:
+        // Completion of the in-flight update. The task still touches it after runFrame has been released (the
+        // notify follows the store), so the task holds its own reference and the pipeline may be destroyed first.
+        struct UpdateSignal {
+            std::atomic<bool> mIsDone{true};
+            bool              mResult{true};
+        };
+
+        WorkQueue*                    mWorkQueue{nullptr};
+        u32                           mPublishedSnapshot{0};
+        std::shared_ptr<UpdateSignal> mUpdate{std::make_shared<UpdateSignal>()};
+    };
+} // ct
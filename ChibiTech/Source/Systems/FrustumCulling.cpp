@@ -0,0 +1,280 @@
+#include "FrustumCulling.h"
+#include "WorkQueue.h"
+
+#include <Platform/Assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <vector>
+
+namespace ct {
+    namespace {
+        using Lane = simd::f32xN;
+        constexpr u32 cLaneWidth = simd::cNativeWidth;
+
+        // Small enough that a frame's worth of objects spreads across every worker, large enough that the task
+        // overhead stays well under the cost of culling the chunk.
+        constexpr u32 cMinChunkSize = 1024;
+
+        // Gathers the tail of a stream into a full register, repeating the last valid element.
+        Lane loadTail(const f32* tStream, u32 tBegin, u32 tCount)
+        {
+            f32 lanes[cLaneWidth];
+            for (u32 i = 0; i < cLaneWidth; ++i) {
+                lanes[i] = tStream[tBegin + std::min(i, tCount - 1)];
+            }
+            return simd::loadN(lanes);
+        }
+
+        u32 appendVisible(u32 tVisibleMask, u32 tBaseIndex, u32* tOut)
+        {
+            u32 written = 0;
+            while (tVisibleMask) {
+                tOut[written++] = tBaseIndex + (u32)std::countr_zero(tVisibleMask);
+                tVisibleMask &= tVisibleMask - 1;
+            }
+            return written;
+        }
+
+        struct SpherePlanes
+        {
+            Lane mNormalX[FrustumPlanes::Count];
+            Lane mNormalY[FrustumPlanes::Count];
+            Lane mNormalZ[FrustumPlanes::Count];
+            Lane mDistance[FrustumPlanes::Count];
+
+            explicit SpherePlanes(const FrustumPlanes& tFrustum)
+            {
+                for (u32 i = 0; i < FrustumPlanes::Count; ++i) {
+                    mNormalX[i]  = simd::splatN(tFrustum.mPlanes[i].X);
+                    mNormalY[i]  = simd::splatN(tFrustum.mPlanes[i].Y);
+                    mNormalZ[i]  = simd::splatN(tFrustum.mPlanes[i].Z);
+                    mDistance[i] = simd::splatN(tFrustum.mPlanes[i].W);
+                }
+            }
+
+            // Bit i is set when lane i lies entirely behind at least one plane.
+            u32 outsideMask(Lane tX, Lane tY, Lane tZ, Lane tNegRadius) const
+            {
+                using namespace simd;
+
+                Lane outside = splatN(0.0f);
+                for (u32 i = 0; i < FrustumPlanes::Count; ++i) {
+                    Lane distance = mul(mNormalX[i], tX);
+                    distance = add(distance, mul(mNormalY[i], tY));
+                    distance = add(distance, mul(mNormalZ[i], tZ));
+                    distance = add(distance, mDistance[i]);
+                    outside  = bitOr(outside, lessThan(distance, tNegRadius));
+                }
+                return moveMask(outside);
+            }
+        };
+
+        u32 cullSpheresRange(const SpherePlanes& tPlanes, const BoundingSpheresSoA& tSpheres, u32 tBegin, u32 tEnd, u32* tOut)
+        {
+            constexpr u32 cFullMask = (1u << cLaneWidth) - 1;
+            const Lane zero = simd::splatN(0.0f);
+
+            u32 written = 0;
+            u32 i       = tBegin;
+            for (; i + cLaneWidth <= tEnd; i += cLaneWidth) {
+                const u32 outside = tPlanes.outsideMask(
+                    simd::loadN(tSpheres.mCenterX + i), simd::loadN(tSpheres.mCenterY + i), simd::loadN(tSpheres.mCenterZ + i),
+                    simd::sub(zero, simd::loadN(tSpheres.mRadius + i)));
+                written += appendVisible(~outside & cFullMask, i, tOut + written);
+            }
+
+            if (i < tEnd) {
+                const u32 remaining = tEnd - i;
+                const u32 outside   = tPlanes.outsideMask(
+                    loadTail(tSpheres.mCenterX, i, remaining), loadTail(tSpheres.mCenterY, i, remaining), loadTail(tSpheres.mCenterZ, i, remaining),
+                    simd::sub(zero, loadTail(tSpheres.mRadius, i, remaining)));
+                written += appendVisible(~outside & ((1u << remaining) - 1), i, tOut + written);
+            }
+
+            return written;
+        }
+
+        // For a box, only the corner furthest along the plane normal (the "positive vertex") needs testing. Which
+        // corner that is depends only on the sign of the normal, so it's resolved once per plane, not per box.
+        struct BoxPlanes
+        {
+            SpherePlanes mPlanes;
+            bool         mUseMaxX[FrustumPlanes::Count];
+            bool         mUseMaxY[FrustumPlanes::Count];
+            bool         mUseMaxZ[FrustumPlanes::Count];
+
+            explicit BoxPlanes(const FrustumPlanes& tFrustum) : mPlanes(tFrustum)
+            {
+                for (u32 i = 0; i < FrustumPlanes::Count; ++i) {
+                    mUseMaxX[i] = tFrustum.mPlanes[i].X >= 0.0f;
+                    mUseMaxY[i] = tFrustum.mPlanes[i].Y >= 0.0f;
+                    mUseMaxZ[i] = tFrustum.mPlanes[i].Z >= 0.0f;
+                }
+            }
+
+            u32 outsideMask(const Lane (&tMin)[3], const Lane (&tMax)[3]) const
+            {
+                using namespace simd;
+
+                const Lane zero = splatN(0.0f);
+
+                Lane outside = zero;
+                for (u32 i = 0; i < FrustumPlanes::Count; ++i) {
+                    Lane distance = mul(mPlanes.mNormalX[i], mUseMaxX[i] ? tMax[0] : tMin[0]);
+                    distance = add(distance, mul(mPlanes.mNormalY[i], mUseMaxY[i] ? tMax[1] : tMin[1]));
+                    distance = add(distance, mul(mPlanes.mNormalZ[i], mUseMaxZ[i] ? tMax[2] : tMin[2]));
+                    distance = add(distance, mPlanes.mDistance[i]);
+                    outside  = bitOr(outside, lessThan(distance, zero));
+                }
+                return moveMask(outside);
+            }
+        };
+
+        u32 cullBoxesRange(const BoxPlanes& tPlanes, const BoundingBoxesSoA& tBoxes, u32 tBegin, u32 tEnd, u32* tOut)
+        {
+            constexpr u32 cFullMask = (1u << cLaneWidth) - 1;
+
+            u32 written = 0;
+            u32 i       = tBegin;
+            for (; i + cLaneWidth <= tEnd; i += cLaneWidth) {
+                const Lane boxMin[3] = { simd::loadN(tBoxes.mMinX + i), simd::loadN(tBoxes.mMinY + i), simd::loadN(tBoxes.mMinZ + i) };
+                const Lane boxMax[3] = { simd::loadN(tBoxes.mMaxX + i), simd::loadN(tBoxes.mMaxY + i), simd::loadN(tBoxes.mMaxZ + i) };
+                written += appendVisible(~tPlanes.outsideMask(boxMin, boxMax) & cFullMask, i, tOut + written);
+            }
+
+            if (i < tEnd) {
+                const u32  remaining = tEnd - i;
+                const Lane boxMin[3] = { loadTail(tBoxes.mMinX, i, remaining), loadTail(tBoxes.mMinY, i, remaining), loadTail(tBoxes.mMinZ, i, remaining) };
+                const Lane boxMax[3] = { loadTail(tBoxes.mMaxX, i, remaining), loadTail(tBoxes.mMaxY, i, remaining), loadTail(tBoxes.mMaxZ, i, remaining) };
+                written += appendVisible(~tPlanes.outsideMask(boxMin, boxMax) & ((1u << remaining) - 1), i, tOut + written);
+            }
+
+            return written;
+        }
+
+        // Each chunk writes its visible indices to the start of its own slice of the output (a chunk can never
+        // produce more indices than it has objects), then the slices are packed down in order.
+        template<typename CullRangeFunc>
+        u32 cullParallel(WorkQueue& tWorkQueue, u32 tCount, std::span<u32> tOutVisible, CullRangeFunc&& tCullRange)
+        {
+            const u32 workerCount = (u32)tWorkQueue.getThreadCount() + 1;
+
+            u32 chunkSize = std::max(cMinChunkSize, (tCount + workerCount - 1) / workerCount);
+            chunkSize     = (chunkSize + cLaneWidth - 1) / cLaneWidth * cLaneWidth;
+
+            const u32 chunkCount = (tCount + chunkSize - 1) / chunkSize;
+            if (chunkCount <= 1 || workerCount == 1) {
+                return tCullRange(0, tCount, tOutVisible.data());
+            }
+
+            // Tasks may still be touching this after the caller is released, so it's shared rather than on the stack.
+            struct SharedState
+            {
+                std::atomic<u32> mRemainingChunks;
+                std::vector<u32> mVisibleCounts;
+            };
+
+            auto state = std::make_shared<SharedState>();
+            state->mRemainingChunks.store(chunkCount - 1);
+            state->mVisibleCounts.resize(chunkCount);
+
+            for (u32 chunk = 1; chunk < chunkCount; ++chunk) {
+                tWorkQueue.addTask([state, chunk, chunkSize, tCount, &tCullRange, tOutVisible] {
+                    const u32 begin = chunk * chunkSize;
+                    const u32 end   = std::min(begin + chunkSize, tCount);
+                    state->mVisibleCounts[chunk] = tCullRange(begin, end, tOutVisible.data() + begin);
+
+                    if (state->mRemainingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        state->mRemainingChunks.notify_one();
+                    }
+                }, TaskPriority::FrameCritical);
+            }
+            tWorkQueue.signalThreads();
+
+            state->mVisibleCounts[0] = tCullRange(0, std::min(chunkSize, tCount), tOutVisible.data());
+
+            for (u32 remaining = state->mRemainingChunks.load(std::memory_order_acquire); remaining != 0;
+                 remaining = state->mRemainingChunks.load(std::memory_order_acquire)) {
+                state->mRemainingChunks.wait(remaining, std::memory_order_acquire);
+            }
+
+            u32 visibleCount = state->mVisibleCounts[0];
+            for (u32 chunk = 1; chunk < chunkCount; ++chunk) {
+                const u32* slice = tOutVisible.data() + chunk * chunkSize;
+                std::copy(slice, slice + state->mVisibleCounts[chunk], tOutVisible.data() + visibleCount);
+                visibleCount += state->mVisibleCounts[chunk];
+            }
+
+            return visibleCount;
+        }
+    }
+
+    FrustumPlanes extractFrustumPlanes(const mat4& tViewProjection)
+    {
+        // Gribb/Hartmann: every clip-space bound (-w <= x <= w, ...) is a plane in world space, formed from the
+        // matrix rows.
+        const auto row = [&](int tRow) -> float4 {
+            return { tViewProjection.Ptr[0][tRow], tViewProjection.Ptr[1][tRow], tViewProjection.Ptr[2][tRow], tViewProjection.Ptr[3][tRow] };
+        };
+
+        const float4 r0 = row(0);
+        const float4 r1 = row(1);
+        const float4 r2 = row(2);
+        const float4 r3 = row(3);
+
+        FrustumPlanes result;
+        result.mPlanes[FrustumPlanes::Left]   = r3 + r0;
+        result.mPlanes[FrustumPlanes::Right]  = r3 - r0;
+        result.mPlanes[FrustumPlanes::Bottom] = r3 + r1;
+        result.mPlanes[FrustumPlanes::Top]    = r3 - r1;
+        result.mPlanes[FrustumPlanes::Near]   = r3 + r2;
+        result.mPlanes[FrustumPlanes::Far]    = r3 - r2;
+
+        for (float4& plane : result.mPlanes) {
+            const f32 length = plane.XYZ.length();
+            ASSERT(length > 0.0f);
+            plane = plane * (1.0f / length);
+        }
+
+        return result;
+    }
+
+    u32 cullSpheres(const FrustumPlanes& tFrustum, const BoundingSpheresSoA& tSpheres, std::span<u32> tOutVisible)
+    {
+        ASSERT(tOutVisible.size() >= tSpheres.mCount);
+
+        const SpherePlanes planes(tFrustum);
+        return cullSpheresRange(planes, tSpheres, 0, tSpheres.mCount, tOutVisible.data());
+    }
+
+    u32 cullBoxes(const FrustumPlanes& tFrustum, const BoundingBoxesSoA& tBoxes, std::span<u32> tOutVisible)
+    {
+        ASSERT(tOutVisible.size() >= tBoxes.mCount);
+
+        const BoxPlanes planes(tFrustum);
+        return cullBoxesRange(planes, tBoxes, 0, tBoxes.mCount, tOutVisible.data());
+    }
+
+    u32 cullSpheres(WorkQueue& tWorkQueue, const FrustumPlanes& tFrustum, const BoundingSpheresSoA& tSpheres, std::span<u32> tOutVisible)
+    {
+        ASSERT(tOutVisible.size() >= tSpheres.mCount);
+
+        const SpherePlanes planes(tFrustum);
+        return cullParallel(tWorkQueue, tSpheres.mCount, tOutVisible, [&](u32 tBegin, u32 tEnd, u32* tOut) {
+            return cullSpheresRange(planes, tSpheres, tBegin, tEnd, tOut);
+        });
+    }
+
+    u32 cullBoxes(WorkQueue& tWorkQueue, const FrustumPlanes& tFrustum, const BoundingBoxesSoA& tBoxes, std::span<u32> tOutVisible)
+    {
+        ASSERT(tOutVisible.size() >= tBoxes.mCount);
+
+        const BoxPlanes planes(tFrustum);
+        return cullParallel(tWorkQueue, tBoxes.mCount, tOutVisible, [&](u32 tBegin, u32 tEnd, u32* tOut) {
+            return cullBoxesRange(planes, tBoxes, tBegin, tEnd, tOut);
+        });
+    }
+} // ct
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <span>
+
+#include <Math/Math.h>
+
+namespace ct {
+    class WorkQueue;
+
+    // Plane equations in the form dot(Normal, Point) + W >= 0 for points inside the frustum. Normals point inward
+    // and are unit length, so W is a signed distance.
+    struct FrustumPlanes
+    {
+        enum Plane : u32 { Left, Right, Bottom, Top, Near, Far, Count };
+
+        float4 mPlanes[Plane::Count];
+    };
+
+    // Extracts the planes from a combined projection * view matrix, i.e. mat4MulRH(perspectiveMatrixRh(...),
+    // lookAtMatrixRh(...)). Expects the OpenGL style [-1, 1] clip-space depth that perspectiveMatrixRh produces.
+    FrustumPlanes extractFrustumPlanes(const mat4& tViewProjection);
+
+    // Bounding volumes are read as SoA streams so the culling kernel can test a full register of objects per
+    // plane. Every stream must hold mCount elements.
+    struct BoundingSpheresSoA
+    {
+        const f32* mCenterX{nullptr};
+        const f32* mCenterY{nullptr};
+        const f32* mCenterZ{nullptr};
+        const f32* mRadius{nullptr};
+        u32        mCount{0};
+    };
+
+    struct BoundingBoxesSoA
+    {
+        const f32* mMinX{nullptr};
+        const f32* mMinY{nullptr};
+        const f32* mMinZ{nullptr};
+        const f32* mMaxX{nullptr};
+        const f32* mMaxY{nullptr};
+        const f32* mMaxZ{nullptr};
+        u32        mCount{0};
+    };
+
+    // Writes the indices of every volume that intersects the frustum into tOutVisible, in ascending order, and
+    // returns how many were written. tOutVisible must be able to hold mCount indices.
+    //
+    // The test is conservative: a volume near a frustum corner may be reported visible while being just outside.
+    u32 cullSpheres(const FrustumPlanes& tFrustum, const BoundingSpheresSoA& tSpheres, std::span<u32> tOutVisible);
+    u32 cullBoxes(const FrustumPlanes& tFrustum, const BoundingBoxesSoA& tBoxes, std::span<u32> tOutVisible);
+
+    // Same as above, but splits the input into chunks that run on tWorkQueue as FrameCritical tasks. The calling
+    // thread culls the first chunk itself and then waits for the rest. Output is identical to the serial version.
+    u32 cullSpheres(WorkQueue& tWorkQueue, const FrustumPlanes& tFrustum, const BoundingSpheresSoA& tSpheres, std::span<u32> tOutVisible);
+    u32 cullBoxes(WorkQueue& tWorkQueue, const FrustumPlanes& tFrustum, const BoundingBoxesSoA& tBoxes, std::span<u32> tOutVisible);
+} // ct
@@ -0,0 +1,83 @@
+#include "ParallelFor.h"
+
+#include <Math/MathBatch.h>
+#include <Platform/Assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace ct {
+    namespace {
+        // Shared with the worker tasks. Tasks that only start after every block has been claimed still touch the
+        // counters, so the state outlives the call and tFunc is only reached while the caller is waiting.
+        struct ParallelForState {
+            const ParallelForFunc* mFunc{nullptr};
+            u64                    mCount{0};
+            u64                    mBlockSize{0};
+            u64                    mBlockCount{0};
+            std::atomic<u64>       mNextBlock{0};
+            std::atomic<u64>       mDoneBlocks{0};
+        };
+
+        void runBlocks(ParallelForState& tState) {
+            while (true) {
+                const u64 block = tState.mNextBlock.fetch_add(1, std::memory_order_relaxed);
+                if (block >= tState.mBlockCount) {
+                    return;
+                }
+
+                const u64 begin = block * tState.mBlockSize;
+                const u64 end   = std::min(begin + tState.mBlockSize, tState.mCount);
+                (*tState.mFunc)(begin, end, block);
+
+                if (tState.mDoneBlocks.fetch_add(1, std::memory_order_acq_rel) + 1 == tState.mBlockCount) {
+                    tState.mDoneBlocks.notify_all();
+                }
+            }
+        }
+    }
+
+    void parallelFor(WorkQueue* tWorkQueue, u64 tCount, u64 tBlockSize, const ParallelForFunc& tFunc, TaskPriority tPriority) {
+        ASSERT(tBlockSize > 0);
+        if (tCount == 0) {
+            return;
+        }
+
+        const u64 blockCount = (tCount + tBlockSize - 1) / tBlockSize;
+        if (!tWorkQueue || blockCount == 1) {
+            for (u64 block = 0; block < blockCount; ++block) {
+                const u64 begin = block * tBlockSize;
+                tFunc(begin, std::min(begin + tBlockSize, tCount), block);
+            }
+            return;
+        }
+
+        auto state = std::make_shared<ParallelForState>();
+        state->mFunc       = &tFunc;
+        state->mCount      = tCount;
+        state->mBlockSize  = tBlockSize;
+        state->mBlockCount = blockCount;
+
+        // The calling thread takes blocks too, so one task fewer than blocks is enough.
+        const u64 taskCount = std::min<u64>(blockCount - 1, (u64)tWorkQueue->getThreadCount());
+        for (u64 task = 0; task < taskCount; ++task) {
+            tWorkQueue->addTask([state] { runBlocks(*state); }, tPriority);
+        }
+        tWorkQueue->signalThreads();
+
+        runBlocks(*state);
+
+        u64 doneBlocks = state->mDoneBlocks.load(std::memory_order_acquire);
+        while (doneBlocks != blockCount) {
+            state->mDoneBlocks.wait(doneBlocks, std::memory_order_acquire);
+            doneBlocks = state->mDoneBlocks.load(std::memory_order_acquire);
+        }
+    }
+
+    f32 parallelSum(WorkQueue* tWorkQueue, std::span<const f32> tValues) {
+        return parallelReduce(tWorkQueue, tValues.size(), cParallelSumBlockSize, 0.0f,
+            [tValues](u64 tBegin, u64 tEnd) { return sumArray(tValues.subspan(tBegin, tEnd - tBegin)); },
+            [](f32 tLeft, f32 tRight) { return tLeft + tRight; });
+    }
+} // ct
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <Types.h>
+
+#include "WorkQueue.h"
+
+namespace ct {
+    // Data-parallel loops on top of the WorkQueue.
+    //
+    // The range is cut into blocks of a fixed size, so block boundaries only depend on the element count and the
+    // block size, never on the number of workers or on which worker ran a block. The calling thread works through
+    // blocks as well, so calling these from a worker cannot deadlock, and a null work queue runs everything on the
+    // calling thread.
+    //
+    // parallelReduce stores one partial result per block and combines them in block order on the calling thread.
+    // Together with a deterministic block function this makes reductions bit-reproducible for any thread count,
+    // which is what CT_MATH_DETERMINISTIC builds rely on for parallel sums.
+
+    // Called once per block with the block's element range [tBegin, tEnd) and its index.
+    using ParallelForFunc = std::function<void(u64 tBegin, u64 tEnd, u64 tBlock)>;
+
+    // Block size for parallelSum, a multiple of the 8 partial sums used by sumArray.
+    constexpr u64 cParallelSumBlockSize = 16384;
+
+    // Returns once every block has run.
+    void parallelFor(WorkQueue* tWorkQueue, u64 tCount, u64 tBlockSize, const ParallelForFunc& tFunc,
+                     TaskPriority tPriority = TaskPriority::FrameCritical);
+
+    // tReduceBlock(tBegin, tEnd) -> T reduces one block, tCombine(T, T) -> T folds the block results left to right,
+    // starting from tIdentity.
+    template<typename T, typename BlockFunc, typename CombineFunc>
+    T parallelReduce(WorkQueue* tWorkQueue, u64 tCount, u64 tBlockSize, T tIdentity, BlockFunc&& tReduceBlock,
+                     CombineFunc&& tCombine, TaskPriority tPriority = TaskPriority::FrameCritical)
+    {
+        if (tCount == 0) {
+            return tIdentity;
+        }
+
+        std::vector<T> partials((tCount + tBlockSize - 1) / tBlockSize, tIdentity);
+        parallelFor(tWorkQueue, tCount, tBlockSize, [&](u64 tBegin, u64 tEnd, u64 tBlock) {
+            partials[tBlock] = tReduceBlock(tBegin, tEnd);
+        }, tPriority);
+
+        T result = tIdentity;
+        for (const T& partial : partials) {
+            result = tCombine(result, partial);
+        }
+        return result;
+    }
+
+    // Same bits for every thread count and SIMD backend.
+    f32 parallelSum(WorkQueue* tWorkQueue, std::span<const f32> tValues);
+} // ct
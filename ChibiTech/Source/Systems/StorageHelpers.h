@@ -0,0 +1,77 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <Types.h>
+#include <Platform/Platform.h>
+
+#include "ParallelFor.h"
+
+namespace ct {
+    // Parallel loops and file snapshots for the util storages (SparseStorage, ConcurrentSparseStorage, DenseStorage).
+    //
+    // The storages live in Util and know nothing about threads or files. They expose a block size and a visit over a
+    // row range, these helpers spread the ranges over the WorkQueue:
+    //
+    // ct::forEachParallel<Position, Velocity>(workQueue, pool, [](Position& position, const Velocity& velocity) {});
+    // const f32 mass = ct::reduceParallel<Body>(workQueue, pool, 0.0f,
+    //     [](f32& sum, const Body& body) { sum += body.mMass; }, std::plus<f32>{});
+
+    // Calls tFunc(Xs&...) for every live row, or tFunc(IdType, Xs&...) if it accepts a handle, spread over the work
+    // queue. Rows are visited in blocks, rows within a block in order. tFunc must not create or destroy.
+    template<typename... Xs, typename Storage, typename Func>
+    void forEachParallel(WorkQueue* tWorkQueue, Storage& tStorage, Func&& tFunc)
+    {
+        const u64 blockRows = Storage::template getParallelBlockRows<Xs...>();
+
+        parallelFor(tWorkQueue, tStorage.size(), blockRows, [&](u64 tBegin, u64 tEnd, u64) {
+            tStorage.template forEachInRange<Xs...>(tBegin, tEnd, tFunc);
+        });
+    }
+
+    // Per-block reduction over the live rows. Each block starts from tIdentity and calls tFunc(T& accumulator,
+    // [IdType,] Xs&...) per row, then the block results are folded in block order with tCombine(T, T) -> T. The block
+    // layout only depends on the storage size, so the result does not depend on the worker count.
+    template<typename... Xs, typename Storage, typename T, typename Func, typename CombineFunc>
+    T reduceParallel(WorkQueue* tWorkQueue, Storage& tStorage, T tIdentity, Func&& tFunc, CombineFunc&& tCombine)
+    {
+        using IdType = typename Storage::IdType;
+
+        const u64 blockRows = Storage::template getParallelBlockRows<Xs...>();
+        constexpr bool cWithId = std::is_invocable_v<Func&, T&, IdType, Xs&...>;
+
+        return parallelReduce(tWorkQueue, tStorage.size(), blockRows, tIdentity, [&](u64 tBegin, u64 tEnd) {
+            T accumulator = tIdentity;
+            if constexpr (cWithId) {
+                tStorage.template forEachInRange<Xs...>(tBegin, tEnd, [&](IdType tId, Xs&... tValues) { tFunc(accumulator, tId, tValues...); });
+            } else {
+                tStorage.template forEachInRange<Xs...>(tBegin, tEnd, [&](Xs&... tValues) { tFunc(accumulator, tValues...); });
+            }
+            return accumulator;
+        }, tCombine);
+    }
+
+    // Writes a SparseStorage snapshot (see SparseStorage::saveSnapshot) to a file.
+    template<typename Storage>
+    bool saveSnapshotToFile(const Storage& tStorage, const std::filesystem::path& tFilepath)
+    {
+        std::vector<u8> buffer(tStorage.getSnapshotSize());
+        return tStorage.saveSnapshot(buffer) && os::writeBufferToFile(tFilepath, buffer.data(), buffer.size());
+    }
+
+    // Maps the file and copies it straight into the columns, there is no per-row parsing.
+    template<typename Storage>
+    bool loadSnapshotFromFile(Storage& tStorage, const std::filesystem::path& tFilepath)
+    {
+        os::MappedFile file{};
+        if (!os::mapFileReadOnly(tFilepath, &file))
+            return false;
+
+        const bool result = tStorage.loadSnapshot(std::span<const u8>(static_cast<const u8*>(file.mData), file.mSize));
+        os::unmapFile(&file);
+        return result;
+    }
+} // ct
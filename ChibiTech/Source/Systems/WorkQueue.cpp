@@ -0,0 +1,320 @@
+#include "WorkQueue.h"
+
+#include <Platform/Assert.h>
+#include <Platform/Console.h>
+#include <Platform/CpuTopology.h>
+
+#include <algorithm>
+#include <tuple>
+
+namespace ct {
+    namespace {
+        // Set for worker threads so that tasks spawned from a worker land in the worker's own cache domain.
+        thread_local const WorkQueue* tlsOwningQueue = nullptr;
+        thread_local u32              tlsWorkerDomain = 0;
+    }
+
+    WorkQueue::WorkQueue(const WorkQueueInfo& tInfo) {
+        mIsRunning.store(true);
+
+        const os::CpuTopology topology = os::queryCpuTopology();
+
+        // Order the eligible cores so that consecutive workers fill a cache domain, then a NUMA node, before moving
+        // on. A partially sized pool then stays within as few domains (and sockets) as possible.
+        std::vector<os::CpuLogicalCore> cores{};
+        for (const auto& core : topology.mLogicalCores) {
+            if (!tInfo.mSkipSmtSiblings || !core.mIsSmtSibling) {
+                cores.push_back(core);
+            }
+        }
+
+        std::sort(cores.begin(), cores.end(), [](const os::CpuLogicalCore& tLeft, const os::CpuLogicalCore& tRight) {
+            return std::tie(tLeft.mNumaNode, tLeft.mCacheDomainId, tLeft.mPhysicalCoreId, tLeft.mLogicalId)
+                 < std::tie(tRight.mNumaNode, tRight.mCacheDomainId, tRight.mPhysicalCoreId, tRight.mLogicalId);
+        });
+
+        // A cgroup quota caps the CPU time of the whole process, more workers than that would only take turns.
+        int maxThreads = cores.empty() ? 1 : (int)cores.size();
+        if (topology.mCpuQuota > 0) {
+            maxThreads = std::min(maxThreads, (int)topology.mCpuQuota);
+        }
+        int threadCount = (tInfo.mNumThreads <= 0 || tInfo.mNumThreads > maxThreads) ? maxThreads : tInfo.mNumThreads;
+        threadCount = (threadCount < 1) ? 1 : threadCount;
+
+        // With a single worker there is nobody left to reserve for frame work, so let background tasks through.
+        mMaxBackgroundWorkers = (threadCount > 1) ? u32(threadCount - 1) : 1;
+
+        // Unpinned workers migrate freely between cores, so cache domains only make sense when pinning.
+        std::vector<u32> workerDomains(threadCount, 0);
+        if (tInfo.mPinThreads && !cores.empty()) {
+            std::vector<u32> topologyToDomain(topology.mCacheDomainCount, ~0u);
+            for (int i = 0; i < threadCount; ++i) {
+                u32& domain = topologyToDomain[cores[i].mCacheDomainId];
+                if (domain == ~0u) {
+                    domain = (u32)mDomains.size();
+                    mDomains.emplace_back().mNumaNode = cores[i].mNumaNode;
+                }
+                workerDomains[i] = domain;
+            }
+        }
+        else {
+            mDomains.emplace_back();
+        }
+
+        // Victims: home domain, then the rest of the NUMA node, then remote nodes.
+        for (u32 home = 0; home < (u32)mDomains.size(); ++home) {
+            auto& victims = mDomains[home].mVictimOrder;
+            victims.push_back(home);
+            for (const bool isSameNode : { true, false }) {
+                for (u32 other = 0; other < (u32)mDomains.size(); ++other) {
+                    if (other != home && (mDomains[other].mNumaNode == mDomains[home].mNumaNode) == isSameNode) {
+                        victims.push_back(other);
+                    }
+                }
+            }
+        }
+
+        mThreadList.reserve(threadCount);
+        for (int i = 0; i < threadCount; ++i) {
+            const int logicalCore = (tInfo.mPinThreads && !cores.empty()) ? (int)cores[i].mLogicalId : -1;
+            mThreadList.emplace_back(threadExecuteWork, this, workerDomains[i], logicalCore);
+        }
+    }
+
+    void WorkQueue::threadExecuteWork(WorkQueue* tWorkQueue, u32 tDomain, int tLogicalCore) {
+        if (tLogicalCore >= 0 && !os::setCurrentThreadAffinity((u32)tLogicalCore)) {
+            console::warn("WorkQueue: failed to pin worker to logical core %d.", tLogicalCore);
+        }
+
+        tlsOwningQueue  = tWorkQueue;
+        tlsWorkerDomain = tDomain;
+
+        Task task{};
+        while (tWorkQueue->threadWaitAndAcquireWork(tDomain, task)) {
+            task.mTaskFunction();
+            tWorkQueue->finishTask(task);
+        }
+    }
+
+    void WorkQueue::finishTask(const Task& tTask) {
+        {
+            std::lock_guard guard(mTaskLock);
+            mTaskCounts[u32(tTask.mPriority)] -= 1;
+
+            if (tTask.mPriority == TaskPriority::Background) {
+                mActiveBackgroundWorkers -= 1;
+            }
+        }
+
+        // A background slot may have opened up, so wake any idle workers as well as the waiting thread.
+        if (tTask.mPriority == TaskPriority::Background) {
+            mTaskCV.notify_one();
+        }
+        mTaskCountCV.notify_all();
+    }
+
+    void WorkQueue::runQueuedTasks() {
+        Task task{};
+        while (true) {
+            {
+                std::lock_guard guard(mTaskLock);
+                if (!canAcquireWorkUnsafe()) {
+                    return;
+                }
+                acquireWorkUnsafe(0, task);
+            }
+
+            task.mTaskFunction();
+            finishTask(task);
+        }
+    }
+
+    size_t WorkQueue::taskCountUnsafe() const {
+        size_t size = 0;
+        for (const size_t count : mQueuedCounts) {
+            size += count;
+        }
+        return size;
+    }
+
+    size_t WorkQueue::taskCount() {
+        std::lock_guard guard(mTaskLock);
+        return taskCountUnsafe();
+    }
+
+    size_t WorkQueue::taskCount(TaskPriority tPriority) {
+        std::lock_guard guard(mTaskLock);
+        return mQueuedCounts[u32(tPriority)];
+    }
+
+    bool WorkQueue::isBackgroundReadyUnsafe() const {
+        // The cap only protects frame work. Once the queue is released everything left is drained as fast as possible.
+        return mQueuedCounts[u32(TaskPriority::Background)] > 0
+               && (mActiveBackgroundWorkers < mMaxBackgroundWorkers || !isRunning());
+    }
+
+    bool WorkQueue::canAcquireWorkUnsafe() const {
+        if (mQueuedCounts[u32(TaskPriority::FrameCritical)] > 0 || mQueuedCounts[u32(TaskPriority::Normal)] > 0) {
+            return true;
+        }
+
+        return isBackgroundReadyUnsafe();
+    }
+
+    TaskPriority WorkQueue::selectLaneUnsafe() const {
+        const bool isBackgroundReady = isBackgroundReadyUnsafe();
+
+        // Starvation protection: background work has been passed over for too long.
+        if (isBackgroundReady && mBackgroundSkipCount >= cBackgroundStarvationLimit) {
+            return TaskPriority::Background;
+        }
+
+        if (mQueuedCounts[u32(TaskPriority::FrameCritical)] > 0) {
+            return TaskPriority::FrameCritical;
+        }
+
+        if (mQueuedCounts[u32(TaskPriority::Normal)] > 0) {
+            return TaskPriority::Normal;
+        }
+
+        ASSERT(isBackgroundReady);
+        return TaskPriority::Background;
+    }
+
+    bool WorkQueue::threadWaitAndAcquireWork(const u32 tDomain, Task& tOutTask) {
+        std::unique_lock lk(mTaskLock);
+        mTaskCV.wait(lk, [this] { return !isRunning() || canAcquireWorkUnsafe(); });
+
+        // After release, workers keep going until the queue is empty so no task is dropped.
+        if (!canAcquireWorkUnsafe()) {
+            return false;
+        }
+
+        acquireWorkUnsafe(tDomain, tOutTask);
+        return true;
+    }
+
+    void WorkQueue::acquireWorkUnsafe(const u32 tDomain, Task& tOutTask) {
+        const TaskPriority lane = selectLaneUnsafe();
+        for (const u32 victim : mDomains[tDomain].mVictimOrder) {
+            auto& queue = mDomains[victim].mLanes[u32(lane)];
+            if (!queue.empty()) {
+                tOutTask = std::move(queue.front());
+                queue.pop_front();
+                break;
+            }
+        }
+        mQueuedCounts[u32(lane)] -= 1;
+
+        if (lane == TaskPriority::Background) {
+            mActiveBackgroundWorkers += 1;
+            mBackgroundSkipCount = 0;
+        }
+        else if (mQueuedCounts[u32(TaskPriority::Background)] > 0) {
+            mBackgroundSkipCount += 1;
+        }
+    }
+
+    void WorkQueue::release() {
+        if (!mIsRunning.exchange(false)) {
+            return;
+        }
+
+        {
+            std::lock_guard guard(mTaskLock);
+            mTaskCV.notify_all();
+        }
+
+        for (auto& thread : mThreadList) {
+            thread.join();
+        }
+        mThreadList.clear();
+
+        {
+            std::lock_guard guard(mTaskLock);
+            mIsReleased = true;
+        }
+
+        // Tasks added while the workers were exiting have nobody left to run them.
+        runQueuedTasks();
+    }
+
+    int WorkQueue::getSystemThreadCount() {
+        return (int)std::thread::hardware_concurrency();
+    }
+
+    int WorkQueue::getPhysicalCoreCount() {
+        const os::CpuTopology topology = os::queryCpuTopology();
+        const int coreCount = topology.mPhysicalCoreCount > 0 ? (int)topology.mPhysicalCoreCount : getSystemThreadCount();
+        return topology.mCpuQuota > 0 ? std::min(coreCount, (int)topology.mCpuQuota) : coreCount;
+    }
+
+    void WorkQueue::addTask(TaskFunc tTaskFunction, TaskPriority tPriority, bool tSignalImmediately) {
+        ASSERT(tPriority < TaskPriority::Count);
+
+        bool isReleased = false;
+        {
+            std::lock_guard guard(mTaskLock);
+
+            // Work spawned by a worker stays in its cache domain, everything else is spread across domains.
+            u32 domain = 0;
+            if (tlsOwningQueue == this) {
+                domain = tlsWorkerDomain;
+            }
+            else {
+                domain = mNextDomain;
+                mNextDomain = (mNextDomain + 1) % (u32)mDomains.size();
+            }
+
+            mDomains[domain].mLanes[u32(tPriority)].push_back({ .mTaskFunction = std::move(tTaskFunction), .mPriority = tPriority });
+            mQueuedCounts[u32(tPriority)] += 1;
+            mTaskCounts[u32(tPriority)] += 1;
+
+            // While release is draining, the exiting workers only wake up for signaled work.
+            if (tSignalImmediately || !isRunning()) {
+                mTaskCV.notify_one();
+            }
+            isReleased = mIsReleased;
+        }
+
+        // No workers are left to pick the task up.
+        if (isReleased) {
+            runQueuedTasks();
+        }
+    }
+
+    void WorkQueue::clearWorkQueue() {
+        std::lock_guard guard(mTaskLock);
+        for (auto& domain : mDomains) {
+            for (size_t lane = 0; lane < cLaneCount; ++lane) {
+                mTaskCounts[lane]   -= domain.mLanes[lane].size();
+                mQueuedCounts[lane] -= domain.mLanes[lane].size();
+                domain.mLanes[lane].clear();
+            }
+        }
+        mBackgroundSkipCount = 0;
+        mTaskCountCV.notify_all();
+    }
+
+    void WorkQueue::signalThreads() {
+        std::lock_guard guard(mTaskLock);
+        mTaskCV.notify_all();
+    }
+
+    void WorkQueue::waitForWorkToComplete() {
+        std::unique_lock lk(mTaskLock);
+        mTaskCV.notify_all(); // make sure any queued, unsignaled work gets picked up
+        mTaskCountCV.wait(lk, [this] {
+            for (const size_t count : mTaskCounts) {
+                if (count > 0) return false;
+            }
+            return true;
+        });
+    }
+
+    void WorkQueue::waitForWorkToComplete(TaskPriority tPriority) {
+        std::unique_lock lk(mTaskLock);
+        mTaskCV.notify_all();
+        mTaskCountCV.wait(lk, [this, tPriority] { return mTaskCounts[u32(tPriority)] == 0; });
+    }
+} // ct
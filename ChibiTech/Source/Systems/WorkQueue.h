@@ -0,0 +1,119 @@
+#pragma once
+
+#include <thread>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include <Types.h>
+
+namespace ct {
+    // Tasks are drained from the highest priority lane first. FrameCritical work is anything the current frame
+    // waits on, Normal is general purpose work, and Background is long-running work (shader compiles, texture
+    // cooking, offline raytracing) that is allowed to span several frames.
+    enum class TaskPriority : u8
+    {
+        FrameCritical,
+        Normal,
+        Background,
+        Count,
+    };
+
+    struct WorkQueueInfo
+    {
+        int  mNumThreads{0};          // <= 0 creates a worker for every eligible core
+        bool mPinThreads{false};      // Pin each worker to a logical core and steal from nearby cache domains first
+        bool mSkipSmtSiblings{false}; // Only place workers on the first hardware thread of each physical core
+    };
+
+    class WorkQueue {
+    public:
+        using TaskFunc = std::function<void()>;
+
+        explicit WorkQueue(int tNumThreads) : WorkQueue(WorkQueueInfo{ .mNumThreads = tNumThreads }) {}
+        explicit WorkQueue(const WorkQueueInfo& tInfo);
+        ~WorkQueue() { release(); }
+
+        // Copies are disallowed
+        WorkQueue(const WorkQueue&) = delete;
+        WorkQueue& operator=(const WorkQueue&) = delete;
+
+        // Stops the workers once every queued task has run, including tasks those tasks spawn. Tasks added after
+        // release has returned run right away on the calling thread.
+        void release();
+
+        static int getSystemThreadCount();
+        static int getPhysicalCoreCount();
+
+        void addTask(TaskFunc tTaskFunction, TaskPriority tPriority = TaskPriority::Normal, bool tSignalImmediately = false);
+
+        bool isRunning() const { return mIsRunning.load(); }
+        size_t taskCount();
+        size_t taskCount(TaskPriority tPriority);
+        void clearWorkQueue();
+
+        void signalThreads();
+
+        // Blocks until every lane has completed. Frame code should prefer waiting on a single lane so that it
+        // is not stalled by background work.
+        void waitForWorkToComplete();
+        void waitForWorkToComplete(TaskPriority tPriority);
+
+        int getThreadCount() const { return (int)mThreadList.size(); }
+        u32 getCacheDomainCount() const { return (u32)mDomains.size(); }
+
+    private:
+        static constexpr size_t cLaneCount = size_t(TaskPriority::Count);
+
+        // After this many tasks have been taken from higher lanes while background work was waiting, the next
+        // free worker runs a background task regardless of what else is queued.
+        static constexpr u32 cBackgroundStarvationLimit = 16;
+
+        struct Task {
+            TaskFunc     mTaskFunction;
+            TaskPriority mPriority;
+        };
+
+        // Workers are grouped by the last-level cache they share. Each domain owns its own set of lanes, and an
+        // idle worker steals from its own domain first, then domains on the same NUMA node, then everything else.
+        struct CacheDomain {
+            std::deque<Task> mLanes[cLaneCount]{};
+            std::vector<u32> mVictimOrder{};
+            u32              mNumaNode{0};
+        };
+
+        static void threadExecuteWork(WorkQueue* tWorkQueue, u32 tDomain, int tLogicalCore);
+
+        // Returns false when the queue has been released and drained, and the worker should exit.
+        bool threadWaitAndAcquireWork(u32 tDomain, Task& tOutTask);
+        void acquireWorkUnsafe(u32 tDomain, Task& tOutTask);
+        void finishTask(const Task& tTask);
+        // Runs queued tasks on the calling thread until none are left.
+        void runQueuedTasks();
+        bool isBackgroundReadyUnsafe() const;
+        bool canAcquireWorkUnsafe() const;
+        TaskPriority selectLaneUnsafe() const;
+        size_t taskCountUnsafe() const;
+
+        std::atomic<bool>         mIsRunning{false};
+        bool                      mIsReleased{false}; // Set once release has joined the workers, guarded by mTaskLock
+        std::condition_variable   mTaskCV{};
+        std::mutex                mTaskLock{};
+        std::vector<CacheDomain>  mDomains{};
+        size_t                    mQueuedCounts[cLaneCount]{};
+        u32                       mNextDomain{0};
+        std::vector<std::jthread> mThreadList{};
+
+        // Background tasks are capped so that at least one worker is always available for frame work.
+        u32                       mMaxBackgroundWorkers{1};
+        u32                       mActiveBackgroundWorkers{0};
+        u32                       mBackgroundSkipCount{0};
+
+        // For the main thread to for current work to be completed
+        size_t                    mTaskCounts[cLaneCount]{};
+        std::condition_variable   mTaskCountCV{};
+    };
+} // ct
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <new>
+#include <numeric>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "Types.h"
+
+//
+// Allocation policy for the storage columns (util::ChunkedArray, util::DenseStorage).
+//
+// Every allocation starts on a 64-byte boundary and is padded to a whole number of 64-byte lines, rounded so that the
+// padding is made of whole elements. A vectorised loop over a column can then use aligned loads and run its last
+// iteration over the padding instead of handling a scalar tail. Allocations of trivially copyable types start out
+// zeroed, so the padding holds zeros or stale elements but never uninitialised memory. The padded accessors of the
+// storages are only available for those types.
+//
+// std::vector<float, util::AlignedAllocator<float>> values(100);
+// std::span<float> padded(values.data(), util::getPaddedCount<float>(values.size())); // 112 floats, 7 lines
+//
+
+namespace util {
+    constexpr size_t cColumnAlignment = 64;
+
+    // Smallest element count >= tCount whose byte size is a whole number of column alignment units.
+    template<class T>
+    constexpr size_t getPaddedCount(size_t tCount)
+    {
+        constexpr size_t cElementsPerUnit = cColumnAlignment / std::gcd(cColumnAlignment, sizeof(T));
+        return (tCount + cElementsPerUnit - 1) / cElementsPerUnit * cElementsPerUnit;
+    }
+
+    // Rows per block for a parallel loop over columns of Ts: at least tMinRows, and rounded up so that a block covers
+    // whole alignment units of every column. Neighbouring blocks then never write to the same cache line.
+    template<class... Ts>
+    constexpr size_t getCacheLineBlockSize(size_t tMinRows)
+    {
+        size_t rowsPerLine = 1;
+        ((rowsPerLine = std::lcm(rowsPerLine, cColumnAlignment / std::gcd(cColumnAlignment, sizeof(Ts)))), ...);
+        return (tMinRows + rowsPerLine - 1) / rowsPerLine * rowsPerLine;
+    }
+
+    template<class T>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        static constexpr size_t cAlignment = std::max(cColumnAlignment, alignof(T));
+
+        AlignedAllocator() = default;
+        template<class U> constexpr AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_t tCount)
+        {
+            const size_t bytes = getPaddedCount<T>(tCount) * sizeof(T);
+            void* memory = ::operator new(bytes, std::align_val_t(cAlignment));
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                memset(memory, 0, bytes);
+            }
+            return static_cast<T*>(memory);
+        }
+
+        void deallocate(T* tPtr, size_t) noexcept
+        {
+            ::operator delete(tPtr, std::align_val_t(cAlignment));
+        }
+
+        template<class U> bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+    };
+} // util
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <new>
+#include <bit>
+#include <utility>
+#include <cstring>
+#include <type_traits>
+#include <cassert>
+
+#include "Types.h"
+#include "AlignedAllocator.h"
+
+//
+// util::ChunkedArray<T, ChunkSize>
+//
+// Growable array that allocates its elements in fixed-size chunks. Growing adds a chunk rather than reallocating,
+// so elements never move and references to them stay valid until the element is popped. Indexing is a shift and a
+// mask into the chunk table.
+//
+// Chunks follow the column allocation policy in AlignedAllocator.h: 64-byte aligned and padded to whole lines.
+// getPaddedChunk returns a chunk rounded up to whole lines for SIMD loops. It needs trivially copyable elements, whose
+// chunks start out zeroed, so the padding is never uninitialised memory.
+//
+// util::ChunkedArray<Foo, 1024> foos;
+// foos.push_back(Foo{});
+// for (size_t chunk = 0; chunk < foos.getChunkCount(); ++chunk) {
+//     for (Foo& foo : foos.getChunk(chunk)) {}
+// }
+//
+
+namespace util {
+    template<class T, size_t ChunkSize = 1024>
+    class ChunkedArray
+    {
+        static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+    public:
+        using value_type = T;
+
+        static constexpr size_t cChunkSize  = ChunkSize;
+        static constexpr size_t cChunkShift = std::countr_zero(ChunkSize);
+        static constexpr size_t cChunkMask  = ChunkSize - 1;
+
+        ChunkedArray() = default;
+        ~ChunkedArray()
+        {
+            clear();
+            for (T* chunk : mChunks) {
+                freeChunk(chunk);
+            }
+        }
+
+        // Copies are disallowed
+        ChunkedArray(const ChunkedArray&) = delete;
+        ChunkedArray& operator=(const ChunkedArray&) = delete;
+
+        T& operator[](size_t tIndex)
+        {
+            assert(tIndex < mSize);
+            return mChunks[tIndex >> cChunkShift][tIndex & cChunkMask];
+        }
+
+        const T& operator[](size_t tIndex) const
+        {
+            assert(tIndex < mSize);
+            return mChunks[tIndex >> cChunkShift][tIndex & cChunkMask];
+        }
+
+        [[nodiscard]] size_t size() const     { return mSize; }
+        [[nodiscard]] size_t capacity() const { return mChunks.size() * ChunkSize; }
+        [[nodiscard]] bool   empty() const    { return mSize == 0; }
+
+        template<class... Xs>
+        T& emplace_back(Xs&&... tValues)
+        {
+            if (mSize == capacity()) {
+                mChunks.push_back(allocateChunk());
+            }
+
+            T* element = &mChunks[mSize >> cChunkShift][mSize & cChunkMask];
+            new (element) T(std::forward<Xs>(tValues)...);
+            mSize += 1;
+            return *element;
+        }
+
+        void push_back(const T& tValue) { emplace_back(tValue); }
+        void push_back(T&& tValue)      { emplace_back(std::move(tValue)); }
+
+        void pop_back()
+        {
+            assert(mSize > 0);
+            (*this)[mSize - 1].~T();
+            mSize -= 1;
+        }
+
+        // Allocates chunks up front, existing elements stay where they are.
+        void reserve(size_t tCapacity)
+        {
+            const size_t chunkCount = (tCapacity + ChunkSize - 1) >> cChunkShift;
+            while (mChunks.size() < chunkCount) {
+                mChunks.push_back(allocateChunk());
+            }
+        }
+
+        // Default constructs or destroys elements at the back until there are tSize of them.
+        void resize(size_t tSize)
+        {
+            reserve(tSize);
+            while (mSize < tSize) {
+                emplace_back();
+            }
+            while (mSize > tSize) {
+                pop_back();
+            }
+        }
+
+        // Destroys every element, the chunks are kept for reuse.
+        void clear()
+        {
+            while (mSize > 0) {
+                pop_back();
+            }
+        }
+
+        // The live elements of one chunk. Every chunk but the last is full.
+        [[nodiscard]] size_t getChunkCount() const { return (mSize + ChunkSize - 1) >> cChunkShift; }
+
+        std::span<T> getChunk(size_t tChunk)
+        {
+            assert(tChunk < getChunkCount());
+            const size_t first = tChunk << cChunkShift;
+            return { mChunks[tChunk], std::min(ChunkSize, mSize - first) };
+        }
+
+        std::span<const T> getChunk(size_t tChunk) const
+        {
+            assert(tChunk < getChunkCount());
+            const size_t first = tChunk << cChunkShift;
+            return { mChunks[tChunk], std::min(ChunkSize, mSize - first) };
+        }
+
+        // getChunk rounded up to whole 64-byte lines. Elements past the live ones are padding.
+        std::span<T> getPaddedChunk(size_t tChunk)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Padding is only readable for trivially copyable elements");
+            return { mChunks[tChunk], getPaddedCount<T>(getChunk(tChunk).size()) };
+        }
+
+        std::span<const T> getPaddedChunk(size_t tChunk) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Padding is only readable for trivially copyable elements");
+            return { mChunks[tChunk], getPaddedCount<T>(getChunk(tChunk).size()) };
+        }
+
+        // Raw copies for trivially copyable elements, one memcpy per chunk. The source and destination need no alignment.
+        void copyBytesTo(void* tDest) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            u8* dest = static_cast<u8*>(tDest);
+            for (size_t chunk = 0; chunk < getChunkCount(); ++chunk) {
+                const std::span<const T> elements = getChunk(chunk);
+                memcpy(dest, elements.data(), elements.size_bytes());
+                dest += elements.size_bytes();
+            }
+        }
+
+        // Replaces the contents with tCount elements read from tSource.
+        void assignBytes(const void* tSource, size_t tCount)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            clear();
+            reserve(tCount);
+            mSize = tCount;
+
+            const u8* source = static_cast<const u8*>(tSource);
+            for (size_t chunk = 0; chunk < getChunkCount(); ++chunk) {
+                const std::span<T> elements = getChunk(chunk);
+                memcpy(elements.data(), source, elements.size_bytes());
+                source += elements.size_bytes();
+            }
+        }
+
+    private:
+        static T* allocateChunk()
+        {
+            return AlignedAllocator<T>().allocate(ChunkSize);
+        }
+
+        static void freeChunk(T* tChunk)
+        {
+            AlignedAllocator<T>().deallocate(tChunk, ChunkSize);
+        }
+
+        std::vector<T*> mChunks{}; // Only the table of chunk pointers is ever reallocated
+        size_t          mSize{0};
+    };
+} // util
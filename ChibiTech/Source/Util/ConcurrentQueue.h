@@ -0,0 +1,254 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <cassert>
+
+#include "Types.h"
+
+//
+// Bounded, lock-free queues for handing work between threads.
+//
+// util::MpmcQueue<T> - Any number of producers and consumers. Based on Dmitry Vyukov's bounded MPMC queue.
+//     See: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// util::SpscQueue<T> - Exactly one producer thread and one consumer thread. A ring buffer with cached indices.
+//
+// Both queues have a fixed, power-of-two capacity chosen at construction. Pushing into a full queue fails
+// rather than blocking or allocating, the caller decides whether to spin, sleep, or drop.
+//
+// util::MpmcQueue<Foo> queue(1024);
+// queue.tryPush(Foo{});
+// if (std::optional<Foo> foo = queue.tryPop()) {}
+//
+
+namespace util {
+    // Fixed rather than std::hardware_destructive_interference_size, which is not ABI-stable across compilers.
+    constexpr size_t cCacheLineSize = 64;
+
+    namespace internal {
+        constexpr size_t roundUpToPowerOfTwo(size_t tValue)
+        {
+            size_t result = 1;
+            while (result < tValue) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        // Uninitialized storage for a single T. Lifetime is managed by the queue.
+        template<class T>
+        struct Slot
+        {
+            alignas(T) unsigned char mBytes[sizeof(T)];
+
+            T* ptr() { return std::launder(reinterpret_cast<T*>(mBytes)); }
+
+            template<class... Xs>
+            void construct(Xs&&... tValues) { new (mBytes) T(std::forward<Xs>(tValues)...); }
+            void destruct() { ptr()->~T(); }
+        };
+    }
+
+    template<class T>
+    class MpmcQueue
+    {
+    public:
+        explicit MpmcQueue(size_t tCapacity)
+        : mCapacity(internal::roundUpToPowerOfTwo(tCapacity < 2 ? 2 : tCapacity))
+        , mMask(mCapacity - 1)
+        , mCells(std::make_unique<Cell[]>(mCapacity))
+        {
+            for (size_t i = 0; i < mCapacity; ++i) {
+                mCells[i].mSequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~MpmcQueue()
+        {
+            while (tryPop().has_value()) {}
+        }
+
+        // Copies are disallowed
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        template<class... Xs>
+        [[nodiscard]] bool tryEmplace(Xs&&... tValues)
+        {
+            size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+            Cell*  cell;
+
+            while (true) {
+                cell = &mCells[pos & mMask];
+                const size_t seq  = cell->mSequence.load(std::memory_order_acquire);
+                const auto   diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (diff == 0) {
+                    // The cell is free for this lap, try to claim it.
+                    if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    // The consumer has not freed the cell from the previous lap, the queue is full.
+                    return false;
+                }
+                else {
+                    pos = mEnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->mValue.construct(std::forward<Xs>(tValues)...);
+            cell->mSequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]] bool tryPush(const T& tValue) { return tryEmplace(tValue); }
+        [[nodiscard]] bool tryPush(T&& tValue)      { return tryEmplace(std::move(tValue)); }
+
+        [[nodiscard]] std::optional<T> tryPop()
+        {
+            size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+            Cell*  cell;
+
+            while (true) {
+                cell = &mCells[pos & mMask];
+                const size_t seq  = cell->mSequence.load(std::memory_order_acquire);
+                const auto   diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+                if (diff == 0) {
+                    if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    // The producer has not published this cell yet, the queue is empty.
+                    return std::nullopt;
+                }
+                else {
+                    pos = mDequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::optional<T> result(std::move(*cell->mValue.ptr()));
+            cell->mValue.destruct();
+
+            // Mark the cell free for the producer's next lap.
+            cell->mSequence.store(pos + mMask + 1, std::memory_order_release);
+            return result;
+        }
+
+        [[nodiscard]] size_t capacity() const { return mCapacity; }
+
+        // Only a snapshot, the value may be stale by the time it is used.
+        [[nodiscard]] size_t sizeApprox() const
+        {
+            const size_t enqueue = mEnqueuePos.load(std::memory_order_relaxed);
+            const size_t dequeue = mDequeuePos.load(std::memory_order_relaxed);
+            return enqueue > dequeue ? enqueue - dequeue : 0;
+        }
+
+    private:
+        struct alignas(cCacheLineSize) Cell
+        {
+            std::atomic<size_t> mSequence{0};
+            internal::Slot<T>   mValue;
+        };
+
+        const size_t            mCapacity;
+        const size_t            mMask;
+        std::unique_ptr<Cell[]> mCells;
+
+        // Producers and consumers each get their own cache line so they don't false-share.
+        alignas(cCacheLineSize) std::atomic<size_t> mEnqueuePos{0};
+        alignas(cCacheLineSize) std::atomic<size_t> mDequeuePos{0};
+    };
+
+    template<class T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue(size_t tCapacity)
+        : mCapacity(internal::roundUpToPowerOfTwo(tCapacity < 2 ? 2 : tCapacity))
+        , mMask(mCapacity - 1)
+        , mSlots(std::make_unique<internal::Slot<T>[]>(mCapacity))
+        {
+        }
+
+        ~SpscQueue()
+        {
+            while (tryPop().has_value()) {}
+        }
+
+        // Copies are disallowed
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Producer thread only
+        template<class... Xs>
+        [[nodiscard]] bool tryEmplace(Xs&&... tValues)
+        {
+            const size_t tail = mTail.load(std::memory_order_relaxed);
+
+            // Only re-read the consumer's index when our cached copy says the ring is full.
+            if (tail - mCachedHead == mCapacity) {
+                mCachedHead = mHead.load(std::memory_order_acquire);
+                if (tail - mCachedHead == mCapacity) {
+                    return false;
+                }
+            }
+
+            mSlots[tail & mMask].construct(std::forward<Xs>(tValues)...);
+            mTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]] bool tryPush(const T& tValue) { return tryEmplace(tValue); }
+        [[nodiscard]] bool tryPush(T&& tValue)      { return tryEmplace(std::move(tValue)); }
+
+        // Consumer thread only
+        [[nodiscard]] std::optional<T> tryPop()
+        {
+            const size_t head = mHead.load(std::memory_order_relaxed);
+
+            if (head == mCachedTail) {
+                mCachedTail = mTail.load(std::memory_order_acquire);
+                if (head == mCachedTail) {
+                    return std::nullopt;
+                }
+            }
+
+            internal::Slot<T>& slot = mSlots[head & mMask];
+            std::optional<T> result(std::move(*slot.ptr()));
+            slot.destruct();
+
+            mHead.store(head + 1, std::memory_order_release);
+            return result;
+        }
+
+        [[nodiscard]] size_t capacity() const { return mCapacity; }
+
+        [[nodiscard]] size_t sizeApprox() const
+        {
+            const size_t tail = mTail.load(std::memory_order_relaxed);
+            const size_t head = mHead.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+    private:
+        const size_t                         mCapacity;
+        const size_t                         mMask;
+        std::unique_ptr<internal::Slot<T>[]> mSlots;
+
+        // Consumer owned line: the read index and the consumer's view of the write index.
+        alignas(cCacheLineSize) std::atomic<size_t> mHead{0};
+        size_t                                      mCachedTail{0};
+
+        // Producer owned line: the write index and the producer's view of the read index.
+        alignas(cCacheLineSize) std::atomic<size_t> mTail{0};
+        size_t                                      mCachedHead{0};
+    };
+} // util
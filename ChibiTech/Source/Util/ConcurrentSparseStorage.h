@@ -0,0 +1,278 @@
+#pragma once
+
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <cassert>
+
+#include "Types.h"
+#include "StorageHandle.h"
+#include "ChunkedArray.h"
+#include "ConcurrentQueue.h"
+#include "AlignedAllocator.h"
+
+//
+// Thread-safe variant of util::SparseStorage. Any thread may create and destroy handles at the same time, without locks.
+//
+// The capacity is fixed at construction. Every column chunk is allocated and every row default constructed up front,
+// so create never allocates and rows never move. Slots are handed out from a bump counter until it reaches the
+// capacity, freed slots go on a lock-free stack threaded through the slot table. The stack head packs the top index
+// with a tag that is bumped on every pop, so a pop that raced with a pop/push of the same slot fails its CAS (ABA).
+//
+// Unlike SparseStorage the free list is LIFO, so a hot slot is reused right away and its generation wraps much sooner.
+// Give it more GenBits than the single-threaded storage would need if handles are held across many create/destroys.
+//
+// Generations are atomic: create writes the row and then publishes the live generation with a release store, destroy
+// flips the generation with a CAS so only one of two racing destroys of the same handle succeeds.
+//
+// Thread-safety covers the slot bookkeeping, not the rows themselves. Reading or writing a row while another thread
+// destroys that same handle is a race, the same as with any other object lifetime. forEachInRange (and so
+// ct::forEachParallel) must not overlap with create or destroy.
+//
+// using EntityPool = util::ConcurrentSparseStorage<20, 12, struct EntityTag, Transform, Health>;
+// EntityPool pool(65536);
+//
+// // On any worker thread:
+// EntityPool::IdType id = pool.create(Transform{}, Health{});
+// Transform& transform = pool.getWritable<Transform>(id);
+// pool.destroy(id);
+//
+
+namespace util {
+    template<u8 IndexBits, u8 GenBits, class UniqueId, class... Args>
+    class ConcurrentSparseStorage
+    {
+        static_assert(IndexBits <= 32, "The free list head packs the index into 32 bits next to its ABA tag.");
+        static_assert((std::is_default_constructible_v<Args> && ...), "Rows are constructed up front and assigned on create.");
+
+    public:
+        using Self = ConcurrentSparseStorage<IndexBits, GenBits, UniqueId, Args...>;
+
+        // Rows per column chunk, see SparseStorage::cRowsPerChunk.
+        static constexpr size_t cRowsPerChunk = 1024;
+
+        template <typename T>
+        using Column = ChunkedArray<T, cRowsPerChunk>;
+
+        using BackingStorage = std::tuple<Column<Args>...>;
+
+    private:
+        using Layout         = internal::HandleLayout<IndexBits, GenBits>;
+        using GenerationType = typename Layout::GenerationType;
+        using IndexType      = typename Layout::IndexType;
+        using IdMask         = typename Layout::IdMask;
+
+        static constexpr IndexType cNullIndex = Layout::cNullIndex;
+
+    public:
+        using IdType = StorageId<Layout, UniqueId>;
+
+        explicit ConcurrentSparseStorage(size_t tMaxObjects)
+        : mMaxObjects(tMaxObjects)
+        {
+            assert(tMaxObjects < cNullIndex && "ConcurrentSparseStorage capacity does not fit in IndexBits");
+
+            mSlots.resize(tMaxObjects);
+            std::apply([&](auto&... tColumns) { (tColumns.resize(tMaxObjects), ...); }, mStorage);
+        }
+
+        // Copies are disallowed
+        ConcurrentSparseStorage(const Self&) = delete;
+        ConcurrentSparseStorage& operator=(const Self&) = delete;
+
+        // Safe to call from any thread. Returns an invalid id once the storage is full.
+        template <typename... Xs>
+        [[nodiscard]] IdType create(Xs&&... tValues)
+        {
+            IndexType index = popFreeSlot();
+            if (index == cNullIndex)
+            {
+                index = bumpSlot();
+                if (index == cNullIndex)
+                {
+                    assert(false && "ConcurrentSparseStorage is full");
+                    return IdType();
+                }
+            }
+
+            // The slot is exclusively ours until the generation is published.
+            Slot& slot = mSlots[index];
+            const GenerationType gen = markGenerationAsAlive(slot.mGeneration.load(std::memory_order_relaxed));
+
+            replaceImpl(index, std::index_sequence_for<Args...>{}, std::forward_as_tuple(tValues...));
+
+            slot.mGeneration.store(gen, std::memory_order_release);
+            mLiveCount.fetch_add(1, std::memory_order_relaxed);
+
+            return IdType(Layout::makeMask(index, gen));
+        }
+
+        // Safe to call from any thread. Destroying a stale id, or losing a race to destroy the same id, does nothing.
+        void destroy(IdType tId)
+        {
+            const IdMask mask = tId.get();
+            const size_t index = Layout::getIndex(mask);
+            if (mask.mMask == Layout::cInvalidIdMask || index >= mMaxObjects)
+                return;
+
+            GenerationType expected = Layout::getGeneration(mask);
+            if (!Layout::isLiveGeneration(expected))
+                return;
+
+            Slot& slot = mSlots[index];
+            if (!slot.mGeneration.compare_exchange_strong(expected, Layout::markGenerationAsFree(expected),
+                                                          std::memory_order_acq_rel, std::memory_order_relaxed))
+                return;
+
+            mLiveCount.fetch_sub(1, std::memory_order_relaxed);
+            pushFreeSlot(static_cast<IndexType>(index));
+        }
+
+        [[nodiscard]] bool isIdValid(IdType tId) const
+        {
+            const IdMask mask = tId.get();
+            const size_t index = Layout::getIndex(mask);
+            if (mask.mMask == Layout::cInvalidIdMask || index >= mMaxObjects)
+                return false;
+
+            const GenerationType gen = mSlots[index].mGeneration.load(std::memory_order_acquire);
+            return Layout::isLiveGeneration(gen) && gen == Layout::getGeneration(mask);
+        }
+
+        // Slots handed out so far, live or free. Only a snapshot while other threads are creating.
+        [[nodiscard]] size_t size() const { return mHighWater.load(std::memory_order_acquire); }
+        [[nodiscard]] size_t cap() const  { return mMaxObjects; }
+
+        // Only a snapshot while other threads are creating or destroying.
+        [[nodiscard]] size_t getNumLiveObjects() const { return mLiveCount.load(std::memory_order_relaxed); }
+
+        template <typename... Xs>
+        decltype(auto) getWritable(const IdType tId) {
+            assert(isIdValid(tId));
+            return getRowRefs<Xs...>(Layout::getIndex(tId.get()));
+        }
+
+        template <typename... Xs>
+        decltype(auto) getReadable(const IdType tId) const {
+            assert(isIdValid(tId));
+            return getRowRefs<Xs...>(Layout::getIndex(tId.get()));
+        }
+
+        // Minimum rows handed to a worker at a time, see SparseStorage::cParallelBlockRows.
+        static constexpr size_t cParallelBlockRows = 1024;
+
+        template <typename... Xs>
+        static constexpr size_t getParallelBlockRows() {
+            return getCacheLineBlockSize<Slot, Xs...>(cParallelBlockRows);
+        }
+
+        // See SparseStorage::forEachInRange. Must not run concurrently with create or destroy.
+        template <typename... Xs, typename Func>
+        void forEachInRange(size_t tBegin, size_t tEnd, Func&& tFunc)
+        {
+            constexpr bool cWithId = std::is_invocable_v<Func&, IdType, Xs&...>;
+
+            for (size_t row = tBegin; row < tEnd; ++row) {
+                const GenerationType gen = mSlots[row].mGeneration.load(std::memory_order_relaxed);
+                if (!Layout::isLiveGeneration(gen))
+                    continue;
+
+                if constexpr (cWithId) {
+                    tFunc(IdType(Layout::makeMask(static_cast<IndexType>(row), gen)), std::get<Column<Xs>>(mStorage)[row]...);
+                } else {
+                    tFunc(std::get<Column<Xs>>(mStorage)[row]...);
+                }
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<GenerationType> mGeneration{0};
+            std::atomic<IndexType>      mNextFree{cNullIndex};
+        };
+
+        // Free list head: the top slot index in the low 32 bits, the ABA tag in the high 32 bits.
+        static constexpr u64 packHead(IndexType tIndex, u32 tTag) { return (u64(tTag) << 32) | u64(tIndex); }
+        static constexpr IndexType getHeadIndex(u64 tHead)        { return static_cast<IndexType>(tHead & 0xFFFFFFFF); }
+        static constexpr u32 getHeadTag(u64 tHead)                { return static_cast<u32>(tHead >> 32); }
+
+        static constexpr GenerationType markGenerationAsAlive(GenerationType tGeneration)
+        {
+            return Layout::markGenerationAsAlive(tGeneration);
+        }
+
+        IndexType popFreeSlot()
+        {
+            u64 head = mFreeHead.load(std::memory_order_acquire);
+            while (getHeadIndex(head) != cNullIndex)
+            {
+                const IndexType index = getHeadIndex(head);
+                const IndexType next  = mSlots[index].mNextFree.load(std::memory_order_relaxed);
+
+                // If another thread popped this slot (and maybe pushed it back) since we read the head, the tag no
+                // longer matches and the stale "next" is thrown away.
+                if (mFreeHead.compare_exchange_weak(head, packHead(next, getHeadTag(head) + 1),
+                                                    std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    return index;
+                }
+            }
+            return cNullIndex;
+        }
+
+        void pushFreeSlot(IndexType tIndex)
+        {
+            u64 head = mFreeHead.load(std::memory_order_relaxed);
+            do
+            {
+                mSlots[tIndex].mNextFree.store(getHeadIndex(head), std::memory_order_relaxed);
+            } while (!mFreeHead.compare_exchange_weak(head, packHead(tIndex, getHeadTag(head)),
+                                                      std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Hands out a never-used slot, or cNullIndex if every slot has been handed out.
+        IndexType bumpSlot()
+        {
+            size_t index = mHighWater.load(std::memory_order_relaxed);
+            while (index < mMaxObjects)
+            {
+                if (mHighWater.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    return static_cast<IndexType>(index);
+            }
+            return cNullIndex;
+        }
+
+        template <typename T, size_t... I>
+        void replaceImpl(const size_t tIndex, std::integer_sequence<size_t, I...>, T t) {
+            ((std::get<I>(mStorage)[tIndex] = (std::get<I>(t))), ...);
+        }
+
+        template <typename... Xs>
+        decltype(auto) getRowRefs(const size_t tRow) const {
+            if constexpr (sizeof...(Xs) == 1) {
+                return (std::get<Column<Xs>>(mStorage)[tRow], ...);
+            } else {
+                return std::tie(std::get<Column<Xs>>(mStorage)[tRow]...);
+            }
+        }
+
+        template <typename... Xs>
+        decltype(auto) getRowRefs(const size_t tRow) {
+            if constexpr (sizeof...(Xs) == 1) {
+                return (std::get<Column<Xs>>(mStorage)[tRow], ...);
+            } else {
+                return std::tie(std::get<Column<Xs>>(mStorage)[tRow]...);
+            }
+        }
+
+        const size_t   mMaxObjects;
+        BackingStorage mStorage{};
+        Column<Slot>   mSlots{};
+
+        // Written by every create/destroy, each on its own cache line.
+        alignas(cCacheLineSize) std::atomic<u64>    mFreeHead{packHead(cNullIndex, 0)};
+        alignas(cCacheLineSize) std::atomic<size_t> mHighWater{0};
+        alignas(cCacheLineSize) std::atomic<size_t> mLiveCount{0};
+    };
+} // util
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <span>
+#include <type_traits>
+#include <cassert>
+
+#include "Types.h"
+#include "StorageHandle.h"
+#include "AlignedAllocator.h"
+
+//
+// Packed variant of util::SparseStorage. Same handles and column model, but the columns never have holes.
+//
+// A sparse slot table maps each handle to a row in the packed columns, and destroying a row moves the last row into
+// its place (swap-and-pop). Iteration walks rows [0, size()) of each column, so its cost follows the live count
+// rather than the high-water mark, and memory is streamed linearly.
+//
+// Rows move on destroy, so row indices and column spans are only valid until the next destroy. Handles stay valid.
+//
+// struct Position{};
+// struct Velocity{};
+//
+// using ParticlePool = util::DenseStorage<24, 8, struct ParticleTag, Position, Velocity>;
+// auto pool = ParticlePool();
+//
+// ParticlePool::IdType id = pool.create(Position{}, Velocity{});
+// Position& position = pool.getWritable<Position>(id);
+// const auto [position, velocity] = pool.getReadable<Position, Velocity>(id);
+//
+// for (auto [position, velocity] : pool.view<Position, Velocity>()) {}
+// std::span<Position> positions = pool.getColumn<Position>();
+// ct::forEachParallel<Position, Velocity>(workQueue, pool, [](Position& position, const Velocity& velocity) {});
+//
+
+namespace util {
+    template<u8 IndexBits, u8 GenBits, class UniqueId, class... Args>
+    class DenseStorage
+    {
+    public:
+        using Self           = DenseStorage<IndexBits, GenBits, UniqueId, Args...>;
+
+        // Columns are 64-byte aligned and padded to whole lines, see AlignedAllocator.h.
+        template <typename T>
+        using Column = std::vector<T, AlignedAllocator<T>>;
+
+        using BackingStorage = std::tuple<Column<Args>...>;
+
+    private:
+        using Layout         = internal::HandleLayout<IndexBits, GenBits>;
+        using GenerationType = typename Layout::GenerationType;
+        using IndexType      = typename Layout::IndexType;
+        using IdMask         = typename Layout::IdMask;
+
+        static constexpr IndexType cNullIndex = Layout::cNullIndex;
+
+    public:
+        using IdType = StorageId<Layout, UniqueId>;
+
+        DenseStorage() = default;
+        explicit DenseStorage(size_t tMaxObjects) { setMaxObjects(tMaxObjects); }
+
+        // Copies are disallowed
+        DenseStorage(Self&) = delete;
+        DenseStorage& operator=(Self&) = delete;
+
+        template <typename... Xs>
+        [[nodiscard]] IdType create(Xs&&... tValues)
+        {
+            static_assert(sizeof...(Xs) == sizeof...(Args), "create() takes one value per column");
+
+            IndexType slotIndex = mFreeHead;
+            if (slotIndex != cNullIndex)
+            {
+                mFreeHead = mSlots[slotIndex].mRowOrNextFree;
+                if (mFreeHead == cNullIndex)
+                {
+                    mFreeTail = cNullIndex;
+                }
+            }
+            else
+            {
+                // If we have set an upper bound, do not allow for anymore objects to be added to the storage.
+                if ((!mIsResizable && mSlots.size() >= mMaxObjects) || mSlots.size() >= cNullIndex)
+                {
+                    assert(false && "DenseStorage is full");
+                    return IdType();
+                }
+
+                slotIndex = static_cast<IndexType>(mSlots.size());
+                mSlots.push_back({});
+            }
+
+            Slot& slot = mSlots[slotIndex];
+            slot.mGeneration    = Layout::markGenerationAsAlive(slot.mGeneration);
+            slot.mRowOrNextFree = static_cast<IndexType>(mRowToSlot.size());
+
+            mRowToSlot.push_back(slotIndex);
+            pushRow(std::index_sequence_for<Args...>{}, std::forward<Xs>(tValues)...);
+
+            return IdType(Layout::makeMask(slotIndex, slot.mGeneration));
+        }
+
+        void destroy(IdType tId)
+        {
+            if (!isIdValid(tId))
+                return;
+
+            const IndexType slotIndex = Layout::getIndex(tId.get());
+            const size_t    row       = mSlots[slotIndex].mRowOrNextFree;
+            const size_t    lastRow   = mRowToSlot.size() - 1;
+
+            // Swap-and-pop: the last row fills the hole, then the slot that owned it is pointed at its new row.
+            if (row != lastRow)
+            {
+                moveRow(std::index_sequence_for<Args...>{}, lastRow, row);
+                mRowToSlot[row] = mRowToSlot[lastRow];
+                mSlots[mRowToSlot[row]].mRowOrNextFree = static_cast<IndexType>(row);
+            }
+
+            popRow(std::index_sequence_for<Args...>{});
+            mRowToSlot.pop_back();
+
+            // Freed slots go to the back of the list, so a slot is reused as late as possible. That keeps a stale
+            // handle from matching a recycled generation for longer.
+            Slot& slot = mSlots[slotIndex];
+            slot.mGeneration    = Layout::markGenerationAsFree(slot.mGeneration);
+            slot.mRowOrNextFree = cNullIndex;
+
+            if (mFreeTail != cNullIndex)
+            {
+                mSlots[mFreeTail].mRowOrNextFree = slotIndex;
+            }
+            else
+            {
+                mFreeHead = slotIndex;
+            }
+            mFreeTail = slotIndex;
+        }
+
+        // Destroys every row. Outstanding handles go stale.
+        void clear()
+        {
+            while (!mRowToSlot.empty())
+            {
+                const IndexType slotIndex = mRowToSlot.back();
+                destroy(IdType(Layout::makeMask(slotIndex, mSlots[slotIndex].mGeneration)));
+            }
+        }
+
+        // Number of live rows
+        [[nodiscard]] size_t size() const {
+            return mRowToSlot.size();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return mRowToSlot.empty();
+        }
+
+        [[nodiscard]] size_t getNumLiveObjects() const {
+            return size();
+        }
+
+        [[nodiscard]] bool isIdValid(IdType tId) const
+        {
+            const IdMask mask  = tId.get();
+            const size_t index = Layout::getIndex(mask);
+
+            return (mask.mMask != Layout::cInvalidIdMask) && (index < mSlots.size()) && (mSlots[index].mGeneration == Layout::getGeneration(mask));
+        }
+
+        // Current row of a live handle
+        [[nodiscard]] size_t getRow(IdType tId) const
+        {
+            assert(isIdValid(tId));
+            return mSlots[Layout::getIndex(tId.get())].mRowOrNextFree;
+        }
+
+        // Handle of the object currently stored at tRow
+        [[nodiscard]] IdType getId(size_t tRow) const
+        {
+            assert(tRow < size());
+            const IndexType slotIndex = mRowToSlot[tRow];
+            return IdType(Layout::makeMask(slotIndex, mSlots[slotIndex].mGeneration));
+        }
+
+        // Returns a reference for a single column, a tuple of references otherwise.
+        template <typename... Xs>
+        decltype(auto) getWritable(const IdType tId) {
+            return getRowRefs<Xs...>(getRow(tId));
+        }
+
+        template <typename... Xs>
+        decltype(auto) getReadable(const IdType tId) const {
+            return getRowRefs<Xs...>(getRow(tId));
+        }
+
+        template <typename X>
+        std::span<X> getColumn() {
+            return std::get<Column<X>>(mStorage);
+        }
+
+        template <typename X>
+        std::span<const X> getColumn() const {
+            return std::get<Column<X>>(mStorage);
+        }
+
+        // getColumn rounded up to whole 64-byte lines, for SIMD loops without a scalar tail. Elements past size() are
+        // padding, zeros or stale rows. Only for trivially copyable columns, see AlignedAllocator.h.
+        template <typename X>
+        std::span<X> getPaddedColumn() {
+            static_assert(std::is_trivially_copyable_v<X>, "Padding is only readable for trivially copyable columns");
+            Column<X>& column = std::get<Column<X>>(mStorage);
+            return { column.data(), getPaddedCount<X>(column.size()) };
+        }
+
+        template <typename X>
+        std::span<const X> getPaddedColumn() const {
+            static_assert(std::is_trivially_copyable_v<X>, "Padding is only readable for trivially copyable columns");
+            const Column<X>& column = std::get<Column<X>>(mStorage);
+            return { column.data(), getPaddedCount<X>(column.size()) };
+        }
+
+        void setMaxObjects(size_t tSize) {
+            // If this is false, then we've already set this value.
+            assert(mIsResizable);
+            mIsResizable = false;
+            mMaxObjects  = tSize;
+
+            mSlots.reserve(tSize);
+            mRowToSlot.reserve(tSize);
+            std::apply([tSize](auto&... tColumns) { (tColumns.reserve(tSize), ...); }, mStorage);
+        }
+
+    public: // Iteration
+        // Zips the requested columns. Dereferencing yields a tuple of references, so structured bindings write
+        // straight into the columns.
+        template <typename... Xs>
+        class View
+        {
+        public:
+            class Iterator
+            {
+            public:
+                Iterator(std::tuple<Xs*...> tColumns, size_t tRow) : mColumns(tColumns), mRow(tRow) {}
+
+                std::tuple<Xs&...> operator*() const {
+                    return std::apply([this](auto*... tColumns) { return std::tuple<Xs&...>(tColumns[mRow]...); }, mColumns);
+                }
+
+                Iterator& operator++() { ++mRow; return *this; }
+                bool operator!=(const Iterator& tOther) const { return mRow != tOther.mRow; }
+
+            private:
+                std::tuple<Xs*...> mColumns;
+                size_t             mRow;
+            };
+
+            View(std::tuple<Xs*...> tColumns, size_t tSize) : mColumns(tColumns), mSize(tSize) {}
+
+            Iterator begin() const { return Iterator(mColumns, 0); }
+            Iterator end()   const { return Iterator(mColumns, mSize); }
+            size_t   size()  const { return mSize; }
+
+        private:
+            std::tuple<Xs*...> mColumns;
+            size_t             mSize;
+        };
+
+        template <typename... Xs>
+        View<Xs...> view() {
+            return View<Xs...>(std::tuple<Xs*...>(getColumn<Xs>().data()...), size());
+        }
+
+        template <typename... Xs>
+        View<const Xs...> view() const {
+            return View<const Xs...>(std::tuple<const Xs*...>(getColumn<Xs>().data()...), size());
+        }
+
+        // Minimum rows handed to a worker at a time, see ct::forEachParallel/reduceParallel in Systems/StorageHelpers.h.
+        static constexpr size_t cParallelBlockRows = 1024;
+
+        // Rows per parallel block, rounded up to whole cache lines of every column touched.
+        template <typename... Xs>
+        static constexpr size_t getParallelBlockRows() {
+            return getCacheLineBlockSize<Xs...>(cParallelBlockRows);
+        }
+
+        // Calls tFunc(Xs&...) for every row in [tBegin, tEnd), or tFunc(IdType, Xs&...) if it accepts a handle.
+        // tFunc must not create or destroy. Disjoint ranges may run on different threads.
+        template <typename... Xs, typename Func>
+        void forEachInRange(size_t tBegin, size_t tEnd, Func&& tFunc)
+        {
+            constexpr bool cWithId = std::is_invocable_v<Func&, IdType, Xs&...>;
+            const std::tuple<Xs*...> columns(getColumn<Xs>().data()...);
+
+            for (size_t row = tBegin; row < tEnd; ++row) {
+                std::apply([&](auto*... tColumns) {
+                    if constexpr (cWithId) {
+                        const IndexType slotIndex = mRowToSlot[row];
+                        tFunc(IdType(Layout::makeMask(slotIndex, mSlots[slotIndex].mGeneration)), tColumns[row]...);
+                    } else {
+                        tFunc(tColumns[row]...);
+                    }
+                }, columns);
+            }
+        }
+
+    private:
+        // A slot either points at the row of a live object or, while free, at the next free slot.
+        struct Slot
+        {
+            GenerationType mGeneration{0};
+            IndexType      mRowOrNextFree{cNullIndex};
+        };
+
+        template <typename... Xs>
+        decltype(auto) getRowRefs(const size_t tRow) const {
+            if constexpr (sizeof...(Xs) == 1) {
+                return (std::get<Column<Xs>>(mStorage)[tRow], ...);
+            } else {
+                return std::tie(std::get<Column<Xs>>(mStorage)[tRow]...);
+            }
+        }
+
+        template <typename... Xs>
+        decltype(auto) getRowRefs(const size_t tRow) {
+            if constexpr (sizeof...(Xs) == 1) {
+                return (std::get<Column<Xs>>(mStorage)[tRow], ...);
+            } else {
+                return std::tie(std::get<Column<Xs>>(mStorage)[tRow]...);
+            }
+        }
+
+        template <size_t... I, typename... Xs>
+        void pushRow(std::integer_sequence<size_t, I...>, Xs&&... tValues) {
+            ((std::get<I>(mStorage).emplace_back(std::forward<Xs>(tValues))), ...);
+        }
+
+        template <size_t... I>
+        void moveRow(std::integer_sequence<size_t, I...>, size_t tFrom, size_t tTo) {
+            ((std::get<I>(mStorage)[tTo] = std::move(std::get<I>(mStorage)[tFrom])), ...);
+        }
+
+        template <size_t... I>
+        void popRow(std::integer_sequence<size_t, I...>) {
+            ((std::get<I>(mStorage).pop_back()), ...);
+        }
+
+        BackingStorage         mStorage{};            // Packed columns, one row per live object
+        std::vector<IndexType> mRowToSlot{};          // Slot that owns each row, to patch the slot when a row moves
+        std::vector<Slot>      mSlots{};              // Sparse table that handles index into
+        IndexType              mFreeHead{cNullIndex}; // Free slots, threaded through Slot::mRowOrNextFree
+        IndexType              mFreeTail{cNullIndex};
+
+        // Determines if the storage system can resize. Is set to false, when "setMaxObjects()" is called.
+        bool                   mIsResizable{true};
+        size_t                 mMaxObjects{0};
+    };
+} // util
@@ -0,0 +1,587 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+
+#include "Types.h"
+#include "Hash.h"
+
+#if !defined(CT_FLAT_HASH_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define CT_FLAT_HASH_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+//
+// util::FlatHashMap<K, V> and util::FlatHashSet<K>
+//
+// Open-addressing hash tables stored in two flat arrays: one control byte per slot and the slots themselves. The
+// capacity is a power of two and collisions are resolved with linear probing, so a key's probe sequence is one
+// contiguous run of slots starting at its home slot (hash & mask).
+//
+// A control byte is either empty (0x80) or holds the top 7 bits of the slot's hash. Lookups load the control bytes
+// 16 at a time (SSE2, with a scalar fallback) and only compare keys whose hash bits match, a probe over a whole group
+// costs about as much as checking a single slot. The run ends at the first empty byte.
+//
+// There are no tombstones: erase moves the following entries of the run back into the hole (backward shift), so a
+// table that sees a lot of inserts and erases never needs a cleanup rehash. Erase and insert invalidate iterators and
+// references, entries move on rehash and on erase.
+//
+// Keys are hashed with util::FlatHash, which runs integers and pointers through the mixing in Hash.h and hashes
+// strings bytewise. Other key types fall back to std::hash and get mixed the same way.
+//
+// util::FlatHashMap<ID3D12Resource*, GpuResourceState> states;
+// states.try_emplace(resource, GpuResourceState{});
+// if (auto entry = states.find(resource); entry != states.end()) {
+//     entry->second.mState = D3D12_RESOURCE_STATE_COMMON;
+// }
+// states.erase(resource);
+//
+
+namespace util {
+    // Spreads the entropy of a 64 bit value over every bit, the low bits pick the slot and the high bits the tag.
+    inline u64 mixHashBits(u64 tValue)
+    {
+        u64 hash = 0;
+        hash_combine_size_t(hash, tValue);
+        return hash;
+    }
+
+    inline u64 hashBytes(const void* tData, size_t tSize)
+    {
+        const u8* bytes = static_cast<const u8*>(tData);
+
+        u64 hash = tSize;
+        for (; tSize >= sizeof(u64); tSize -= sizeof(u64), bytes += sizeof(u64)) {
+            u64 word;
+            memcpy(&word, bytes, sizeof(u64));
+            hash_combine_size_t(hash, word);
+        }
+
+        if (tSize > 0) {
+            u64 word = 0;
+            memcpy(&word, bytes, tSize);
+            hash_combine_size_t(hash, word);
+        }
+        return hash;
+    }
+
+    template<class T>
+    struct FlatHash
+    {
+        size_t operator()(const T& tValue) const
+        {
+            if constexpr (std::is_pointer_v<T>) {
+                return size_t(mixHashBits(u64(reinterpret_cast<uintptr_t>(tValue))));
+            } else if constexpr (std::is_enum_v<T>) {
+                return size_t(mixHashBits(u64(static_cast<std::underlying_type_t<T>>(tValue))));
+            } else if constexpr (std::is_integral_v<T>) {
+                return size_t(mixHashBits(u64(tValue)));
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                const std::string_view view = tValue;
+                return size_t(hashBytes(view.data(), view.size()));
+            } else {
+                // std::hash is often the identity, which linear probing does not survive.
+                return size_t(mixHashBits(u64(std::hash<T>{}(tValue))));
+            }
+        }
+    };
+
+    namespace internal {
+        constexpr u8     cEmptyControl = 0x80;
+        constexpr size_t cGroupWidth   = 16;
+
+        // 16 consecutive control bytes, starting at any slot. Bit i of a mask refers to the i-th byte of the group.
+        class ControlGroup
+        {
+        public:
+            explicit ControlGroup(const u8* tControl)
+            {
+#if CT_FLAT_HASH_SSE2
+                mBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tControl));
+#else
+                memcpy(mBytes, tControl, cGroupWidth);
+#endif
+            }
+
+            u32 match(u8 tTag) const
+            {
+#if CT_FLAT_HASH_SSE2
+                return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(mBytes, _mm_set1_epi8(char(tTag)))));
+#else
+                u32 mask = 0;
+                for (size_t i = 0; i < cGroupWidth; ++i) {
+                    mask |= u32(mBytes[i] == tTag) << i;
+                }
+                return mask;
+#endif
+            }
+
+            // Only the empty byte has its top bit set.
+            u32 matchEmpty() const
+            {
+#if CT_FLAT_HASH_SSE2
+                return u32(_mm_movemask_epi8(mBytes));
+#else
+                return match(cEmptyControl);
+#endif
+            }
+
+            u32 matchFull() const { return ~matchEmpty() & 0xFFFF; }
+
+        private:
+#if CT_FLAT_HASH_SSE2
+            __m128i mBytes;
+#else
+            u8 mBytes[cGroupWidth];
+#endif
+        };
+
+        template<class K, class V>
+        struct MapPolicy
+        {
+            using key_type   = K;
+            using value_type = std::pair<const K, V>;
+
+            static const K& getKey(const value_type& tValue) { return tValue.first; }
+        };
+
+        template<class K>
+        struct SetPolicy
+        {
+            using key_type   = K;
+            using value_type = K;
+
+            static const K& getKey(const value_type& tValue) { return tValue; }
+        };
+
+        // Storage and probing shared by FlatHashMap and FlatHashSet.
+        template<class Policy, class Hash, class KeyEqual>
+        class FlatHashTable
+        {
+        public:
+            using key_type   = typename Policy::key_type;
+            using value_type = typename Policy::value_type;
+            using Self       = FlatHashTable<Policy, Hash, KeyEqual>;
+
+            // Grows once more than 3/4 of the slots would be full. Linear probing runs get long quickly past that,
+            // at 7/8 lookups that miss the cache were measurably slower in chibi-hash-bench.
+            static constexpr size_t cMaxLoadNumerator   = 3;
+            static constexpr size_t cMaxLoadDenominator = 4;
+            static constexpr size_t cMinCapacity        = cGroupWidth;
+
+            template<bool IsConst>
+            class Iterator
+            {
+            public:
+                using TablePtr  = std::conditional_t<IsConst, const Self*, Self*>;
+                using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+                using pointer   = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+                Iterator() = default;
+                Iterator(TablePtr tTable, size_t tIndex) : mTable(tTable), mIndex(tIndex) {}
+
+                // Non-const to const conversion
+                template<bool WasConst, class = std::enable_if_t<IsConst && !WasConst>>
+                Iterator(const Iterator<WasConst>& tOther) : mTable(tOther.mTable), mIndex(tOther.mIndex) {}
+
+                reference operator*() const  { return mTable->mSlots[mIndex]; }
+                pointer   operator->() const { return &mTable->mSlots[mIndex]; }
+
+                Iterator& operator++()
+                {
+                    mIndex = mTable->skipEmpty(mIndex + 1);
+                    return *this;
+                }
+
+                friend bool operator==(const Iterator& tLeft, const Iterator& tRight) { return tLeft.mIndex == tRight.mIndex; }
+                friend bool operator!=(const Iterator& tLeft, const Iterator& tRight) { return tLeft.mIndex != tRight.mIndex; }
+
+            private:
+                friend Self;
+                template<bool> friend class Iterator;
+
+                TablePtr mTable{nullptr};
+                size_t   mIndex{0};
+            };
+
+            FlatHashTable() = default;
+            ~FlatHashTable() { release(); }
+
+            FlatHashTable(const Self& tOther)
+            : mHash(tOther.mHash), mEqual(tOther.mEqual)
+            {
+                if (tOther.mCapacity == 0)
+                    return;
+
+                // Same capacity, same hash: every entry can be copied into the slot it already occupies.
+                allocate(tOther.mCapacity);
+                memcpy(mControl, tOther.mControl, getControlSize(mCapacity));
+                for (size_t index = tOther.skipEmpty(0); index < mCapacity; index = tOther.skipEmpty(index + 1)) {
+                    new (&mSlots[index]) value_type(tOther.mSlots[index]);
+                }
+                mSize = tOther.mSize;
+            }
+
+            FlatHashTable(Self&& tOther) noexcept
+            : mControl(std::exchange(tOther.mControl, nullptr))
+            , mSlots(std::exchange(tOther.mSlots, nullptr))
+            , mCapacity(std::exchange(tOther.mCapacity, 0))
+            , mSize(std::exchange(tOther.mSize, 0))
+            , mHash(std::move(tOther.mHash))
+            , mEqual(std::move(tOther.mEqual))
+            {
+            }
+
+            Self& operator=(const Self& tOther)
+            {
+                if (this != &tOther) {
+                    Self copy(tOther);
+                    *this = std::move(copy);
+                }
+                return *this;
+            }
+
+            Self& operator=(Self&& tOther) noexcept
+            {
+                if (this != &tOther) {
+                    release();
+                    mControl  = std::exchange(tOther.mControl, nullptr);
+                    mSlots    = std::exchange(tOther.mSlots, nullptr);
+                    mCapacity = std::exchange(tOther.mCapacity, 0);
+                    mSize     = std::exchange(tOther.mSize, 0);
+                    mHash     = std::move(tOther.mHash);
+                    mEqual    = std::move(tOther.mEqual);
+                }
+                return *this;
+            }
+
+            using iterator       = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            iterator       begin()       { return { this, skipEmpty(0) }; }
+            const_iterator begin() const { return { this, skipEmpty(0) }; }
+            iterator       end()         { return { this, mCapacity }; }
+            const_iterator end() const   { return { this, mCapacity }; }
+
+            [[nodiscard]] size_t size() const     { return mSize; }
+            [[nodiscard]] size_t capacity() const { return mCapacity; }
+            [[nodiscard]] bool   empty() const    { return mSize == 0; }
+
+            iterator find(const key_type& tKey)
+            {
+                const size_t index = findIndex(tKey, mHash(tKey));
+                return { this, index == cNotFound ? mCapacity : index };
+            }
+
+            const_iterator find(const key_type& tKey) const
+            {
+                const size_t index = findIndex(tKey, mHash(tKey));
+                return { this, index == cNotFound ? mCapacity : index };
+            }
+
+            [[nodiscard]] bool contains(const key_type& tKey) const
+            {
+                return findIndex(tKey, mHash(tKey)) != cNotFound;
+            }
+
+            // Returns true if the key was present.
+            bool erase(const key_type& tKey)
+            {
+                const size_t index = findIndex(tKey, mHash(tKey));
+                if (index == cNotFound)
+                    return false;
+
+                eraseAt(index);
+                return true;
+            }
+
+            void erase(const_iterator tPosition)
+            {
+                assert(tPosition.mTable == this && tPosition.mIndex < mCapacity);
+                eraseAt(tPosition.mIndex);
+            }
+
+            // Destroys every entry, the slots are kept for reuse.
+            void clear()
+            {
+                if (mSize == 0)
+                    return;
+
+                if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                    for (size_t index = skipEmpty(0); index < mCapacity; index = skipEmpty(index + 1)) {
+                        mSlots[index].~value_type();
+                    }
+                }
+                memset(mControl, cEmptyControl, getControlSize(mCapacity));
+                mSize = 0;
+            }
+
+            // Makes room for tCount entries without rehashing.
+            void reserve(size_t tCount)
+            {
+                const size_t capacity = getCapacityFor(tCount);
+                if (capacity > mCapacity) {
+                    rehash(capacity);
+                }
+            }
+
+        protected:
+            static constexpr size_t cNotFound = SIZE_MAX;
+
+            // Inserts an entry built from tArgs unless tKey is present. tKey is only read before the entry is built,
+            // so it may refer to one of tArgs that gets moved from.
+            template<class... Xs>
+            std::pair<iterator, bool> emplaceWithKey(const key_type& tKey, Xs&&... tArgs)
+            {
+                const size_t hash = mHash(tKey);
+
+                const size_t found = findIndex(tKey, hash);
+                if (found != cNotFound)
+                    return { iterator(this, found), false };
+
+                if ((mSize + 1) * cMaxLoadDenominator > mCapacity * cMaxLoadNumerator) {
+                    rehash(std::max(cMinCapacity, mCapacity * 2));
+                }
+
+                const size_t index = findEmpty(hash);
+                new (&mSlots[index]) value_type(std::forward<Xs>(tArgs)...);
+                setControl(index, getTag(hash));
+                mSize += 1;
+
+                return { iterator(this, index), true };
+            }
+
+        private:
+            static size_t getControlSize(size_t tCapacity) { return tCapacity + cGroupWidth - 1; }
+
+            static size_t getCapacityFor(size_t tCount)
+            {
+                const size_t slots = (tCount * cMaxLoadDenominator + cMaxLoadNumerator - 1) / cMaxLoadNumerator;
+                return std::max(cMinCapacity, std::bit_ceil(slots));
+            }
+
+            static u8 getTag(size_t tHash) { return u8(tHash >> (sizeof(size_t) * 8 - 7)); }
+
+            // The first cGroupWidth - 1 control bytes are mirrored past the end, so a group load that starts near the
+            // end of the table reads the start of the table instead of running off the array.
+            void setControl(size_t tIndex, u8 tControl)
+            {
+                mControl[tIndex] = tControl;
+                if (tIndex < cGroupWidth - 1) {
+                    mControl[mCapacity + tIndex] = tControl;
+                }
+            }
+
+            size_t findIndex(const key_type& tKey, size_t tHash) const
+            {
+                if (mCapacity == 0)
+                    return cNotFound;
+
+                const u8     tag      = getTag(tHash);
+                const size_t mask     = mCapacity - 1;
+                size_t       position = tHash & mask;
+                while (true) {
+                    const ControlGroup group(mControl + position);
+                    const u32 empty = group.matchEmpty();
+
+                    // Entries past the first empty byte belong to another run.
+                    u32 candidates = group.match(tag);
+                    if (empty != 0) {
+                        candidates &= (empty & (0u - empty)) - 1;
+                    }
+
+                    for (; candidates != 0; candidates &= candidates - 1) {
+                        const size_t index = (position + std::countr_zero(candidates)) & mask;
+                        if (mEqual(Policy::getKey(mSlots[index]), tKey))
+                            return index;
+                    }
+
+                    if (empty != 0)
+                        return cNotFound;
+
+                    position = (position + cGroupWidth) & mask;
+                }
+            }
+
+            // The end of the run that starts at tHash's home slot. The table always has an empty slot.
+            size_t findEmpty(size_t tHash) const
+            {
+                const size_t mask     = mCapacity - 1;
+                size_t       position = tHash & mask;
+                while (true) {
+                    const u32 empty = ControlGroup(mControl + position).matchEmpty();
+                    if (empty != 0)
+                        return (position + std::countr_zero(empty)) & mask;
+
+                    position = (position + cGroupWidth) & mask;
+                }
+            }
+
+            // The first full slot at or after tIndex, or mCapacity.
+            size_t skipEmpty(size_t tIndex) const
+            {
+                for (; tIndex < mCapacity; tIndex += cGroupWidth) {
+                    const u32 full = ControlGroup(mControl + tIndex).matchFull();
+                    if (full != 0)
+                        return std::min(tIndex + std::countr_zero(full), mCapacity);
+                }
+                return mCapacity;
+            }
+
+            // Backward shift: walk the rest of the run and move back every entry whose home slot is at or before the
+            // hole, the run then has no gap and lookups can keep stopping at the first empty slot.
+            void eraseAt(size_t tIndex)
+            {
+                const size_t mask = mCapacity - 1;
+
+                mSlots[tIndex].~value_type();
+
+                size_t hole = tIndex;
+                for (size_t next = (tIndex + 1) & mask; mControl[next] != cEmptyControl; next = (next + 1) & mask) {
+                    const size_t home = mHash(Policy::getKey(mSlots[next])) & mask;
+                    if (((next - home) & mask) >= ((next - hole) & mask)) {
+                        new (&mSlots[hole]) value_type(std::move(mSlots[next]));
+                        mSlots[next].~value_type();
+                        setControl(hole, mControl[next]);
+                        hole = next;
+                    }
+                }
+
+                setControl(hole, cEmptyControl);
+                mSize -= 1;
+            }
+
+            void rehash(size_t tCapacity)
+            {
+                assert(std::has_single_bit(tCapacity) && tCapacity >= cMinCapacity);
+
+                u8*          oldControl  = mControl;
+                value_type*  oldSlots    = mSlots;
+                const size_t oldCapacity = mCapacity;
+
+                allocate(tCapacity);
+
+                for (size_t index = 0; index < oldCapacity; ++index) {
+                    if (oldControl[index] == cEmptyControl)
+                        continue;
+
+                    const size_t hash     = mHash(Policy::getKey(oldSlots[index]));
+                    const size_t newIndex = findEmpty(hash);
+                    new (&mSlots[newIndex]) value_type(std::move(oldSlots[index]));
+                    oldSlots[index].~value_type();
+                    setControl(newIndex, getTag(hash));
+                }
+
+                if (oldCapacity > 0) {
+                    std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+                    delete[] oldControl;
+                }
+            }
+
+            // Replaces the arrays with empty ones, the caller owns the previous arrays.
+            void allocate(size_t tCapacity)
+            {
+                mControl  = new u8[getControlSize(tCapacity)];
+                mSlots    = std::allocator<value_type>().allocate(tCapacity);
+                mCapacity = tCapacity;
+                memset(mControl, cEmptyControl, getControlSize(tCapacity));
+            }
+
+            void release()
+            {
+                if (mCapacity == 0)
+                    return;
+
+                clear();
+                std::allocator<value_type>().deallocate(mSlots, mCapacity);
+                delete[] mControl;
+
+                mControl  = nullptr;
+                mSlots    = nullptr;
+                mCapacity = 0;
+            }
+
+            u8*         mControl{nullptr}; // mCapacity + cGroupWidth - 1 bytes, see setControl
+            value_type* mSlots{nullptr};
+            size_t      mCapacity{0};      // 0 or a power of two >= cMinCapacity
+            size_t      mSize{0};
+
+            [[no_unique_address]] Hash     mHash{};
+            [[no_unique_address]] KeyEqual mEqual{};
+        };
+    } // internal
+
+    template<class K, class V, class Hash = FlatHash<K>, class KeyEqual = std::equal_to<K>>
+    class FlatHashMap : public internal::FlatHashTable<internal::MapPolicy<K, V>, Hash, KeyEqual>
+    {
+        using Base = internal::FlatHashTable<internal::MapPolicy<K, V>, Hash, KeyEqual>;
+
+    public:
+        using mapped_type = V;
+        using typename Base::key_type;
+        using typename Base::value_type;
+        using typename Base::iterator;
+        using typename Base::const_iterator;
+
+        template<class... Xs>
+        std::pair<iterator, bool> try_emplace(const K& tKey, Xs&&... tArgs)
+        {
+            return this->emplaceWithKey(tKey, std::piecewise_construct, std::forward_as_tuple(tKey),
+                                        std::forward_as_tuple(std::forward<Xs>(tArgs)...));
+        }
+
+        template<class... Xs>
+        std::pair<iterator, bool> try_emplace(K&& tKey, Xs&&... tArgs)
+        {
+            return this->emplaceWithKey(tKey, std::piecewise_construct, std::forward_as_tuple(std::move(tKey)),
+                                        std::forward_as_tuple(std::forward<Xs>(tArgs)...));
+        }
+
+        std::pair<iterator, bool> insert(const value_type& tValue) { return this->emplaceWithKey(tValue.first, tValue); }
+
+        template<class X>
+        std::pair<iterator, bool> insert_or_assign(const K& tKey, X&& tValue)
+        {
+            auto result = try_emplace(tKey, std::forward<X>(tValue));
+            if (!result.second) {
+                result.first->second = std::forward<X>(tValue);
+            }
+            return result;
+        }
+
+        // Default constructs the value if the key is missing.
+        V& operator[](const K& tKey) { return try_emplace(tKey).first->second; }
+        V& operator[](K&& tKey)      { return try_emplace(std::move(tKey)).first->second; }
+    };
+
+    template<class K, class Hash = FlatHash<K>, class KeyEqual = std::equal_to<K>>
+    class FlatHashSet : public internal::FlatHashTable<internal::SetPolicy<K>, Hash, KeyEqual>
+    {
+        using Base = internal::FlatHashTable<internal::SetPolicy<K>, Hash, KeyEqual>;
+
+    public:
+        using typename Base::key_type;
+        using typename Base::value_type;
+
+        // Keys can't be changed in place, both iterators are const.
+        using iterator = typename Base::const_iterator;
+
+        iterator begin() const { return Base::begin(); }
+        iterator end() const   { return Base::end(); }
+
+        iterator find(const K& tKey) const { return Base::find(tKey); }
+
+        std::pair<iterator, bool> insert(const K& tKey) { return this->emplaceWithKey(tKey, tKey); }
+        std::pair<iterator, bool> insert(K&& tKey)      { return this->emplaceWithKey(tKey, std::move(tKey)); }
+    };
+} // util
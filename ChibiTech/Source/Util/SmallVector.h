@@ -0,0 +1,234 @@
+#pragma once
+
+#include <memory>
+#include <initializer_list>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <new>
+#include <cassert>
+
+#include "Types.h"
+
+//
+// util::SmallVector<T, N>
+//
+// Vector that keeps its first N elements inside the object and only allocates when it grows past them. Meant for
+// per-call scratch lists and per-object lists that are almost always short: the common case never touches the heap,
+// the rare long case still works instead of hitting a fixed cap.
+//
+// Once spilled the elements stay on the heap, clear keeps the allocation for reuse. Moving a vector whose elements
+// are inline moves them one by one, so pointers into a SmallVector don't survive a move either way.
+//
+// util::SmallVector<ID3D12CommandList*, 8> lists;
+// for (auto& commandList : commandLists) {
+//     lists.push_back(commandList->asHandle());
+// }
+// queue->ExecuteCommandLists((UINT)lists.size(), lists.data());
+//
+
+namespace util {
+    template<class T, size_t N>
+    class SmallVector
+    {
+        static_assert(N > 0, "Use std::vector for a vector without inline storage");
+
+    public:
+        using value_type     = T;
+        using iterator       = T*;
+        using const_iterator = const T*;
+
+        static constexpr size_t cInlineCapacity = N;
+
+        SmallVector() = default;
+        ~SmallVector()
+        {
+            clear();
+            release();
+        }
+
+        SmallVector(std::initializer_list<T> tValues)
+        {
+            reserve(tValues.size());
+            for (const T& value : tValues) {
+                push_back(value);
+            }
+        }
+
+        SmallVector(const SmallVector& tOther)
+        {
+            reserve(tOther.mSize);
+            std::uninitialized_copy(tOther.begin(), tOther.end(), mData);
+            mSize = tOther.mSize;
+        }
+
+        SmallVector(SmallVector&& tOther) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            moveFrom(tOther);
+        }
+
+        SmallVector& operator=(const SmallVector& tOther)
+        {
+            if (this != &tOther) {
+                clear();
+                reserve(tOther.mSize);
+                std::uninitialized_copy(tOther.begin(), tOther.end(), mData);
+                mSize = tOther.mSize;
+            }
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& tOther) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &tOther) {
+                clear();
+                release();
+                moveFrom(tOther);
+            }
+            return *this;
+        }
+
+        T& operator[](size_t tIndex)
+        {
+            assert(tIndex < mSize);
+            return mData[tIndex];
+        }
+
+        const T& operator[](size_t tIndex) const
+        {
+            assert(tIndex < mSize);
+            return mData[tIndex];
+        }
+
+        T&       front()       { assert(mSize > 0); return mData[0]; }
+        const T& front() const { assert(mSize > 0); return mData[0]; }
+        T&       back()        { assert(mSize > 0); return mData[mSize - 1]; }
+        const T& back() const  { assert(mSize > 0); return mData[mSize - 1]; }
+
+        T*       data()       { return mData; }
+        const T* data() const { return mData; }
+
+        iterator       begin()       { return mData; }
+        const_iterator begin() const { return mData; }
+        iterator       end()         { return mData + mSize; }
+        const_iterator end() const   { return mData + mSize; }
+
+        [[nodiscard]] size_t size() const     { return mSize; }
+        [[nodiscard]] size_t capacity() const { return mCapacity; }
+        [[nodiscard]] bool   empty() const    { return mSize == 0; }
+
+        // True while the elements live in the inline buffer.
+        [[nodiscard]] bool isInline() const { return mData == getInlineData(); }
+
+        template<class... Xs>
+        T& emplace_back(Xs&&... tValues)
+        {
+            if (mSize == mCapacity) {
+                // tValues may refer to an element of this vector, build the new element before the old ones move.
+                T value(std::forward<Xs>(tValues)...);
+                grow(mCapacity * 2);
+                return *new (mData + mSize++) T(std::move(value));
+            }
+            return *new (mData + mSize++) T(std::forward<Xs>(tValues)...);
+        }
+
+        void push_back(const T& tValue) { emplace_back(tValue); }
+        void push_back(T&& tValue)      { emplace_back(std::move(tValue)); }
+
+        void pop_back()
+        {
+            assert(mSize > 0);
+            mSize -= 1;
+            mData[mSize].~T();
+        }
+
+        // Removes the element at tPosition, later elements shift down to keep their order.
+        iterator erase(const_iterator tPosition)
+        {
+            assert(tPosition >= begin() && tPosition < end());
+            T* position = mData + (tPosition - mData);
+            std::move(position + 1, end(), position);
+            pop_back();
+            return position;
+        }
+
+        // Removes the element at tIndex by moving the last element into its place.
+        void eraseSwap(size_t tIndex)
+        {
+            assert(tIndex < mSize);
+            if (tIndex != mSize - 1) {
+                mData[tIndex] = std::move(mData[mSize - 1]);
+            }
+            pop_back();
+        }
+
+        void reserve(size_t tCapacity)
+        {
+            if (tCapacity > mCapacity) {
+                grow(tCapacity);
+            }
+        }
+
+        void resize(size_t tSize)
+        {
+            reserve(tSize);
+            while (mSize < tSize) {
+                new (mData + mSize++) T();
+            }
+            while (mSize > tSize) {
+                pop_back();
+            }
+        }
+
+        void clear()
+        {
+            std::destroy(begin(), end());
+            mSize = 0;
+        }
+
+    private:
+        T*       getInlineData()       { return reinterpret_cast<T*>(mInline); }
+        const T* getInlineData() const { return reinterpret_cast<const T*>(mInline); }
+
+        // Moves the elements to a heap block of at least tCapacity elements.
+        void grow(size_t tCapacity)
+        {
+            T* data = std::allocator<T>().allocate(tCapacity);
+            std::uninitialized_move(begin(), end(), data);
+            std::destroy(begin(), end());
+
+            release();
+            mData     = data;
+            mCapacity = tCapacity;
+        }
+
+        // Frees the heap block, if any. The elements must already be destroyed or moved out.
+        void release()
+        {
+            if (!isInline()) {
+                std::allocator<T>().deallocate(mData, mCapacity);
+                mData     = getInlineData();
+                mCapacity = N;
+            }
+        }
+
+        // Takes tOther's elements, this vector must be empty and inline. tOther is left empty.
+        void moveFrom(SmallVector& tOther)
+        {
+            if (tOther.isInline()) {
+                std::uninitialized_move(tOther.begin(), tOther.end(), mData);
+                mSize = tOther.mSize;
+                tOther.clear();
+            } else {
+                mData     = std::exchange(tOther.mData, tOther.getInlineData());
+                mSize     = std::exchange(tOther.mSize, 0);
+                mCapacity = std::exchange(tOther.mCapacity, N);
+            }
+        }
+
+        T*     mData{getInlineData()};
+        size_t mSize{0};
+        size_t mCapacity{N};
+        alignas(T) u8 mInline[N * sizeof(T)];
+    };
+} // util
@@ -1,16 +1,20 @@
 #pragma once
 
-#include <vector>
 #include <tuple>
 #include <type_traits>
 #include <cassert>
-#include <deque>
 #include <optional>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <span>
+#include <cstring>
 
 #include "Types.h"
-
-// TODO(enlynn):
-// - Iterator.
+#include "StorageHandle.h"
+#include "ChunkedArray.h"
+#include "AlignedAllocator.h"
+#include "Hash.h"
 
 //
 // struct Foo{};
@@ -26,7 +30,31 @@
 // const Foo& foo = pool.getReadable<Foo>(id);
 // const auto [foo, goo] = pool.getReadable<Foo, Goo>(id);
 //
-// for (const auto& foo : pool.iterator<Foo>()) {}
+// auto it = pool.getValueIterator<0, 2>();
+// while (auto row = it.next()) { auto& [foo, goo] = *row; }
+//
+// ct::forEachParallel<Foo, Goo>(workQueue, pool, [](Foo& foo, Goo& goo) {}); // Systems/StorageHelpers.h
+//
+// Change tracking is opt-in per column. Tracked rows are stamped with the current version whenever they are created or
+// handed out through getWritable, and reading the version starts a new one, so consumers only revisit rows written
+// since they last looked:
+//
+// pool.enableChangeTracking<Goo>();
+// u32 lastSeen = pool.getChangeVersion();
+// ...
+// pool.forEachChanged<Goo>(lastSeen, [](IdType id, Goo& goo) {});
+// lastSeen = pool.getChangeVersion();
+//
+// When every column is trivially copyable the whole storage can be saved as a binary snapshot and loaded back with one
+// memcpy per column chunk, see saveSnapshot/loadSnapshot (ct::saveSnapshotToFile/loadSnapshotFromFile for files).
+//
+// Columns grow in chunks of cRowsPerChunk rows, so growing never moves a row and references stay valid until the row
+// is destroyed. Chunks are 64-byte aligned and padded, see getColumnChunk/getPaddedColumnChunk. Freed rows are linked through the slot table and reused oldest first.
+//
+// Not thread-safe. Use util::ConcurrentSparseStorage (ConcurrentSparseStorage.h) when several threads create and destroy.
+//
+// Rows stay at their index for their whole lifetime, which leaves holes behind destroyed rows. Systems that walk
+// every live row each frame should prefer util::DenseStorage (DenseStorage.h), which keeps the columns packed.
 //
 
 namespace util {
@@ -35,7 +63,14 @@ namespace util {
     {
     public:
         using Self = SparseStorage<IndexBits, GenBits, UniqueId, Args...>;
-        using BackingStorage = std::tuple<std::vector<Args>...>;
+
+        // Rows per column chunk. A power of two so the row lookup is a shift and a mask.
+        static constexpr size_t cRowsPerChunk = 1024;
+
+        template <typename T>
+        using Column = ChunkedArray<T, cRowsPerChunk>;
+
+        using BackingStorage = std::tuple<Column<Args>...>;
 
     public:
         SparseStorage() = default;
@@ -46,102 +81,31 @@ namespace util {
         SparseStorage& operator=(Self&) = delete;
 
     private:
-        // ID Masks and Helper Functions
+        // ID Masks and Helper Functions, see StorageHandle.h
         //
-        static_assert(IndexBits + GenBits < 64, "Sparse Storage IDs are less than 64bits. Provided Index and Gen Bits are greater than 64.");
-
-        // Deduce the ID types and sizes
-        using GenerationType = std::conditional_t<GenBits <= 16,             std::conditional_t<GenBits <= 8,               u8, u16>, u32>;
-        using IndexType      = std::conditional_t<IndexBits <= 32,           std::conditional_t<IndexBits <= 16,           u16, u32>, u64>;
-        using MaskType       = std::conditional_t<IndexBits + GenBits <= 32, std::conditional_t<IndexBits + GenBits <= 16, u16, u32>, u64>;
-
-        union IdMask {
-            struct { MaskType mIdx:IndexBits; MaskType mGen:GenBits; };
-            MaskType mMask = 0;
-        };
-
-        // Define Invalid Masks for each ID variation.
-        static constexpr MaskType cInvalidIdMask = static_cast<MaskType>(-1);
-
-        static constexpr IndexType getIndex(IdMask tMask)
-        {
-            return tMask.mIdx;
-        }
-
-        static constexpr GenerationType getGeneration(IdMask tMask)
-        {
-            return tMask.mGen;
-        }
-
-        static constexpr IdMask setGeneration(IdMask tMask, GenerationType tGen)
-        {
-            tMask.mGen = tGen;
-            return tMask;
-        }
-
-        static constexpr IdMask setIndex(IdMask tMask, IndexType tIndex)
-        {
-            tMask.mIdx = tIndex;
-            return tMask;
-        }
-
-        static constexpr bool isLiveGeneration(GenerationType tGeneration)
-        {
-            // Odd-Numbered Generations are considered Live handles
-            return (tGeneration & 1) == 1;
-        }
-
-        static constexpr bool isFreeGeneration(GenerationType tGeneration)
-        {
-            // Even-Numbered Generations are considered Live handles
-            return (tGeneration & 1) == 0;
-        }
-
-        static constexpr GenerationType markGenerationAsFree(GenerationType tGeneration)
-        {
-            if (isLiveGeneration(tGeneration))
-            {
-                return tGeneration + 1;
-            }
-
-            assert(false && "Tried to mark generation as free, but was already free");
-            return tGeneration;
-        }
-
-        static constexpr GenerationType markGenerationAsAlive(GenerationType tGeneration)
-        {
-            if (isFreeGeneration(tGeneration))
-            {
-                return tGeneration + 1;
-            }
-
-            assert(false && "Tried to mark generation as alive, but was already alive");
-            return tGeneration;
-        }
+        using Layout         = internal::HandleLayout<IndexBits, GenBits>;
+        using GenerationType = typename Layout::GenerationType;
+        using IndexType      = typename Layout::IndexType;
+        using MaskType       = typename Layout::MaskType;
+        using IdMask         = typename Layout::IdMask;
+
+        static constexpr MaskType  cInvalidIdMask = Layout::cInvalidIdMask;
+        static constexpr IndexType cNullIndex     = Layout::cNullIndex;
+
+        static constexpr IndexType      getIndex(IdMask tMask)                            { return Layout::getIndex(tMask); }
+        static constexpr GenerationType getGeneration(IdMask tMask)                       { return Layout::getGeneration(tMask); }
+        static constexpr IdMask         setGeneration(IdMask tMask, GenerationType tGen)  { return Layout::setGeneration(tMask, tGen); }
+        static constexpr IdMask         setIndex(IdMask tMask, IndexType tIndex)          { return Layout::setIndex(tMask, tIndex); }
+        static constexpr bool           isLiveGeneration(GenerationType tGeneration)      { return Layout::isLiveGeneration(tGeneration); }
+        static constexpr bool           isFreeGeneration(GenerationType tGeneration)      { return Layout::isFreeGeneration(tGeneration); }
+        static constexpr GenerationType markGenerationAsFree(GenerationType tGeneration)  { return Layout::markGenerationAsFree(tGeneration); }
+        static constexpr GenerationType markGenerationAsAlive(GenerationType tGeneration) { return Layout::markGenerationAsAlive(tGeneration); }
 
     public:
-        // Creates a strongly typed ID based on the user provided "UniqueId"
-        //
-        template<class T>
-        struct IdTypeBase final
-        {
-            constexpr explicit IdTypeBase(const IdMask tId) : mId(tId) {}
-            constexpr explicit IdTypeBase() : mId(cInvalidIdMask) {}
-            constexpr explicit operator IdMask() const { return mId; }
-
-            constexpr IdMask get() const { return mId; }
-        private:
-            const IdMask mId;
-        };
-
-        using IdType = IdTypeBase<UniqueId>;
+        using IdType = StorageId<Layout, UniqueId>;
 
     private:
-        static constexpr size_t cMinFreeIndices = 10;
-
-        // Tuple of Vectors for each argument type
-        //
-        // NOTE(enlynn): GenerationType is loosely types. Let's say a user requests
+        // Tuple of chunked columns for each argument type
         //
         template <size_t cColIdx>
         using NthColType = typename std::tuple_element<cColIdx, BackingStorage>::type;
@@ -149,12 +113,40 @@ namespace util {
         template <size_t cColIdx>
         using ColType = typename NthColType<cColIdx>::value_type;
 
-        BackingStorage                   mStorage{};   // Data Storage for user defined types
-        std::vector<GenerationType>      mGenCycles{}; // Backing storage to determine if IDs are Valid, Alive, or Free
-        std::deque<IndexType>            mFreeList{};  // Free list of available indices.
+        // One slot per row. A live slot only holds its generation, a free slot also links to the next free slot, so the
+        // free list needs no storage of its own.
+        struct Slot
+        {
+            GenerationType mGeneration{1};
+            IndexType      mNextFree{cNullIndex};
+        };
+
+        BackingStorage                   mStorage{};             // Data Storage for user defined types
+        Column<Slot>                     mSlots{};               // Determines if IDs are Valid, Alive, or Free
+        IndexType                        mFreeHead{cNullIndex};  // Oldest free slot, reused first
+        IndexType                        mFreeTail{cNullIndex};  // Newest free slot
+        size_t                           mFreeCount{0};
 
-        // Determines if the storage system can resize. Is set to false, when "setStorageLimit()" is called.
+        // Determines if the storage system can resize. Is set to false, when "setMaxObjects()" is called.
         bool                             mIsResizable{true};
+        size_t                           mMaxObjects{0};
+
+        // Rows covered by one entry of ColumnChanges::mBlockVersions.
+        static constexpr size_t cChangeBlockRows = 64;
+
+        // Per-column change tracking, empty unless enabled.
+        struct ColumnChanges
+        {
+            bool              mEnabled{false};
+            Column<u32>       mRowVersions{};   // Version of the last write to each row, 0 if never written
+            std::vector<u32>  mBlockVersions{}; // Newest row version in each block, lets forEachChanged skip quiet blocks
+        };
+
+        std::array<ColumnChanges, sizeof...(Args)> mChanges{};
+
+        // Version tracked writes are stamped with. Bumped by getChangeVersion, not by writes, so it advances once per
+        // consumer read (about once per frame) however many rows are written.
+        mutable u32                                 mChangeVersion{1};
 
     public:
 
@@ -163,47 +155,55 @@ namespace util {
         {
             // Construct a valid id for the new object.
             IdMask mask{};
-            if (mFreeList.size() > cMinFreeIndices)
+            if (mFreeHead != cNullIndex)
             {
-                IndexType index = mFreeList.front();
-                mFreeList.pop_front();
+                // Take the oldest free slot. Reusing slots in the order they were freed keeps a slot's generation from
+                // cycling back to a value an old handle still holds for as long as possible.
+                const IndexType index = mFreeHead;
+                Slot& slot = mSlots[index];
+
+                mFreeHead = slot.mNextFree;
+                if (mFreeHead == cNullIndex)
+                    mFreeTail = cNullIndex;
+                mFreeCount -= 1;
 
                 // There is a logic error in create/destroy. Any index in the free list should have a corresponding
                 // generation that is free.
-                GenerationType& gen = mGenCycles[index];
-                assert(isFreeGeneration(gen));
+                assert(isFreeGeneration(slot.mGeneration));
 
                 // Let's mark the generation as "alive"
-                markGenerationAsAlive(gen);
-                assert(isLiveGeneration(gen));
+                slot.mGeneration = markGenerationAsAlive(slot.mGeneration);
+                slot.mNextFree   = cNullIndex;
+                assert(isLiveGeneration(slot.mGeneration));
 
-                setIndex(mask, index);
-                setGeneration(mask, gen);
+                mask = setIndex(mask, index);
+                mask = setGeneration(mask, slot.mGeneration);
 
                 // Extra error checking to make sure the index and generation has been set properly
                 assert(getIndex(mask) == index);
-                assert(getGeneration(mask) == gen);
+                assert(getGeneration(mask) == slot.mGeneration);
 
-                // Insert into the back of the storage.
+                // Overwrite the row left behind by the destroyed object.
                 this->replace(index, std::forward<Xs>(tValues)...);
+                markRowChanged(std::index_sequence_for<Args...>{}, index);
             }
             else
             {
-                const IndexType index = this->size();
+                const size_t index = this->size();
                 const GenerationType gen = 1;
 
-                if (mIsResizable)
+                if ((!mIsResizable && index >= mMaxObjects) || index >= cNullIndex)
                 {
                     // If we have set an upper bound, do not allow for anymore objects to be added to the storage.
-                    assert(index < this->cap());
+                    assert(false && "SparseStorage is full");
 
                     // NOTE(enlynn): should the caller be responsible for always checking to make sure a valid id is returned?
                     return IdType({ .mMask = cInvalidIdMask });
                 }
 
-                mGenCycles.push_back(gen);
+                mSlots.push_back(Slot{ .mGeneration = gen });
 
-                mask = setIndex(mask, index);
+                mask = setIndex(mask, static_cast<IndexType>(index));
                 mask = setGeneration(mask, gen);
 
                 // Extra error checking to make sure the index and generation has been set properly
@@ -212,6 +212,7 @@ namespace util {
 
                 // Insert into the back of the storage.
                 this->insert(std::forward<Xs>(tValues)...);
+                markRowChanged(std::index_sequence_for<Args...>{}, index);
             }
 
             return IdType(mask);
@@ -223,41 +224,84 @@ namespace util {
                 return;
 
             const IndexType index = getIndex(tId.get());
-            mGenCycles[index] = markGenerationAsFree(mGenCycles[index]);
+            Slot& slot = mSlots[index];
+            slot.mGeneration = markGenerationAsFree(slot.mGeneration);
+            slot.mNextFree   = cNullIndex;
 
             // NOTE(enlynn): Keep an eye on this usage pattern. This will require users destruct their types.
             // Or assumes data in storage is simple POD types.
             //destruct(index);
 
-            mFreeList.push_back(index);
+            // Append to the back of the free list.
+            if (mFreeTail != cNullIndex)
+                mSlots[mFreeTail].mNextFree = index;
+            else
+                mFreeHead = index;
+            mFreeTail = index;
+            mFreeCount += 1;
         }
 
         [[nodiscard]] size_t size() const {
-            return mGenCycles.size();
+            return mSlots.size();
         }
 
         [[nodiscard]] size_t cap() const {
-            return mGenCycles.capacity();
+            return mIsResizable ? mSlots.capacity() : mMaxObjects;
         }
 
         [[nodiscard]] bool empty() const {
-            return mGenCycles.empty();
+            return mSlots.empty();
         }
 
         [[nodiscard]] size_t getNumLiveObjects() const
         {
-            return size() - mFreeList.size();
+            return size() - mFreeCount;
+        }
+
+        // Rows below size() that have not been destroyed. Rows are never moved, so this is stable between creates.
+        [[nodiscard]] bool isRowLive(size_t tRow) const
+        {
+            return tRow < size() && isLiveGeneration(mSlots[tRow].mGeneration);
+        }
+
+        // Raw column access, one chunk of cRowsPerChunk rows at a time (the last chunk may be shorter). Chunks are
+        // 64-byte aligned. Spans include destroyed rows, check isRowLive(chunk * cRowsPerChunk + i) where it matters.
+        [[nodiscard]] size_t getChunkCount() const { return mSlots.getChunkCount(); }
+
+        template <typename X>
+        std::span<X> getColumnChunk(size_t tChunk) {
+            return std::get<Column<X>>(mStorage).getChunk(tChunk);
+        }
+
+        template <typename X>
+        std::span<const X> getColumnChunk(size_t tChunk) const {
+            return std::get<Column<X>>(mStorage).getChunk(tChunk);
+        }
+
+        // getColumnChunk rounded up to whole 64-byte lines, for SIMD loops without a scalar tail. Only for trivially
+        // copyable columns.
+        template <typename X>
+        std::span<X> getPaddedColumnChunk(size_t tChunk) {
+            return std::get<Column<X>>(mStorage).getPaddedChunk(tChunk);
+        }
+
+        template <typename X>
+        std::span<const X> getPaddedColumnChunk(size_t tChunk) const {
+            return std::get<Column<X>>(mStorage).getPaddedChunk(tChunk);
         }
 
         [[nodiscard]] bool isIdValid(IdType tId) const
         {
             // 1. Cannot be an invalid id mask
             // 2. Cannot be an index out of bounds
-            // 3. Must be a Live Id
+            // 3. Must be the current generation of a Live slot
             const IdMask mask = tId.get();
             const size_t index = getIndex(mask);
+            if (mask.mMask == cInvalidIdMask || index >= this->size())
+                return false;
 
-            return (mask.mMask != cInvalidIdMask) && (index < this->size()) && (isLiveGeneration(mGenCycles[index]));
+            const GenerationType gen = mSlots[index].mGeneration;
+            return isLiveGeneration(gen) && gen == getGeneration(mask);
         }
 
         template <size_t... I>
@@ -279,7 +323,9 @@ namespace util {
             // handle when an ID is no longer valid.
             assert(isIdValid(tId));
 
-            return getRowImpl(std::integer_sequence<size_t, I...>{}, static_cast<size_t>(getIndex(tId.get())));
+            const size_t index = getIndex(tId.get());
+            markRowChanged(std::integer_sequence<size_t, I...>{}, index);
+            return getRowImpl(std::integer_sequence<size_t, I...>{}, index);
         }
 
         template <typename... Xs>
@@ -290,6 +336,7 @@ namespace util {
             assert(isIdValid(tId));
 
             const size_t index = getIndex(tId.get());
+            markRowChanged(std::integer_sequence<size_t, getColumnIndex<Xs>()...>{}, index);
             return std::move(getWritableImpl<Xs...>(index));
         }
 
@@ -308,7 +355,10 @@ namespace util {
             // If this is false, then we've already set this value.
             assert(mIsResizable);
             mIsResizable = false;
+            mMaxObjects  = size;
 
+            // Allocate every chunk up front, so a bounded storage never allocates after setup.
+            mSlots.reserve(size);
             return reserveImpl(std::index_sequence_for<Args...>{}, size);
         }
 
@@ -368,14 +418,14 @@ namespace util {
 
         template <typename T, size_t... I>
         void insertImpl(std::integer_sequence<size_t, I...>, T t) {
-            // Gets the column vector [std::vec<Type0>, std::vec<Type1>, ...]
+            // Gets the column [Column<Type0>, Column<Type1>, ...]
             // Push the value at (tIndex) with t (the element-list tuple - [Type0 value0, Type1 value1, ...])
             ((getColumn<I>().push_back(std::get<I>(t))), ...);
         }
 
         template <typename T, size_t... I>
         void replaceImpl(const size_t tIndex, std::integer_sequence<size_t, I...>, T t) {
-            // Gets the column vector [std::vec<Type0>, std::vec<Type1>, ...]
+            // Gets the column [Column<Type0>, Column<Type1>, ...]
             // Sets the value at (tIndex) with t (the element-list tuple - [Type0 value0, Type1 value1, ...])
             ((getColumn<I>()[tIndex] = (std::get<I>(t))), ...);
         }
@@ -395,11 +445,6 @@ namespace util {
             ((getColumn<I>().clear()), ...);
         }
 
-        template <size_t... I, typename T>
-        void resizeImpl(std::integer_sequence<size_t, I...>, T&& data, size_t new_size) {
-            ((std::get<I>(data).resize(new_size)), ...);
-        }
-
         template <size_t... I>
         void reserveImpl(std::integer_sequence<size_t, I...>, size_t res_size) {
             ((getColumn<I>().reserve(res_size)), ...);
@@ -407,38 +452,335 @@ namespace util {
 
         template <typename... Xs>
         auto getWritableImpl(const size_t tRow) {
-            return std::tie(std::get<std::vector<Xs>>(mStorage)[tRow]...);
+            return std::tie(std::get<Column<Xs>>(mStorage)[tRow]...);
         }
 
         template <typename... Xs>
         auto getReadableImpl(const size_t tRow) const {
-            return std::tie(std::get<std::vector<Xs>>(mStorage)[tRow]...);
+            return std::tie(std::get<Column<Xs>>(mStorage)[tRow]...);
+        }
+
+    public: // Snapshots
+        static constexpr bool cIsSnapshotable = (std::is_trivially_copyable_v<Args> && ...);
+
+        // Bump whenever the snapshot layout changes. Old snapshots are rejected rather than misread.
+        static constexpr u32 cSnapshotVersion = 2;
+        static constexpr u32 cSnapshotMagic   = 0x53535443; // "CTSS"
+
+        // A snapshot is this header, the slot generations, the slot free links, then each column in declaration order.
+        // All raw bytes in the native byte order, so snapshots are not portable between platforms with different
+        // endianness. The slot table is written field by field so the output has no padding, the same storage always
+        // saves the same bytes. Columns are copied as they are, padding inside a column type included.
+        struct SnapshotHeader
+        {
+            u32 mMagic{cSnapshotMagic};
+            u32 mVersion{cSnapshotVersion};
+            u64 mLayoutHash{0}; // Handle bits plus the size and alignment of every column, see getSnapshotLayoutHash
+            u64 mRowCount{0};
+            u64 mFreeCount{0};
+            u64 mFreeHead{0};
+            u64 mFreeTail{0};
+        };
+
+        [[nodiscard]] size_t getSnapshotSize() const
+        {
+            return sizeof(SnapshotHeader) + size() * (cSnapshotSlotSize + (sizeof(Args) + ...));
+        }
+
+        // Writes the snapshot into tOut, which must hold at least getSnapshotSize() bytes.
+        bool saveSnapshot(std::span<u8> tOut) const
+        {
+            static_assert(cIsSnapshotable, "Snapshots require every column to be trivially copyable.");
+            if (tOut.size() < getSnapshotSize())
+                return false;
+
+            SnapshotHeader header{};
+            header.mLayoutHash = getSnapshotLayoutHash();
+            header.mRowCount   = size();
+            header.mFreeCount  = mFreeCount;
+            header.mFreeHead   = mFreeHead;
+            header.mFreeTail   = mFreeTail;
+            memcpy(tOut.data(), &header, sizeof(header));
+
+            u8* generations = tOut.data() + sizeof(header);
+            u8* nextFrees   = generations + size() * sizeof(GenerationType);
+            for (size_t row = 0; row < size(); ++row) {
+                memcpy(generations + row * sizeof(GenerationType), &mSlots[row].mGeneration, sizeof(GenerationType));
+                memcpy(nextFrees + row * sizeof(IndexType), &mSlots[row].mNextFree, sizeof(IndexType));
+            }
+
+            u8* cursor = nextFrees + size() * sizeof(IndexType);
+
+            std::apply([&](const auto&... tColumns) {
+                ((tColumns.copyBytesTo(cursor), cursor += tColumns.size() * sizeof(typename std::decay_t<decltype(tColumns)>::value_type)), ...);
+            }, mStorage);
+
+            return true;
+        }
+
+        // Replaces the contents of the storage with a snapshot. Handles saved with the snapshot are valid again
+        // afterwards. Fails without touching the storage if the snapshot is truncated, from another layout, too big
+        // for a bounded storage, or has a free list that doesn't match its slots.
+        bool loadSnapshot(std::span<const u8> tIn)
+        {
+            static_assert(cIsSnapshotable, "Snapshots require every column to be trivially copyable.");
+            if (tIn.size() < sizeof(SnapshotHeader))
+                return false;
+
+            SnapshotHeader header{};
+            memcpy(&header, tIn.data(), sizeof(header));
+
+            if (header.mMagic != cSnapshotMagic || header.mVersion != cSnapshotVersion || header.mLayoutHash != getSnapshotLayoutHash())
+                return false;
+
+            const size_t rowCount = header.mRowCount;
+            if (rowCount >= cNullIndex || (!mIsResizable && rowCount > mMaxObjects) || header.mFreeCount > rowCount)
+                return false;
+            // Divide rather than multiply, a huge row count must not wrap the size it implies.
+            constexpr size_t cRowSize = cSnapshotSlotSize + (sizeof(Args) + ...);
+            if (rowCount > (tIn.size() - sizeof(SnapshotHeader)) / cRowSize)
+                return false;
+
+            const u8* generations = tIn.data() + sizeof(header);
+            const u8* nextFrees   = generations + rowCount * sizeof(GenerationType);
+            const auto readSlot = [&](size_t tRow) {
+                Slot slot{};
+                memcpy(&slot.mGeneration, generations + tRow * sizeof(GenerationType), sizeof(GenerationType));
+                memcpy(&slot.mNextFree, nextFrees + tRow * sizeof(IndexType), sizeof(IndexType));
+                return slot;
+            };
+
+            if (!isSnapshotFreeListValid(header, readSlot))
+                return false;
+
+            mSlots.resize(rowCount);
+            for (size_t row = 0; row < rowCount; ++row) {
+                mSlots[row] = readSlot(row);
+            }
+
+            const u8* cursor = nextFrees + rowCount * sizeof(IndexType);
+
+            std::apply([&](auto&... tColumns) {
+                ((tColumns.assignBytes(cursor, rowCount), cursor += rowCount * sizeof(typename std::decay_t<decltype(tColumns)>::value_type)), ...);
+            }, mStorage);
+
+            mFreeCount = header.mFreeCount;
+            mFreeHead  = static_cast<IndexType>(header.mFreeHead);
+            mFreeTail  = static_cast<IndexType>(header.mFreeTail);
+
+            // Every row is new as far as change tracking consumers are concerned.
+            const u32 version = mChangeVersion;
+            for (ColumnChanges& changes : mChanges) {
+                if (!changes.mEnabled)
+                    continue;
+
+                changes.mRowVersions.clear();
+                changes.mBlockVersions.clear();
+                stampRows(changes, 0, rowCount, version);
+            }
+
+            return true;
+        }
+
+    private:
+        static constexpr size_t cSnapshotSlotSize = sizeof(GenerationType) + sizeof(IndexType);
+
+        // A corrupted free list would let create hand out a live row a second time, so it is checked in full before
+        // anything is loaded: it has to visit exactly the free slots, each one once, and end at the saved tail.
+        template <typename ReadSlot>
+        static bool isSnapshotFreeListValid(const SnapshotHeader& tHeader, const ReadSlot& tReadSlot)
+        {
+            const size_t rowCount = tHeader.mRowCount;
+
+            size_t freeSlots = 0;
+            for (size_t row = 0; row < rowCount; ++row) {
+                const Slot slot = tReadSlot(row);
+                if (isLiveGeneration(slot.mGeneration) && slot.mNextFree != cNullIndex)
+                    return false;
+                freeSlots += isLiveGeneration(slot.mGeneration) ? 0 : 1;
+            }
+            if (freeSlots != tHeader.mFreeCount)
+                return false;
+
+            // A walk of mFreeCount steps over free slots that then ends on null can't have repeated a slot, so it
+            // visited every free slot exactly once.
+            u64 last  = cNullIndex;
+            u64 index = tHeader.mFreeHead;
+            for (size_t step = 0; step < tHeader.mFreeCount; ++step) {
+                if (index >= rowCount)
+                    return false;
+
+                const Slot slot = tReadSlot(index);
+                if (isLiveGeneration(slot.mGeneration))
+                    return false;
+
+                last  = index;
+                index = slot.mNextFree;
+            }
+
+            return index == cNullIndex && last == tHeader.mFreeTail;
+        }
+
+        static u64 getSnapshotLayoutHash()
+        {
+            u64 hash = 0;
+            hash_combine_size_t(hash, u64(IndexBits));
+            hash_combine_size_t(hash, u64(GenBits));
+            hash_combine_size_t(hash, u64(sizeof(GenerationType)));
+            hash_combine_size_t(hash, u64(sizeof(IndexType)));
+            ((hash_combine_size_t(hash, u64(sizeof(Args))), hash_combine_size_t(hash, u64(alignof(Args)))), ...);
+            return hash;
+        }
+
+    public: // Change tracking
+        // Starts tracking writes to the given columns. Rows that already exist count as changed.
+        template <typename... Xs>
+        void enableChangeTracking()
+        {
+            ((enableColumnChanges(mChanges[getColumnIndex<Xs>()], mChangeVersion)), ...);
+        }
+
+        template <typename X>
+        [[nodiscard]] bool isChangeTrackingEnabled() const
+        {
+            return mChanges[getColumnIndex<X>()].mEnabled;
+        }
+
+        // Version of the newest tracked write. Consumers remember it and pass it to forEachChanged next time. Every call
+        // closes the current version, later writes are stamped with the next one.
+        //
+        // Versions are compared by signed difference, so the counter may wrap. A consumer must not fall more than 2^31
+        // reads behind, and rows left unwritten for that long stop being reported as changed to very old versions.
+        [[nodiscard]] u32 getChangeVersion() const { return mChangeVersion++; }
+
+        // Marks rows written outside of getWritable, e.g. through forEachInRange, which does not mark anything.
+        template <typename... Xs>
+        void markChanged(const IdType tId)
+        {
+            assert(isIdValid(tId));
+            markRowChanged(std::integer_sequence<size_t, getColumnIndex<Xs>()...>{}, getIndex(tId.get()));
+        }
+
+        // Calls tFunc(X&), or tFunc(IdType, X&) if it accepts a handle, for every live row whose X was written after
+        // tSinceVersion. Rows are visited in index order. Destroyed rows are not reported.
+        template <typename X, typename Func>
+        void forEachChanged(const u32 tSinceVersion, Func&& tFunc)
+        {
+            constexpr bool cWithId = std::is_invocable_v<Func&, IdType, X&>;
+
+            forEachChangedRow<X>(tSinceVersion, [&](size_t tRow) {
+                if constexpr (cWithId) {
+                    const IdMask mask = setGeneration(setIndex(IdMask{}, static_cast<IndexType>(tRow)), mSlots[tRow].mGeneration);
+                    tFunc(IdType(mask), std::get<Column<X>>(mStorage)[tRow]);
+                } else {
+                    tFunc(std::get<Column<X>>(mStorage)[tRow]);
+                }
+            });
+        }
+
+        // Calls tFunc(tBegin, tEnd) for each maximal run of consecutive rows [tBegin, tEnd) forEachChanged would visit.
+        // Meant for uploading the dirty parts of a column, e.g. to a GPU instance buffer indexed by row.
+        template <typename X, typename Func>
+        void forEachChangedRange(const u32 tSinceVersion, Func&& tFunc)
+        {
+            size_t begin = 0;
+            size_t end   = 0;
+
+            forEachChangedRow<X>(tSinceVersion, [&](size_t tRow) {
+                if (tRow != end) {
+                    if (end > begin)
+                        tFunc(begin, end);
+                    begin = tRow;
+                }
+                end = tRow + 1;
+            });
+
+            if (end > begin)
+                tFunc(begin, end);
+        }
+
+    private:
+        template <typename X>
+        static constexpr size_t getColumnIndex()
+        {
+            constexpr bool cMatches[] = { std::is_same_v<X, Args>... };
+            static_assert((size_t(std::is_same_v<X, Args>) + ...) == 1, "Column types must be unique to be looked up by type.");
+
+            size_t index = 0;
+            while (!cMatches[index]) {
+                index += 1;
+            }
+            return index;
+        }
+
+        void enableColumnChanges(ColumnChanges& tChanges, const u32 tVersion)
+        {
+            if (tChanges.mEnabled)
+                return;
+
+            tChanges.mEnabled = true;
+            stampRows(tChanges, 0, size(), tVersion);
+        }
+
+        // Stamps rows [tBegin, tEnd) with tVersion, growing the version arrays to the storage size as needed.
+        void stampRows(ColumnChanges& tChanges, const size_t tBegin, const size_t tEnd, const u32 tVersion)
+        {
+            if (tChanges.mRowVersions.size() < size()) {
+                tChanges.mRowVersions.resize(size());
+                tChanges.mBlockVersions.resize((size() + cChangeBlockRows - 1) / cChangeBlockRows, 0);
+            }
+
+            for (size_t row = tBegin; row < tEnd; ++row) {
+                tChanges.mRowVersions[row] = tVersion;
+                tChanges.mBlockVersions[row / cChangeBlockRows] = tVersion;
+            }
+        }
+
+        template <size_t... I>
+        void markRowChanged(std::integer_sequence<size_t, I...>, const size_t tRow)
+        {
+            ((mChanges[I].mEnabled ? stampRows(mChanges[I], tRow, tRow + 1, mChangeVersion) : void()), ...);
+        }
+
+        // True if tVersion was stamped after tSinceVersion, correct across a wrap of the u32 counter.
+        static constexpr bool isNewerVersion(const u32 tVersion, const u32 tSinceVersion)
+        {
+            return s32(tVersion - tSinceVersion) > 0;
+        }
+
+        template <typename X, typename Func>
+        void forEachChangedRow(const u32 tSinceVersion, Func&& tFunc)
+        {
+            const ColumnChanges& changes = mChanges[getColumnIndex<X>()];
+            assert(changes.mEnabled && "Change tracking is not enabled for this column");
+
+            for (size_t block = 0; block < changes.mBlockVersions.size(); ++block) {
+                if (!isNewerVersion(changes.mBlockVersions[block], tSinceVersion))
+                    continue;
+
+                const size_t first = block * cChangeBlockRows;
+                const size_t last  = std::min(first + cChangeBlockRows, changes.mRowVersions.size());
+                for (size_t row = first; row < last; ++row) {
+                    if (isNewerVersion(changes.mRowVersions[row], tSinceVersion) && isLiveGeneration(mSlots[row].mGeneration))
+                        tFunc(row);
+                }
+            }
         }
 
     public: // Iterators
         class LiveIndicesIterator
         {
         public:
-            using ValueType = std::vector<GenerationType>;
-            using ValuePtr = ValueType*;
-
-            explicit LiveIndicesIterator(ValuePtr tLiveIndices) : mGenerations(tLiveIndices) {}
+            explicit LiveIndicesIterator(const Self* tStorage) : mStorage(tStorage) {}
 
             std::optional<size_t> next() {
-                const size_t maxIndex = mGenerations->size();
-                while(!mEnded && (mNextIndex < maxIndex)) {
+                const size_t maxIndex = mStorage->size();
+                while (mNextIndex < maxIndex) {
                     const size_t index = mNextIndex;
-
-                    // increment the next index if there are any remaining indices
-                    if (index < maxIndex) {
-                        mNextIndex += 1;
-                    }
-                    else {
-                        mEnded = true;
-                    }
+                    mNextIndex += 1;
 
                     // if the current index is live, then return it, else continue
-                    if (isLiveGeneration(mGenerations->at(index))) {
+                    if (isLiveGeneration(mStorage->mSlots[index].mGeneration)) {
                         return index;
                     }
                 }
@@ -447,27 +789,23 @@ namespace util {
                 return std::nullopt;
             }
 
-            ValuePtr  mGenerations{};
-            IndexType mNextIndex{0};
-            bool      mEnded{false};
+            const Self* mStorage{};
+            size_t      mNextIndex{0};
         };
 
         class LiveHandleIterator
         {
         public:
-            using ValueType = std::vector<GenerationType>;
-            using ValuePtr = ValueType*;
-
-            explicit LiveHandleIterator(ValuePtr tLiveIndices) : mLiveIndices(LiveIndicesIterator(tLiveIndices)) {}
+            explicit LiveHandleIterator(const Self* tStorage) : mLiveIndices(LiveIndicesIterator(tStorage)) {}
 
             std::optional<IdType> next()
             {
                 auto optIndex = mLiveIndices.next();
                 if (optIndex.has_value()) {
-                    GenerationType gen = mLiveIndices.mGenerations->at(optIndex.value());
+                    GenerationType gen = mLiveIndices.mStorage->mSlots[optIndex.value()].mGeneration;
 
                     IdMask mask{};
-                    mask = setIndex(mask, optIndex.value());
+                    mask = setIndex(mask, static_cast<IndexType>(optIndex.value()));
                     mask = setGeneration(mask, gen);
                     return IdType(mask);
                 }
@@ -478,34 +816,69 @@ namespace util {
             LiveIndicesIterator mLiveIndices;
         };
 
+        // Returns a tuple of references to the selected columns for each live row, std::nullopt once every row is visited.
         template<size_t... ColumnIndices>
         class ColumnIterator
         {
         public:
-            explicit ColumnIterator(Self* tStorage) : mStorage(tStorage), mLiveHandles(LiveHandleIterator(&tStorage->mGenCycles)) {}
+            explicit ColumnIterator(Self* tStorage) : mStorage(tStorage), mLiveIndices(LiveIndicesIterator(tStorage)) {}
 
             auto next()
             {
-                auto id = mLiveHandles.next();
-                if (id.has_value())
+                using Columns = std::integer_sequence<size_t, ColumnIndices...>;
+                using RowType = decltype(mStorage->getRowImpl(Columns{}, size_t{0}));
+
+                auto index = mLiveIndices.next();
+                if (index.has_value())
                 {
-                    return mStorage->getWritable<ColumnIndices...>(id.value());
+                    return std::optional<RowType>(mStorage->getRowImpl(Columns{}, index.value()));
                 }
-                return std::make_tuple();
+                return std::optional<RowType>{};
             }
 
         private:
-            Self*              mStorage;
-            LiveHandleIterator mLiveHandles;
+            Self*               mStorage;
+            LiveIndicesIterator mLiveIndices;
         };
 
-        LiveHandleIterator getHandleIterator() {
-            return LiveHandleIterator(mGenCycles);
+        LiveHandleIterator getHandleIterator() const {
+            return LiveHandleIterator(this);
         }
 
         template<size_t... ColumnIndices>
         ColumnIterator<ColumnIndices...> getValueIterator() {
-            return ColumnIterator(mGenCycles);
+            return ColumnIterator<ColumnIndices...>(this);
+        }
+
+    public: // Parallel iteration, see ct::forEachParallel/reduceParallel in Systems/StorageHelpers.h
+        // Minimum rows handed to a worker at a time.
+        static constexpr size_t cParallelBlockRows = 1024;
+
+        // Rows per parallel block when visiting columns Xs: blocks are rounded up to whole cache lines of the slot
+        // table and every column touched, so two workers never write to the same line.
+        template <typename... Xs>
+        static constexpr size_t getParallelBlockRows() {
+            return getCacheLineBlockSize<Slot, Xs...>(cParallelBlockRows);
+        }
+
+        // Calls tFunc(Xs&...) for every live row in [tBegin, tEnd), or tFunc(IdType, Xs&...) if it accepts a handle.
+        // Rows are visited in order. tFunc must not create or destroy. Disjoint ranges may run on different threads.
+        template <typename... Xs, typename Func>
+        void forEachInRange(size_t tBegin, size_t tEnd, Func&& tFunc)
+        {
+            constexpr bool cWithId = std::is_invocable_v<Func&, IdType, Xs&...>;
+
+            for (size_t row = tBegin; row < tEnd; ++row) {
+                const GenerationType gen = mSlots[row].mGeneration;
+                if (!isLiveGeneration(gen))
+                    continue;
+
+                if constexpr (cWithId) {
+                    tFunc(IdType(setGeneration(setIndex(IdMask{}, static_cast<IndexType>(row)), gen)), std::get<Column<Xs>>(mStorage)[row]...);
+                } else {
+                    tFunc(std::get<Column<Xs>>(mStorage)[row]...);
+                }
+            }
         }
     };
 } // util
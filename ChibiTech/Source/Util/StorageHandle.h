@@ -0,0 +1,122 @@
+#pragma once
+
+#include <type_traits>
+#include <cassert>
+
+#include "Types.h"
+
+//
+// Generational handles shared by util::SparseStorage and util::DenseStorage.
+//
+// A handle packs an index into the storage's slot table and the generation of that slot. Odd generations are live,
+// even generations are free, so destroying a slot bumps its generation and every outstanding handle to it goes stale.
+//
+
+namespace util {
+    namespace internal {
+        template<u8 IndexBits, u8 GenBits>
+        struct HandleLayout
+        {
+            static_assert(IndexBits + GenBits < 64, "Sparse Storage IDs are less than 64bits. Provided Index and Gen Bits are greater than 64.");
+
+            // Deduce the ID types and sizes
+            using GenerationType = std::conditional_t<GenBits <= 16,             std::conditional_t<GenBits <= 8,               u8, u16>, u32>;
+            using IndexType      = std::conditional_t<IndexBits <= 32,           std::conditional_t<IndexBits <= 16,           u16, u32>, u64>;
+            using MaskType       = std::conditional_t<IndexBits + GenBits <= 32, std::conditional_t<IndexBits + GenBits <= 16, u16, u32>, u64>;
+
+            union IdMask {
+                struct { MaskType mIdx:IndexBits; MaskType mGen:GenBits; };
+                MaskType mMask = 0;
+            };
+
+            // Define Invalid Masks for each ID variation.
+            static constexpr MaskType cInvalidIdMask = static_cast<MaskType>(-1);
+
+            // The all-ones index is never handed out, it is what an invalid mask decodes to. Storages use it as their
+            // null index.
+            static constexpr IndexType      cNullIndex     = static_cast<IndexType>((u64(1) << IndexBits) - 1);
+            static constexpr GenerationType cGenerationMask = static_cast<GenerationType>((u64(1) << GenBits) - 1);
+
+            static constexpr IndexType getIndex(IdMask tMask)
+            {
+                return tMask.mIdx;
+            }
+
+            static constexpr GenerationType getGeneration(IdMask tMask)
+            {
+                return tMask.mGen;
+            }
+
+            static constexpr IdMask setGeneration(IdMask tMask, GenerationType tGen)
+            {
+                tMask.mGen = tGen;
+                return tMask;
+            }
+
+            static constexpr IdMask setIndex(IdMask tMask, IndexType tIndex)
+            {
+                tMask.mIdx = tIndex;
+                return tMask;
+            }
+
+            static constexpr IdMask makeMask(IndexType tIndex, GenerationType tGen)
+            {
+                return setGeneration(setIndex(IdMask{}, tIndex), tGen);
+            }
+
+            static constexpr bool isLiveGeneration(GenerationType tGeneration)
+            {
+                // Odd-Numbered Generations are considered Live handles
+                return (tGeneration & 1) == 1;
+            }
+
+            static constexpr bool isFreeGeneration(GenerationType tGeneration)
+            {
+                // Even-Numbered Generations are considered Free handles
+                return (tGeneration & 1) == 0;
+            }
+
+            // Generations wrap within GenBits, the last free generation is followed by 0 again.
+            static constexpr GenerationType markGenerationAsFree(GenerationType tGeneration)
+            {
+                if (isLiveGeneration(tGeneration))
+                {
+                    return (tGeneration + 1) & cGenerationMask;
+                }
+
+                assert(false && "Tried to mark generation as free, but was already free");
+                return tGeneration;
+            }
+
+            static constexpr GenerationType markGenerationAsAlive(GenerationType tGeneration)
+            {
+                if (isFreeGeneration(tGeneration))
+                {
+                    return tGeneration + 1;
+                }
+
+                assert(false && "Tried to mark generation as alive, but was already alive");
+                return tGeneration;
+            }
+        };
+    }
+
+    // Creates a strongly typed ID based on the user provided "UniqueId"
+    //
+    template<class Layout, class UniqueId>
+    struct StorageId final
+    {
+        using IdMask = typename Layout::IdMask;
+
+        constexpr explicit StorageId(const IdMask tId) : mId(tId) {}
+        constexpr explicit StorageId() : mId({ .mMask = Layout::cInvalidIdMask }) {}
+        constexpr explicit operator IdMask() const { return mId; }
+
+        constexpr IdMask get() const { return mId; }
+
+        constexpr bool operator==(const StorageId& tOther) const { return mId.mMask == tOther.mId.mMask; }
+
+    private:
+        IdMask mId;
+    };
+} // util
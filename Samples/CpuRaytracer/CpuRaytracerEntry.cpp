@@ -6,6 +6,7 @@
 #include <Platform/Timer.h>
 
 #include <Systems/ResourceSystem.h>
+#include <Systems/WorkQueue.h>
 
 #include <Math/Math.h>
 
@@ -20,7 +21,6 @@
 #include "Gpu/GpuUtils.h"
 
 #include "Raytracer.h"
-#include "WorkQueue.h"
 
 enum class TexRootParamters
 {
@@ -29,7 +29,8 @@ enum class TexRootParamters
 
 class RaytracerApp : public ct::Game {
 public:
-    RaytracerApp() : mTaskPool(WorkQueue::getSystemThreadCount() / 2) {}
+    // One pinned worker per physical core. SMT siblings only add contention for the raytracer's FP units.
+    RaytracerApp() : mTaskPool({ .mNumThreads = ct::WorkQueue::getPhysicalCoreCount(), .mPinThreads = true, .mSkipSmtSiblings = true }) {}
 
     [[nodiscard]] ct::GameInfo getGameInfo() const override;
 
@@ -44,7 +45,7 @@ public:
     static constexpr float  cUploadTimerMS       = 1000.0f;
 
     std::filesystem::path mOutputPath{};
-    WorkQueue             mTaskPool;
+    ct::WorkQueue         mTaskPool;
 
     size_t                mRayImageWidth{0};
     size_t                mRayImageHeight{0};
@@ -149,8 +150,8 @@ bool RaytracerApp::onInit(ct::Engine& tEngine) {
             .mState              = mRaytracer.get(),
         };
 
-        auto func = static_cast<WorkQueue::TaskFunc>(raytracerWork);
-        mTaskPool.addTask(work, func);
+        // The image is rendered once up front, so it is background work rather than per-frame work.
+        mTaskPool.addTask([work] { raytracerWork(work); }, ct::TaskPriority::Background);
     }
 
     auto timeElapsed = queueTimer.getMilisecondsElapsed();